@@ -2,10 +2,14 @@
 #define CLP_DICTIONARYREADER_HPP
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <string_utils/string_utils.hpp>
+#include <string_utils/WildcardPattern.hpp>
 
 #include "dictionary_utils.hpp"
 #include "DictionaryEntry.hpp"
@@ -79,7 +83,9 @@ public:
      */
     std::string const& get_value(DictionaryIdType id) const;
     /**
-     * Gets the entry exactly matching the given search string
+     * Gets the entry exactly matching the given search string. The first lookup builds an index of
+     * the entries' values (or their case-folded values, when ignoring case), so this method isn't
+     * thread-safe.
      * @param search_string
      * @param ignore_case
      * @return nullptr if an exact match is not found, the entry otherwise
@@ -97,6 +103,16 @@ public:
             bool ignore_case,
             std::unordered_set<EntryType const*>& entries
     ) const;
+    /**
+     * Gets the entries that match each of the given wildcard patterns, in a single pass over the
+     * dictionary
+     * @param patterns
+     * @param entries Sets in which to store found entries, one per pattern
+     */
+    void get_entries_matching_wildcard_patterns(
+            std::vector<string_utils::WildcardPattern> const& patterns,
+            std::vector<std::unordered_set<EntryType const*>>& entries
+    ) const;
 
 protected:
     // Methods
@@ -105,6 +121,11 @@ protected:
      */
     void read_segment_ids();
 
+    /**
+     * Clears the indices used for lookups by value, so that they're rebuilt on the next lookup
+     */
+    void clear_value_indices();
+
     // Variables
     bool m_is_open;
     FileReader m_dictionary_file_reader;
@@ -120,6 +141,12 @@ protected:
 #endif
     size_t m_num_segments_read_from_index;
     std::vector<EntryType> m_entries;
+    // Indices from each entry's value (and its uppercase value) to the ID of the first entry with
+    // that value. They're built lazily since most readers never look up entries by value.
+    // NOTE: The value index refers to the values stored in m_entries, so it's cleared whenever
+    // m_entries changes.
+    mutable std::unordered_map<std::string_view, DictionaryIdType> m_value_to_id;
+    mutable std::unordered_map<std::string, DictionaryIdType> m_uppercase_value_to_id;
 };
 
 template <typename DictionaryIdType, typename EntryType>
@@ -158,6 +185,7 @@ void DictionaryReader<DictionaryIdType, EntryType>::close() {
     m_dictionary_file_reader.close();
 
     m_num_segments_read_from_index = 0;
+    clear_value_indices();
     m_entries.clear();
 
     m_is_open = false;
@@ -179,6 +207,9 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_new_entries() {
 
     // Read new dictionary entries
     if (num_dictionary_entries > m_entries.size()) {
+        // Resizing may move the entries' values
+        clear_value_indices();
+
         auto prev_num_dictionary_entries = m_entries.size();
         m_entries.resize(num_dictionary_entries);
 
@@ -233,21 +264,27 @@ EntryType const* DictionaryReader<DictionaryIdType, EntryType>::get_entry_matchi
         bool ignore_case
 ) const {
     if (false == ignore_case) {
-        for (auto const& entry : m_entries) {
-            if (entry.get_value() == search_string) {
-                return &entry;
-            }
-        }
-    } else {
-        auto const& search_string_uppercase = boost::algorithm::to_upper_copy(search_string);
-        for (auto const& entry : m_entries) {
-            if (boost::algorithm::to_upper_copy(entry.get_value()) == search_string_uppercase) {
-                return &entry;
+        if (m_value_to_id.empty()) {
+            m_value_to_id.reserve(m_entries.size());
+            for (size_t id = 0; id < m_entries.size(); ++id) {
+                m_value_to_id.emplace(m_entries[id].get_value(), static_cast<DictionaryIdType>(id));
             }
         }
+        auto const it = m_value_to_id.find(search_string);
+        return m_value_to_id.cend() == it ? nullptr : &m_entries[it->second];
     }
 
-    return nullptr;
+    if (m_uppercase_value_to_id.empty()) {
+        m_uppercase_value_to_id.reserve(m_entries.size());
+        for (size_t id = 0; id < m_entries.size(); ++id) {
+            m_uppercase_value_to_id.emplace(
+                    boost::algorithm::to_upper_copy(m_entries[id].get_value()),
+                    static_cast<DictionaryIdType>(id)
+            );
+        }
+    }
+    auto const it = m_uppercase_value_to_id.find(boost::algorithm::to_upper_copy(search_string));
+    return m_uppercase_value_to_id.cend() == it ? nullptr : &m_entries[it->second];
 }
 
 template <typename DictionaryIdType, typename EntryType>
@@ -256,14 +293,46 @@ void DictionaryReader<DictionaryIdType, EntryType>::get_entries_matching_wildcar
         bool ignore_case,
         std::unordered_set<EntryType const*>& entries
 ) const {
+    std::vector<string_utils::WildcardPattern> const patterns{
+            string_utils::WildcardPattern{wildcard_string, false == ignore_case}
+    };
+    std::vector<std::unordered_set<EntryType const*>> matching_entries;
+    get_entries_matching_wildcard_patterns(patterns, matching_entries);
+    entries.merge(matching_entries.front());
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryReader<DictionaryIdType, EntryType>::get_entries_matching_wildcard_patterns(
+        std::vector<string_utils::WildcardPattern> const& patterns,
+        std::vector<std::unordered_set<EntryType const*>>& entries
+) const {
+    entries.resize(patterns.size());
+    if (patterns.empty()) {
+        return;
+    }
+
+    // Each value is lowercased at most once, into a buffer reused across values, no matter how
+    // many case-insensitive patterns it's matched against
+    std::string lowercase_value;
     for (auto const& entry : m_entries) {
-        if (string_utils::wildcard_match_unsafe(
-                    entry.get_value(),
-                    wildcard_string,
-                    false == ignore_case
-            ))
-        {
-            entries.insert(&entry);
+        auto const& value = entry.get_value();
+        bool is_lowercase_value_set{false};
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            auto const& pattern = patterns[i];
+            bool matched{false};
+            if (pattern.is_case_sensitive_match()) {
+                matched = pattern.matches_case_folded(value);
+            } else {
+                if (false == is_lowercase_value_set) {
+                    lowercase_value = value;
+                    string_utils::to_lower(lowercase_value);
+                    is_lowercase_value_set = true;
+                }
+                matched = pattern.matches_case_folded(lowercase_value);
+            }
+            if (matched) {
+                entries[i].insert(&entry);
+            }
         }
     }
 }
@@ -285,6 +354,12 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_segment_ids() {
         m_entries[id].add_segment_containing_entry(segment_id);
     }
 }
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryReader<DictionaryIdType, EntryType>::clear_value_indices() {
+    m_value_to_id.clear();
+    m_uppercase_value_to_id.clear();
+}
 }  // namespace clp
 
 #endif  // CLP_DICTIONARYREADER_HPP
@@ -408,6 +408,13 @@ bool EncodedVariableInterpreter::wildcard_search_dictionary_and_get_encoded_matc
     // Find matches
     unordered_set<VariableDictionaryEntry const*> var_dict_entries;
     var_dict.get_entries_matching_wildcard_string(var_wildcard_str, ignore_case, var_dict_entries);
+    return add_wildcard_dictionary_matches(var_dict_entries, sub_query);
+}
+
+bool EncodedVariableInterpreter::add_wildcard_dictionary_matches(
+        unordered_set<VariableDictionaryEntry const*> const& var_dict_entries,
+        SubQuery& sub_query
+) {
     if (var_dict_entries.empty()) {
         // Not in dictionary
         return false;
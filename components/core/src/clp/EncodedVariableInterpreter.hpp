@@ -2,6 +2,7 @@
 #define CLP_ENCODEDVARIABLEINTERPRETER_HPP
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "ir/LogEvent.hpp"
@@ -163,6 +164,17 @@ public:
             bool ignore_case,
             SubQuery& sub_query
     );
+    /**
+     * Encodes the variable dictionary entries matching a wildcard variable and adds them to the
+     * given sub-query
+     * @param var_dict_entries
+     * @param sub_query
+     * @return true if there are any matching entries, false otherwise
+     */
+    static bool add_wildcard_dictionary_matches(
+            std::unordered_set<VariableDictionaryEntry const*> const& var_dict_entries,
+            SubQuery& sub_query
+    );
 
 private:
     /**
@@ -1,9 +1,12 @@
 #include "Grep.hpp"
 
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <log_surgeon/Constants.hpp>
 #include <string_utils/string_utils.hpp>
+#include <string_utils/WildcardPattern.hpp>
 
 #include "EncodedVariableInterpreter.hpp"
 #include "ir/parsing.hpp"
@@ -19,7 +22,6 @@ using clp::streaming_archive::reader::Message;
 using clp::string_utils::clean_up_wildcard_search_string;
 using clp::string_utils::is_alphabet;
 using clp::string_utils::is_wildcard;
-using clp::string_utils::wildcard_match_unsafe;
 using std::string;
 using std::vector;
 
@@ -260,12 +262,32 @@ public:
     std::set<int> m_type_ids_set;
 };
 
+// Variable dictionary entries matching each wildcard dictionary variable in a query, keyed by the
+// variable's value
+using WildcardVarDictMatches
+        = std::unordered_map<string, std::unordered_set<VariableDictionaryEntry const*>>;
+
 // Local prototypes
+/**
+ * Finds the variable dictionary entries matching every query token which is a dictionary variable
+ * with wildcards, in a single pass over the dictionary. Otherwise, each token would be searched for
+ * separately in every sub-query it's part of.
+ * @param query_tokens
+ * @param archive
+ * @param ignore_case
+ * @return The matching entries of each token
+ */
+WildcardVarDictMatches find_wildcard_var_dict_matches(
+        vector<QueryToken> const& query_tokens,
+        Archive const& archive,
+        bool ignore_case
+);
 /**
  * Process a QueryToken that is definitely a variable
  * @param query_token
  * @param archive
  * @param ignore_case
+ * @param wildcard_var_dict_matches
  * @param sub_query
  * @param logtype
  * @return true if this token might match a message, false otherwise
@@ -274,6 +296,7 @@ bool process_var_token(
         QueryToken const& query_token,
         Archive const& archive,
         bool ignore_case,
+        WildcardVarDictMatches const& wildcard_var_dict_matches,
         SubQuery& sub_query,
         string& logtype
 );
@@ -299,6 +322,7 @@ bool find_matching_message(
  * @param processed_search_string
  * @param query_tokens
  * @param ignore_case
+ * @param wildcard_var_dict_matches
  * @param sub_query
  * @return SubQueryMatchabilityResult::SupercedesAllSubQueries
  * @return SubQueryMatchabilityResult::WontMatch
@@ -309,13 +333,50 @@ SubQueryMatchabilityResult generate_logtypes_and_vars_for_subquery(
         string& processed_search_string,
         vector<QueryToken>& query_tokens,
         bool ignore_case,
+        WildcardVarDictMatches const& wildcard_var_dict_matches,
         SubQuery& sub_query
 );
 
+WildcardVarDictMatches find_wildcard_var_dict_matches(
+        vector<QueryToken> const& query_tokens,
+        Archive const& archive,
+        bool ignore_case
+) {
+    vector<string const*> var_values;
+    vector<string_utils::WildcardPattern> patterns;
+    WildcardVarDictMatches wildcard_var_dict_matches;
+    for (auto const& query_token : query_tokens) {
+        // Only tokens which are unambiguously dictionary variables are always searched for in the
+        // variable dictionary
+        if (query_token.is_ambiguous_token() || false == query_token.is_var()
+            || false == query_token.contains_wildcards()
+            || query_token.has_greedy_wildcard_in_middle())
+        {
+            continue;
+        }
+        auto const& value = query_token.get_value();
+        if (wildcard_var_dict_matches.try_emplace(value).second) {
+            var_values.push_back(&value);
+            patterns.emplace_back(value, false == ignore_case);
+        }
+    }
+    if (patterns.empty()) {
+        return wildcard_var_dict_matches;
+    }
+
+    vector<std::unordered_set<VariableDictionaryEntry const*>> matching_entries;
+    archive.get_var_dictionary().get_entries_matching_wildcard_patterns(patterns, matching_entries);
+    for (size_t i = 0; i < var_values.size(); ++i) {
+        wildcard_var_dict_matches[*var_values[i]] = std::move(matching_entries[i]);
+    }
+    return wildcard_var_dict_matches;
+}
+
 bool process_var_token(
         QueryToken const& query_token,
         Archive const& archive,
         bool ignore_case,
+        WildcardVarDictMatches const& wildcard_var_dict_matches,
         SubQuery& sub_query,
         string& logtype
 ) {
@@ -350,14 +411,26 @@ bool process_var_token(
             LogTypeDictionaryEntry::add_dict_var(logtype);
 
             if (query_token.cannot_convert_to_non_dict_var()) {
-                // Must be a dictionary variable, so search variable dictionary
-                if (!EncodedVariableInterpreter::wildcard_search_dictionary_and_get_encoded_matches(
-                            query_token.get_value(),
-                            archive.get_var_dictionary(),
-                            ignore_case,
-                            sub_query
-                    ))
+                // Must be a dictionary variable, so search variable dictionary unless its matches
+                // were already found
+                bool found_matches{false};
+                if (auto const matches_it = wildcard_var_dict_matches.find(query_token.get_value());
+                    wildcard_var_dict_matches.cend() != matches_it)
                 {
+                    found_matches = EncodedVariableInterpreter::add_wildcard_dictionary_matches(
+                            matches_it->second,
+                            sub_query
+                    );
+                } else {
+                    found_matches = EncodedVariableInterpreter::
+                            wildcard_search_dictionary_and_get_encoded_matches(
+                                    query_token.get_value(),
+                                    archive.get_var_dictionary(),
+                                    ignore_case,
+                                    sub_query
+                            );
+                }
+                if (false == found_matches) {
                     // Variable doesn't exist in dictionary
                     return false;
                 }
@@ -412,6 +485,7 @@ SubQueryMatchabilityResult generate_logtypes_and_vars_for_subquery(
         string& processed_search_string,
         vector<QueryToken>& query_tokens,
         bool ignore_case,
+        WildcardVarDictMatches const& wildcard_var_dict_matches,
         SubQuery& sub_query
 ) {
     size_t last_token_end_pos = 0;
@@ -457,7 +531,15 @@ SubQueryMatchabilityResult generate_logtypes_and_vars_for_subquery(
         } else {
             if (!query_token.is_var()) {
                 ir::append_constant_to_logtype(query_token.get_value(), escape_handler, logtype);
-            } else if (!process_var_token(query_token, archive, ignore_case, sub_query, logtype)) {
+            } else if (!process_var_token(
+                               query_token,
+                               archive,
+                               ignore_case,
+                               wildcard_var_dict_matches,
+                               sub_query,
+                               logtype
+                       ))
+            {
                 return SubQueryMatchabilityResult::WontMatch;
             }
         }
@@ -563,6 +645,9 @@ std::optional<Query> Grep::process_raw_query(
         }
     }
 
+    auto const wildcard_var_dict_matches
+            = find_wildcard_var_dict_matches(query_tokens, archive, ignore_case);
+
     // Generate a sub-query for each combination of ambiguous tokens
     // E.g., if there are two ambiguous tokens each of which could be a logtype or variable, we need
     // to create:
@@ -582,6 +667,7 @@ std::optional<Query> Grep::process_raw_query(
                 search_string_for_sub_queries,
                 query_tokens,
                 ignore_case,
+                wildcard_var_dict_matches,
                 sub_query
         );
         switch (matchability) {
@@ -942,11 +1028,7 @@ size_t Grep::search_and_output(
             || (query.contains_sub_queries() == false && query.search_string_matches_all() == false
             ))
         {
-            bool matched = wildcard_match_unsafe(
-                    decompressed_msg,
-                    query.get_search_string(),
-                    query.get_ignore_case() == false
-            );
+            bool matched = query.get_search_pattern().matches(decompressed_msg);
             if (!matched) {
                 continue;
             }
@@ -999,11 +1081,7 @@ bool Grep::search_and_decompress(
             || (query.contains_sub_queries() == false && query.search_string_matches_all() == false
             ))
         {
-            matched = wildcard_match_unsafe(
-                    decompressed_msg,
-                    query.get_search_string(),
-                    query.get_ignore_case() == false
-            );
+            matched = query.get_search_pattern().matches(decompressed_msg);
         } else {
             matched = true;
         }
@@ -1048,11 +1126,7 @@ size_t Grep::search(Query const& query, size_t limit, Archive& archive, File& co
                 break;
             }
 
-            bool matched = wildcard_match_unsafe(
-                    decompressed_msg,
-                    query.get_search_string(),
-                    query.get_ignore_case() == false
-            );
+            bool matched = query.get_search_pattern().matches(decompressed_msg);
             if (!matched) {
                 continue;
             }
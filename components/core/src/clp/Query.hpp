@@ -6,6 +6,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include <string_utils/WildcardPattern.hpp>
+
 #include "Defs.h"
 #include "LogTypeDictionaryEntry.hpp"
 #include "VariableDictionaryEntry.hpp"
@@ -189,6 +191,11 @@ public:
 
     std::string const& get_search_string() const { return m_search_string; }
 
+    /**
+     * @return The search string compiled for matching against decompressed messages
+     */
+    string_utils::WildcardPattern const& get_search_pattern() const { return m_search_pattern; }
+
     /**
      * Checks if the search string will match all messages (i.e., it's "" or "*")
      * @return true if the search string will match all messages
@@ -212,6 +219,7 @@ private:
     epochtime_t m_search_end_timestamp{cEpochTimeMax};
     bool m_ignore_case{false};
     std::string m_search_string;
+    string_utils::WildcardPattern m_search_pattern;
     bool m_search_string_matches_all{true};
     std::vector<SubQuery> m_sub_queries;
     std::vector<SubQuery const*> m_relevant_sub_queries;
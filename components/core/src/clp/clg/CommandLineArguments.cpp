@@ -55,6 +55,11 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
                     po::value<string>(&global_metadata_db_config_file_path)->value_name("FILE")
                             ->default_value(global_metadata_db_config_file_path),
                     "Global metadata DB YAML config"
+            )(
+                    "num-threads",
+                    po::value<size_t>(&m_num_threads)->value_name("NUM")
+                            ->default_value(m_num_threads),
+                    "Number of threads to search with. Archives are distributed across threads."
             );
 
     // Define input options
@@ -210,6 +215,10 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
             throw invalid_argument("Archive path not specified or empty.");
         }
 
+        if (m_num_threads < 1) {
+            throw invalid_argument("num-threads must be non-zero.");
+        }
+
         // Validate at least one wildcard string exists
         if (m_search_strings_file_path.empty() == false) {
             if (m_search_string.empty() == false) {
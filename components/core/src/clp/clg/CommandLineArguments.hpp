@@ -25,7 +25,8 @@ public:
               m_ignore_case(false),
               m_output_method(OutputMethod::StdoutText),
               m_search_begin_ts(cEpochTimeMin),
-              m_search_end_ts(cEpochTimeMax) {}
+              m_search_end_ts(cEpochTimeMax),
+              m_num_threads(1) {}
 
     // Methods
     ParsingResult parse_arguments(int argc, char const* argv[]) override;
@@ -48,6 +49,8 @@ public:
 
     GlobalMetadataDBConfig const& get_metadata_db_config() const { return m_metadata_db_config; }
 
+    size_t get_num_threads() const { return m_num_threads; }
+
 private:
     // Methods
     void print_basic_usage() const override;
@@ -61,6 +64,7 @@ private:
     OutputMethod m_output_method;
     epochtime_t m_search_begin_ts, m_search_end_ts;
     GlobalMetadataDBConfig m_metadata_db_config;
+    size_t m_num_threads;
 };
 }  // namespace clp::clg
 
@@ -1,7 +1,10 @@
 #include <sys/stat.h>
 
+#include <atomic>
 #include <filesystem>
+#include <future>
 #include <iostream>
+#include <mutex>
 
 #include <log_surgeon/Lexer.hpp>
 #include <spdlog/sinks/stdout_sinks.h>
@@ -52,13 +55,20 @@ static bool open_archive(string const& archive_path, Archive& archive_reader);
  * Searches the archive with the given parameters
  * @param search_strings
  * @param command_line_args
+ * @param output_mutex Mutex serializing output across search threads
  * @param archive
+ * @param forward_lexer
+ * @param reverse_lexer
+ * @param use_heuristic
  * @return true on success, false otherwise
  */
 static bool search(
         vector<string> const& search_strings,
-        CommandLineArguments& command_line_args,
+        CommandLineArguments const& command_line_args,
+        std::mutex& output_mutex,
         Archive& archive,
+        log_surgeon::lexers::ByteLexer& forward_lexer,
+        log_surgeon::lexers::ByteLexer& reverse_lexer,
         bool use_heuristic
 );
 /**
@@ -77,6 +87,7 @@ static bool open_compressed_file(
  * Searches all files referenced by a given database cursor
  * @param queries
  * @param output_method
+ * @param output_mutex Mutex serializing output across search threads
  * @param archive
  * @param file_metadata_ix
  * @return The total number of matches found across all files
@@ -84,6 +95,7 @@ static bool open_compressed_file(
 static size_t search_files(
         vector<Query>& queries,
         CommandLineArguments::OutputMethod output_method,
+        std::mutex& output_mutex,
         Archive& archive,
         MetadataDB::FileIterator& file_metadata_ix
 );
@@ -92,7 +104,7 @@ static size_t search_files(
  * @param orig_file_path
  * @param compressed_msg
  * @param decompressed_msg
- * @param custom_arg Unused
+ * @param custom_arg Mutex serializing output across search threads
  */
 static void print_result_text(
         string const& orig_file_path,
@@ -105,7 +117,7 @@ static void print_result_text(
  * @param orig_file_path
  * @param compressed_msg
  * @param decompressed_msg
- * @param custom_arg Unused
+ * @param custom_arg Mutex serializing output across search threads
  */
 static void print_result_binary(
         string const& orig_file_path,
@@ -203,7 +215,8 @@ static bool open_archive(string const& archive_path, Archive& archive_reader) {
 
 static bool search(
         vector<string> const& search_strings,
-        CommandLineArguments& command_line_args,
+        CommandLineArguments const& command_line_args,
+        std::mutex& output_mutex,
         Archive& archive,
         log_surgeon::lexers::ByteLexer& forward_lexer,
         log_surgeon::lexers::ByteLexer& reverse_lexer,
@@ -269,6 +282,7 @@ static bool search(
                 num_matches = search_files(
                         queries,
                         command_line_args.get_output_method(),
+                        output_mutex,
                         archive,
                         *file_metadata_ix
                 );
@@ -284,6 +298,7 @@ static bool search(
                 num_matches = search_files(
                         queries,
                         command_line_args.get_output_method(),
+                        output_mutex,
                         archive,
                         file_metadata_ix
                 );
@@ -292,6 +307,7 @@ static bool search(
                     num_matches += search_files(
                             queries,
                             command_line_args.get_output_method(),
+                            output_mutex,
                             archive,
                             file_metadata_ix
                     );
@@ -349,6 +365,7 @@ static bool open_compressed_file(
 static size_t search_files(
         vector<Query>& queries,
         CommandLineArguments::OutputMethod const output_method,
+        std::mutex& output_mutex,
         Archive& archive,
         MetadataDB::FileIterator& file_metadata_ix
 ) {
@@ -361,11 +378,11 @@ static size_t search_files(
     switch (output_method) {
         case CommandLineArguments::OutputMethod::StdoutText:
             output_func = print_result_text;
-            output_func_arg = nullptr;
+            output_func_arg = &output_mutex;
             break;
         case CommandLineArguments::OutputMethod::StdoutBinary:
             output_func = print_result_binary;
-            output_func_arg = nullptr;
+            output_func_arg = &output_mutex;
             break;
         default:
             SPDLOG_ERROR("Unknown output method - {}", (char)output_method);
@@ -401,6 +418,7 @@ static void print_result_text(
         string const& decompressed_msg,
         void* custom_arg
 ) {
+    std::lock_guard<std::mutex> lock{*static_cast<std::mutex*>(custom_arg)};
     printf("%s:%s", orig_file_path.c_str(), decompressed_msg.c_str());
 }
 
@@ -410,6 +428,7 @@ static void print_result_binary(
         string const& decompressed_msg,
         void* custom_arg
 ) {
+    std::lock_guard<std::mutex> lock{*static_cast<std::mutex*>(custom_arg)};
     bool write_successful = true;
     do {
         size_t length;
@@ -465,7 +484,7 @@ static void print_result_binary(
 int main(int argc, char const* argv[]) {
     // Program-wide initialization
     try {
-        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        auto stderr_logger = spdlog::stderr_logger_mt("stderr");
         spdlog::set_default_logger(stderr_logger);
         spdlog::set_pattern("%Y-%m-%d %H:%M:%S,%e [%l] %v");
     } catch (std::exception& e) {
@@ -544,18 +563,8 @@ int main(int argc, char const* argv[]) {
     }
     global_metadata_db->open();
 
-    // TODO: if performance is too slow, can make this more efficient by only diffing files with the
-    // same checksum
-    uint32_t const max_map_schema_length = 100'000;
-    std::map<std::string, log_surgeon::lexers::ByteLexer> forward_lexer_map;
-    std::map<std::string, log_surgeon::lexers::ByteLexer> reverse_lexer_map;
-    log_surgeon::lexers::ByteLexer one_time_use_forward_lexer;
-    log_surgeon::lexers::ByteLexer one_time_use_reverse_lexer;
-    log_surgeon::lexers::ByteLexer* forward_lexer_ptr;
-    log_surgeon::lexers::ByteLexer* reverse_lexer_ptr;
-
-    string archive_id;
-    Archive archive_reader;
+    // Collect the archives to search so that they can be distributed across threads
+    vector<string> archive_ids;
     for (auto archive_ix = std::unique_ptr<GlobalMetadataDB::ArchiveIterator>(get_archive_iterator(
                  *global_metadata_db,
                  command_line_args.get_file_path(),
@@ -565,82 +574,123 @@ int main(int argc, char const* argv[]) {
          archive_ix->contains_element();
          archive_ix->get_next())
     {
-        archive_ix->get_id(archive_id);
-        auto archive_path = archives_dir / archive_id;
-
-        if (false == std::filesystem::exists(archive_path)) {
-            SPDLOG_WARN(
-                    "Archive {} does not exist in '{}'.",
-                    archive_id,
-                    command_line_args.get_archives_dir()
-            );
-            continue;
-        }
+        archive_ix->get_id(archive_ids.emplace_back());
+    }
 
-        // Open archive
-        if (!open_archive(archive_path.string(), archive_reader)) {
-            return -1;
-        }
+    global_metadata_db->close();
 
-        // Generate lexer if schema file exists
-        auto schema_file_path = archive_path / clp::streaming_archive::cSchemaFileName;
-        bool use_heuristic = true;
-        if (std::filesystem::exists(schema_file_path)) {
-            use_heuristic = false;
-
-            char buf[max_map_schema_length];
-            FileReader file_reader;
-            file_reader.try_open(schema_file_path);
-
-            size_t num_bytes_read;
-            file_reader.read(buf, max_map_schema_length, num_bytes_read);
-            if (num_bytes_read < max_map_schema_length) {
-                auto forward_lexer_map_it = forward_lexer_map.find(buf);
-                auto reverse_lexer_map_it = reverse_lexer_map.find(buf);
-                // if there is a chance there might be a difference make a new lexer as it's pretty
-                // fast to create
-                if (forward_lexer_map_it == forward_lexer_map.end()) {
+    // Each worker takes archives until there are none left or a search fails. Workers have their
+    // own archive readers and lexers, so they only contend on output.
+    std::mutex output_mutex;
+    std::atomic_size_t next_archive{0};
+    std::atomic_bool search_failed{false};
+    auto search_archives = [&]() {
+        // TODO: if performance is too slow, can make this more efficient by only diffing files
+        // with the same checksum
+        uint32_t const max_map_schema_length = 100'000;
+        std::map<std::string, log_surgeon::lexers::ByteLexer> forward_lexer_map;
+        std::map<std::string, log_surgeon::lexers::ByteLexer> reverse_lexer_map;
+        log_surgeon::lexers::ByteLexer one_time_use_forward_lexer;
+        log_surgeon::lexers::ByteLexer one_time_use_reverse_lexer;
+        log_surgeon::lexers::ByteLexer* forward_lexer_ptr = &one_time_use_forward_lexer;
+        log_surgeon::lexers::ByteLexer* reverse_lexer_ptr = &one_time_use_reverse_lexer;
+
+        Archive archive_reader;
+        for (size_t i = next_archive++; i < archive_ids.size() && false == search_failed;
+             i = next_archive++)
+        {
+            auto const& archive_id = archive_ids[i];
+            auto archive_path = archives_dir / archive_id;
+
+            if (false == std::filesystem::exists(archive_path)) {
+                SPDLOG_WARN(
+                        "Archive {} does not exist in '{}'.",
+                        archive_id,
+                        command_line_args.get_archives_dir()
+                );
+                continue;
+            }
+
+            // Open archive
+            if (!open_archive(archive_path.string(), archive_reader)) {
+                search_failed = true;
+                return;
+            }
+
+            // Generate lexer if schema file exists
+            auto schema_file_path = archive_path / clp::streaming_archive::cSchemaFileName;
+            bool use_heuristic = true;
+            if (std::filesystem::exists(schema_file_path)) {
+                use_heuristic = false;
+
+                char buf[max_map_schema_length];
+                FileReader file_reader;
+                file_reader.try_open(schema_file_path);
+
+                size_t num_bytes_read;
+                file_reader.read(buf, max_map_schema_length, num_bytes_read);
+                if (num_bytes_read < max_map_schema_length) {
+                    auto forward_lexer_map_it = forward_lexer_map.find(buf);
+                    auto reverse_lexer_map_it = reverse_lexer_map.find(buf);
+                    // if there is a chance there might be a difference make a new lexer as it's
+                    // pretty fast to create
+                    if (forward_lexer_map_it == forward_lexer_map.end()) {
+                        // Create forward lexer
+                        auto insert_result
+                                = forward_lexer_map.emplace(buf, log_surgeon::lexers::ByteLexer());
+                        forward_lexer_ptr = &insert_result.first->second;
+                        load_lexer_from_file(schema_file_path, false, *forward_lexer_ptr);
+
+                        // Create reverse lexer
+                        insert_result
+                                = reverse_lexer_map.emplace(buf, log_surgeon::lexers::ByteLexer());
+                        reverse_lexer_ptr = &insert_result.first->second;
+                        load_lexer_from_file(schema_file_path, true, *reverse_lexer_ptr);
+                    } else {
+                        // load the lexers if they already exist
+                        forward_lexer_ptr = &forward_lexer_map_it->second;
+                        reverse_lexer_ptr = &reverse_lexer_map_it->second;
+                    }
+                } else {
                     // Create forward lexer
-                    auto insert_result
-                            = forward_lexer_map.emplace(buf, log_surgeon::lexers::ByteLexer());
-                    forward_lexer_ptr = &insert_result.first->second;
-                    load_lexer_from_file(schema_file_path, false, *forward_lexer_ptr);
+                    forward_lexer_ptr = &one_time_use_forward_lexer;
+                    load_lexer_from_file(schema_file_path, false, one_time_use_forward_lexer);
 
                     // Create reverse lexer
-                    insert_result
-                            = reverse_lexer_map.emplace(buf, log_surgeon::lexers::ByteLexer());
-                    reverse_lexer_ptr = &insert_result.first->second;
-                    load_lexer_from_file(schema_file_path, true, *reverse_lexer_ptr);
-                } else {
-                    // load the lexers if they already exist
-                    forward_lexer_ptr = &forward_lexer_map_it->second;
-                    reverse_lexer_ptr = &reverse_lexer_map_it->second;
+                    reverse_lexer_ptr = &one_time_use_reverse_lexer;
+                    load_lexer_from_file(schema_file_path, false, one_time_use_reverse_lexer);
                 }
-            } else {
-                // Create forward lexer
-                forward_lexer_ptr = &one_time_use_forward_lexer;
-                load_lexer_from_file(schema_file_path, false, one_time_use_forward_lexer);
+            }
 
-                // Create reverse lexer
-                reverse_lexer_ptr = &one_time_use_reverse_lexer;
-                load_lexer_from_file(schema_file_path, false, one_time_use_reverse_lexer);
+            // Perform search
+            if (!search(search_strings,
+                        command_line_args,
+                        output_mutex,
+                        archive_reader,
+                        *forward_lexer_ptr,
+                        *reverse_lexer_ptr,
+                        use_heuristic))
+            {
+                search_failed = true;
+                return;
             }
+            archive_reader.close();
         }
+    };
 
-        // Perform search
-        if (!search(search_strings,
-                    command_line_args,
-                    archive_reader,
-                    *forward_lexer_ptr,
-                    *reverse_lexer_ptr,
-                    use_heuristic))
-        {
-            return -1;
-        }
-        archive_reader.close();
+    // Search all archives, using the calling thread as one of the workers
+    auto const num_workers = std::min(command_line_args.get_num_threads(), archive_ids.size());
+    vector<std::future<void>> workers;
+    for (size_t i = 1; i < num_workers; ++i) {
+        workers.emplace_back(std::async(std::launch::async, search_archives));
+    }
+    search_archives();
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    if (search_failed) {
+        return -1;
     }
-
-    global_metadata_db->close();
 
     Profiler::stop_continuous_measurement<Profiler::ContinuousMeasurementIndex::Search>();
     LOG_CONTINUOUS_MEASUREMENT(Profiler::ContinuousMeasurementIndex::Search)
@@ -53,6 +53,12 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
                             ->value_name("FILE")
                             ->default_value(config_file_path),
                     "Use configuration options from FILE"
+            )(
+                    "num-threads",
+                    po::value<size_t>(&m_num_threads)
+                            ->value_name("NUM")
+                            ->default_value(m_num_threads),
+                    "Number of threads to search with. Segments are distributed across threads."
             );
     // clang-format on
 
@@ -345,6 +351,10 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
             throw invalid_argument("file-path cannot be an empty string.");
         }
 
+        if (m_num_threads < 1) {
+            throw invalid_argument("num-threads must be non-zero.");
+        }
+
         // Validate count by time bucket size
         if (parsed_command_line_options.count("count-by-time") > 0) {
             m_do_count_by_time_aggregation = true;
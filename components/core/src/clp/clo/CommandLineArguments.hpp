@@ -30,6 +30,7 @@ public:
               m_ignore_case(false),
               m_search_begin_ts(cEpochTimeMin),
               m_search_end_ts(cEpochTimeMax),
+              m_num_threads(1),
               m_batch_size(1000),
               m_max_num_results(1000) {}
 
@@ -48,6 +49,8 @@ public:
 
     epochtime_t get_search_end_ts() const { return m_search_end_ts; }
 
+    size_t get_num_threads() const { return m_num_threads; }
+
     std::string const& get_mongodb_uri() const { return m_mongodb_uri; }
 
     std::string const& get_mongodb_collection() const { return m_mongodb_collection; }
@@ -123,6 +126,7 @@ private:
     std::string m_search_string;
     std::string m_file_path;
     epochtime_t m_search_begin_ts, m_search_end_ts;
+    size_t m_num_threads;
 
     // Network output variables
     std::string m_network_dest_host;
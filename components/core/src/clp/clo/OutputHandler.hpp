@@ -3,6 +3,8 @@
 
 #include <unistd.h>
 
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <string_view>
@@ -284,6 +286,44 @@ private:
     std::map<int64_t, int64_t> m_bucket_counts;
     int64_t m_count_by_time_bucket_size;
 };
+
+/**
+ * Output handler that serializes access to another output handler so that it can be shared by
+ * multiple search threads.
+ */
+class SynchronizedOutputHandler : public OutputHandler {
+public:
+    // Constructors
+    explicit SynchronizedOutputHandler(std::unique_ptr<OutputHandler> output_handler)
+            : m_output_handler{std::move(output_handler)} {}
+
+    // Methods inherited from OutputHandler
+    ErrorCode add_result(
+            std::string_view orig_file_path,
+            std::string_view orig_file_id,
+            streaming_archive::reader::Message const& encoded_message,
+            std::string_view decompressed_message
+    ) override {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_output_handler
+                ->add_result(orig_file_path, orig_file_id, encoded_message, decompressed_message);
+    }
+
+    ErrorCode flush() override {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_output_handler->flush();
+    }
+
+    [[nodiscard]] bool can_skip_file(clp::streaming_archive::MetadataDB::FileIterator const& it
+    ) override {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_output_handler->can_skip_file(it);
+    }
+
+private:
+    std::unique_ptr<OutputHandler> m_output_handler;
+    std::mutex m_mutex;
+};
 }  // namespace clp::clo
 
 #endif  // CLP_CLO_OUTPUTHANDLER_HPP
@@ -1,5 +1,8 @@
+#include <atomic>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <unordered_set>
 
 #include <boost/filesystem.hpp>
 #include <mongocxx/instance.hpp>
@@ -19,6 +22,7 @@ using clp::clo::CountOutputHandler;
 using clp::clo::NetworkOutputHandler;
 using clp::clo::OutputHandler;
 using clp::clo::ResultsCacheOutputHandler;
+using clp::clo::SynchronizedOutputHandler;
 using clp::CommandLineArgumentsBase;
 using clp::epochtime_t;
 using clp::ErrorCode;
@@ -69,14 +73,13 @@ static SearchFilesResult search_file(
  * @param archive
  * @param file_metadata_ix
  * @param output_handler
- * @param segments_to_search
+ * @return false on failure to send a result, true otherwise
  */
-static void search_files(
+static bool search_files(
         Query& query,
         Archive& archive,
         MetadataDB::FileIterator& file_metadata_ix,
-        std::unique_ptr<OutputHandler>& output_handler,
-        std::set<clp::segment_id_t> const& segments_to_search
+        std::unique_ptr<OutputHandler>& output_handler
 );
 /**
  * Searches an archive with the given path
@@ -140,46 +143,26 @@ static SearchFilesResult search_file(
     return result;
 }
 
-void search_files(
+static bool search_files(
         Query& query,
         Archive& archive,
         MetadataDB::FileIterator& file_metadata_ix,
-        std::unique_ptr<OutputHandler>& output_handler,
-        std::set<clp::segment_id_t> const& segments_to_search
+        std::unique_ptr<OutputHandler>& output_handler
 ) {
-    if (query.contains_sub_queries()) {
-        for (; file_metadata_ix.has_next(); file_metadata_ix.next()) {
-            if (segments_to_search.count(file_metadata_ix.get_segment_id()) == 0) {
-                continue;
-            }
-
-            if (output_handler->can_skip_file(file_metadata_ix)) {
-                continue;
-            }
-
-            auto result = search_file(query, archive, file_metadata_ix, output_handler);
-            if (SearchFilesResult::OpenFailure == result) {
-                continue;
-            }
-            if (SearchFilesResult::ResultSendFailure == result) {
-                break;
-            }
+    for (; file_metadata_ix.has_next(); file_metadata_ix.next()) {
+        if (output_handler->can_skip_file(file_metadata_ix)) {
+            continue;
         }
-    } else {
-        for (; file_metadata_ix.has_next(); file_metadata_ix.next()) {
-            if (output_handler->can_skip_file(file_metadata_ix)) {
-                continue;
-            }
 
-            auto result = search_file(query, archive, file_metadata_ix, output_handler);
-            if (SearchFilesResult::OpenFailure == result) {
-                continue;
-            }
-            if (SearchFilesResult::ResultSendFailure == result) {
-                break;
-            }
+        auto result = search_file(query, archive, file_metadata_ix, output_handler);
+        if (SearchFilesResult::OpenFailure == result) {
+            continue;
+        }
+        if (SearchFilesResult::ResultSendFailure == result) {
+            return false;
         }
     }
+    return true;
 }
 
 static bool search_archive(
@@ -248,22 +231,84 @@ static bool search_archive(
         );
     }
 
+    // Collect the segments to search in the order their files are iterated (by segment end
+    // timestamp), so that output handlers see the latest results first
+    vector<clp::segment_id_t> segments_to_search;
     auto file_metadata_ix_ptr = archive_reader.get_file_iterator(
             search_begin_ts,
             search_end_ts,
             command_line_args.get_file_path(),
             true
     );
-    auto& file_metadata_ix = *file_metadata_ix_ptr;
-    search_files(
-            query,
-            archive_reader,
-            file_metadata_ix,
-            output_handler,
-            ids_of_segments_to_search
-    );
+    std::unordered_set<clp::segment_id_t> collected_segments;
+    for (auto& file_metadata_ix = *file_metadata_ix_ptr; file_metadata_ix.has_next();
+         file_metadata_ix.next())
+    {
+        auto const segment_id = file_metadata_ix.get_segment_id();
+        if (query.contains_sub_queries() && 0 == ids_of_segments_to_search.count(segment_id)) {
+            continue;
+        }
+        if (collected_segments.insert(segment_id).second) {
+            segments_to_search.push_back(segment_id);
+        }
+    }
     file_metadata_ix_ptr.reset(nullptr);
 
+    auto const num_workers
+            = std::min(command_line_args.get_num_threads(), segments_to_search.size());
+    if (num_workers > 1) {
+        output_handler = std::make_unique<SynchronizedOutputHandler>(std::move(output_handler));
+    }
+
+    // Each worker takes segments until there are none left, or until a result can't be sent
+    std::atomic_size_t next_segment{0};
+    std::atomic_bool result_send_failed{false};
+    auto search_segments = [&](Archive& worker_archive_reader) {
+        // Each worker needs its own copy of the query since it tracks the sub-queries relevant to
+        // the segment being searched
+        auto worker_query = query;
+        for (size_t i = next_segment++;
+             i < segments_to_search.size() && false == result_send_failed;
+             i = next_segment++)
+        {
+            auto worker_file_metadata_ix = worker_archive_reader.get_file_iterator(
+                    search_begin_ts,
+                    search_end_ts,
+                    command_line_args.get_file_path(),
+                    segments_to_search[i],
+                    true
+            );
+            if (false
+                == search_files(
+                        worker_query,
+                        worker_archive_reader,
+                        *worker_file_metadata_ix,
+                        output_handler
+                ))
+            {
+                result_send_failed = true;
+            }
+        }
+    };
+
+    // Search all segments, using the calling thread as one of the workers. Every other worker
+    // opens its own archive reader so that it has its own segment manager, but shares the calling
+    // thread's dictionaries, which are only read from while searching.
+    vector<std::future<void>> workers;
+    for (size_t i = 1; i < num_workers; ++i) {
+        workers.emplace_back(std::async(std::launch::async, [&]() {
+            Archive worker_archive_reader;
+            worker_archive_reader.open_with_shared_dictionaries(archive_reader);
+            search_segments(worker_archive_reader);
+            worker_archive_reader.close();
+        }));
+    }
+    search_segments(archive_reader);
+    for (auto& worker : workers) {
+        // Rethrows any exception thrown by the worker
+        worker.get();
+    }
+
     archive_reader.close();
 
     auto ecode = output_handler->flush();
@@ -280,7 +325,7 @@ static bool search_archive(
 int main(int argc, char const* argv[]) {
     // Program-wide initialization
     try {
-        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        auto stderr_logger = spdlog::stderr_logger_mt("stderr");
         spdlog::set_default_logger(stderr_logger);
         spdlog::set_pattern("%Y-%m-%d %H:%M:%S,%e [%l] %v");
     } catch (std::exception& e) {
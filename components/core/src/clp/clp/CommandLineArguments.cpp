@@ -357,6 +357,13 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
                             ->value_name("SIZE")
                             ->default_value(m_target_segment_uncompressed_size),
                     "Target uncompressed size (B) of a segment before a new one is created"
+            )(
+                    "segment-frame-size",
+                    po::value<size_t>(&m_segment_frame_size)
+                            ->value_name("SIZE")
+                            ->default_value(m_segment_frame_size),
+                    "Uncompressed size (B) of each independently decompressible frame in a "
+                    "segment. 0 compresses each segment as a single frame."
             )(
                     "target-dictionaries-size",
                     po::value<size_t>(&m_target_data_size_of_dictionaries)
@@ -369,6 +376,13 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
                             ->value_name("LEVEL")
                             ->default_value(m_compression_level),
                     "1 (fast/low compression) to 9 (slow/high compression)"
+            )(
+                    "num-threads",
+                    po::value<size_t>(&m_num_threads)
+                            ->value_name("NUM")
+                            ->default_value(m_num_threads),
+                    "Number of threads to compress with. Input files are distributed across "
+                    "threads and each thread writes its own archives."
             )(
                     "print-archive-stats-progress",
                     po::bool_switch(&m_print_archive_stats_progress),
@@ -438,6 +452,10 @@ CommandLineArguments::parse_arguments(int argc, char const* argv[]) {
                 throw invalid_argument("target-data-size-of-dictionaries must be non-zero.");
             }
 
+            if (m_num_threads < 1) {
+                throw invalid_argument("num-threads must be non-zero.");
+            }
+
             if (false == m_path_prefix_to_remove.empty()) {
                 if (false == boost::filesystem::exists(m_path_prefix_to_remove)) {
                     throw invalid_argument("Specified prefix to remove does not exist.");
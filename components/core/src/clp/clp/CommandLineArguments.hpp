@@ -26,9 +26,11 @@ public:
               m_sort_input_files(true),
               m_print_archive_stats_progress(false),
               m_target_segment_uncompressed_size(1L * 1024 * 1024 * 1024),
+              m_segment_frame_size(4L * 1024 * 1024),
               m_target_encoded_file_size(512L * 1024 * 1024),
               m_target_data_size_of_dictionaries(100L * 1024 * 1024),
-              m_compression_level(3) {}
+              m_compression_level(3),
+              m_num_threads(1) {}
 
     // Methods
     ParsingResult parse_arguments(int argc, char const* argv[]) override;
@@ -57,12 +59,16 @@ public:
         return m_target_segment_uncompressed_size;
     }
 
+    size_t get_segment_frame_size() const { return m_segment_frame_size; }
+
     size_t get_target_data_size_of_dictionaries() const {
         return m_target_data_size_of_dictionaries;
     }
 
     int get_compression_level() const { return m_compression_level; }
 
+    size_t get_num_threads() const { return m_num_threads; }
+
     Command get_command() const { return m_command; }
 
     std::string const& get_archives_dir() const { return m_archives_dir; }
@@ -98,8 +104,10 @@ private:
     bool m_print_archive_stats_progress;
     size_t m_target_encoded_file_size;
     size_t m_target_segment_uncompressed_size;
+    size_t m_segment_frame_size;
     size_t m_target_data_size_of_dictionaries;
     int m_compression_level;
+    size_t m_num_threads;
     Command m_command;
     std::string m_archives_dir;
     std::vector<std::string> m_input_paths;
@@ -1,6 +1,11 @@
 #include "compression.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <mutex>
+#include <span>
 
 #include <archive_entry.h>
 #include <boost/filesystem/operations.hpp>
@@ -94,96 +99,155 @@ bool compress(
 
     // Setup config
     streaming_archive::writer::Archive::UserConfig archive_user_config;
-    archive_user_config.id = uuid_generator();
-    archive_user_config.creator_id = uuid_generator();
     archive_user_config.creation_num = 0;
     archive_user_config.target_segment_uncompressed_size
             = command_line_args.get_target_segment_uncompressed_size();
+    archive_user_config.segment_frame_size = command_line_args.get_segment_frame_size();
     archive_user_config.compression_level = command_line_args.get_compression_level();
     archive_user_config.output_dir = command_line_args.get_output_dir();
     archive_user_config.global_metadata_db = global_metadata_db.get();
+    std::mutex global_metadata_db_mutex;
+    archive_user_config.global_metadata_db_mutex = &global_metadata_db_mutex;
     archive_user_config.print_archive_stats_progress
             = command_line_args.print_archive_stats_progress();
 
-    // Open Archive
-    streaming_archive::writer::Archive archive_writer;
-    // Set schema file if specified by user
-    if (false == command_line_args.get_use_heuristic()) {
-        archive_writer.m_schema_file_path = command_line_args.get_schema_file_path();
+    if (command_line_args.sort_input_files()) {
+        sort(files_to_compress.begin(), files_to_compress.end(), file_gt_last_write_time_comparator
+        );
     }
-    // Open archive
-    archive_writer.open(archive_user_config);
+    // Sort files by group ID to avoid spreading groups over multiple segments
+    sort(grouped_files_to_compress.begin(),
+         grouped_files_to_compress.end(),
+         file_group_id_comparator);
 
-    archive_writer.add_empty_directories(empty_directory_paths);
+    // Each ungrouped file is a separate task, whereas each group of files is a single task so that
+    // a group is compressed into the same archive
+    vector<std::span<FileToCompress const>> tasks;
+    for (auto const& file_to_compress : files_to_compress) {
+        tasks.emplace_back(&file_to_compress, 1);
+    }
+    for (auto group_begin = grouped_files_to_compress.cbegin();
+         grouped_files_to_compress.cend() != group_begin;)
+    {
+        auto group_end = std::find_if(
+                group_begin,
+                grouped_files_to_compress.cend(),
+                [&](FileToCompress const& file_to_compress) {
+                    return file_to_compress.get_group_id() != group_begin->get_group_id();
+                }
+        );
+        tasks.emplace_back(group_begin, group_end);
+        group_begin = group_end;
+    }
 
-    bool all_files_compressed_successfully = true;
-    FileCompressor file_compressor(uuid_generator, std::move(reader_parser));
     auto target_data_size_of_dictionaries
             = command_line_args.get_target_data_size_of_dictionaries();
-
-    // Compress all files
-    size_t num_files_compressed = 0;
     size_t num_files_to_compress = 0;
     if (command_line_args.show_progress()) {
         num_files_to_compress = files_to_compress.size() + grouped_files_to_compress.size();
     }
-    if (command_line_args.sort_input_files()) {
-        sort(files_to_compress.begin(), files_to_compress.end(), file_gt_last_write_time_comparator
-        );
-    }
-    for (auto it = files_to_compress.cbegin(); it != files_to_compress.cend(); ++it) {
-        if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
-            split_archive(archive_user_config, archive_writer);
+    std::atomic_size_t num_files_compressed{0};
+    std::mutex progress_mutex;
+
+    // Each worker takes tasks until there are none left, compressing them into its own archives.
+    // Since every archive has its own dictionaries, workers only contend on the global metadata DB.
+    std::atomic_size_t next_task{0};
+    auto compress_tasks = [&](std::unique_ptr<log_surgeon::ReaderParser> worker_reader_parser,
+                              bool should_add_empty_directories) {
+        auto worker_uuid_generator = boost::uuids::random_generator();
+        auto worker_archive_user_config = archive_user_config;
+        worker_archive_user_config.id = worker_uuid_generator();
+        worker_archive_user_config.creator_id = worker_uuid_generator();
+
+        streaming_archive::writer::Archive archive_writer;
+        // Set schema file if specified by user
+        if (false == command_line_args.get_use_heuristic()) {
+            archive_writer.m_schema_file_path = command_line_args.get_schema_file_path();
         }
-        if (false
-            == file_compressor.compress_file(
-                    target_data_size_of_dictionaries,
-                    archive_user_config,
-                    target_encoded_file_size,
-                    *it,
-                    archive_writer,
-                    use_heuristic
-            ))
+        // The archive is opened lazily so that workers which start after every task has been taken
+        // don't create empty archives
+        bool is_archive_open{false};
+        auto open_archive = [&]() {
+            archive_writer.open(worker_archive_user_config);
+            if (should_add_empty_directories) {
+                archive_writer.add_empty_directories(empty_directory_paths);
+            }
+            is_archive_open = true;
+        };
+
+        bool all_files_compressed_successfully = true;
+        FileCompressor file_compressor(worker_uuid_generator, std::move(worker_reader_parser));
+        for (size_t i = next_task++; i < tasks.size(); i = next_task++) {
+            if (false == is_archive_open) {
+                open_archive();
+            }
+            for (auto const& file_to_compress : tasks[i]) {
+                if (archive_writer.get_data_size_of_dictionaries()
+                    >= target_data_size_of_dictionaries)
+                {
+                    split_archive(worker_archive_user_config, archive_writer);
+                }
+                if (false
+                    == file_compressor.compress_file(
+                            target_data_size_of_dictionaries,
+                            worker_archive_user_config,
+                            target_encoded_file_size,
+                            file_to_compress,
+                            archive_writer,
+                            use_heuristic
+                    ))
+                {
+                    all_files_compressed_successfully = false;
+                }
+                if (command_line_args.show_progress()) {
+                    auto const num_compressed = ++num_files_compressed;
+                    std::lock_guard<std::mutex> lock{progress_mutex};
+                    cerr << "Compressed " << num_compressed << '/' << num_files_to_compress
+                         << " files" << '\r';
+                }
+            }
+        }
+
+        // Empty directories must still be stored, and an input without any files still produces an
+        // archive
+        if (false == is_archive_open && should_add_empty_directories
+            && (false == empty_directory_paths.empty() || tasks.empty()))
         {
-            all_files_compressed_successfully = false;
+            open_archive();
         }
-        if (command_line_args.show_progress()) {
-            ++num_files_compressed;
-            cerr << "Compressed " << num_files_compressed << '/' << num_files_to_compress
-                 << " files" << '\r';
+        if (is_archive_open) {
+            archive_writer.close();
         }
-    }
 
-    // Sort files by group ID to avoid spreading groups over multiple segments
-    sort(grouped_files_to_compress.begin(),
-         grouped_files_to_compress.end(),
-         file_group_id_comparator);
-    // Compress grouped files
-    for (auto const& file_to_compress : grouped_files_to_compress) {
-        if (archive_writer.get_data_size_of_dictionaries() >= target_data_size_of_dictionaries) {
-            split_archive(archive_user_config, archive_writer);
+        return all_files_compressed_successfully;
+    };
+
+    // Compress all files, using the calling thread as one of the workers
+    size_t num_workers
+            = std::min(command_line_args.get_num_threads(), std::max<size_t>(tasks.size(), 1));
+    vector<std::future<bool>> workers;
+    for (size_t i = 1; i < num_workers; ++i) {
+        // Each worker needs its own parser since parsers are stateful
+        std::unique_ptr<log_surgeon::ReaderParser> worker_reader_parser;
+        if (false == use_heuristic) {
+            worker_reader_parser = std::make_unique<log_surgeon::ReaderParser>(
+                    command_line_args.get_schema_file_path()
+            );
         }
-        if (false
-            == file_compressor.compress_file(
-                    target_data_size_of_dictionaries,
-                    archive_user_config,
-                    target_encoded_file_size,
-                    file_to_compress,
-                    archive_writer,
-                    use_heuristic
-            ))
-        {
+        workers.emplace_back(std::async(
+                std::launch::async,
+                compress_tasks,
+                std::move(worker_reader_parser),
+                false
+        ));
+    }
+    bool all_files_compressed_successfully = compress_tasks(std::move(reader_parser), true);
+    for (auto& worker : workers) {
+        if (false == worker.get()) {
             all_files_compressed_successfully = false;
         }
-        if (command_line_args.show_progress()) {
-            ++num_files_compressed;
-            cerr << "Compressed " << num_files_compressed << '/' << num_files_to_compress
-                 << " files" << '\r';
-        }
     }
 
-    archive_writer.close();
-
     return all_files_compressed_successfully;
 }
 
@@ -89,7 +89,7 @@ void Archive::open(string const& path) {
     string logtype_segment_index_path = m_path;
     logtype_segment_index_path += '/';
     logtype_segment_index_path += cLogTypeSegmentIndexFilename;
-    m_logtype_dictionary.open(logtype_dict_path, logtype_segment_index_path);
+    m_logtype_dictionary->open(logtype_dict_path, logtype_segment_index_path);
 
     // Open variables dictionary
     string var_dict_path = m_path;
@@ -98,7 +98,7 @@ void Archive::open(string const& path) {
     string var_segment_index_path = m_path;
     var_segment_index_path += '/';
     var_segment_index_path += cVarSegmentIndexFilename;
-    m_var_dictionary.open(var_dict_path, var_segment_index_path);
+    m_var_dictionary->open(var_dict_path, var_segment_index_path);
 
     // Open segment manager
     m_segments_dir_path = m_path;
@@ -112,9 +112,29 @@ void Archive::open(string const& path) {
     segment_list_path += cSegmentListFilename;
 }
 
+void Archive::open_with_shared_dictionaries(Archive const& archive) {
+    m_path = archive.m_path;
+    m_metadata_db.open((boost::filesystem::path(m_path) / cMetadataDBFileName).string());
+
+    m_logtype_dictionary = archive.m_logtype_dictionary;
+    m_var_dictionary = archive.m_var_dictionary;
+
+    m_segments_dir_path = archive.m_segments_dir_path;
+    m_segment_manager.open(m_segments_dir_path);
+}
+
 void Archive::close() {
-    m_logtype_dictionary.close();
-    m_var_dictionary.close();
+    // Dictionaries shared with other readers are only closed by the last reader using them
+    if (1 == m_logtype_dictionary.use_count()) {
+        m_logtype_dictionary->close();
+    } else {
+        m_logtype_dictionary = std::make_shared<LogTypeDictionaryReader>();
+    }
+    if (1 == m_var_dictionary.use_count()) {
+        m_var_dictionary->close();
+    } else {
+        m_var_dictionary = std::make_shared<VariableDictionaryReader>();
+    }
     m_segment_manager.close();
     m_segments_dir_path.clear();
     m_metadata_db.close();
@@ -122,12 +142,12 @@ void Archive::close() {
 }
 
 void Archive::refresh_dictionaries() {
-    m_logtype_dictionary.read_new_entries();
-    m_var_dictionary.read_new_entries();
+    m_logtype_dictionary->read_new_entries();
+    m_var_dictionary->read_new_entries();
 }
 
 ErrorCode Archive::open_file(File& file, MetadataDB::FileIterator const& file_metadata_ix) {
-    return file.open_me(m_logtype_dictionary, file_metadata_ix, m_segment_manager);
+    return file.open_me(*m_logtype_dictionary, file_metadata_ix, m_segment_manager);
 }
 
 void Archive::close_file(File& file) {
@@ -139,11 +159,11 @@ void Archive::reset_file_indices(streaming_archive::reader::File& file) {
 }
 
 LogTypeDictionaryReader const& Archive::get_logtype_dictionary() const {
-    return m_logtype_dictionary;
+    return *m_logtype_dictionary;
 }
 
 VariableDictionaryReader const& Archive::get_var_dictionary() const {
-    return m_var_dictionary;
+    return *m_var_dictionary;
 }
 
 bool Archive::find_message_in_time_range(
@@ -208,11 +228,11 @@ bool Archive::decompress_message_without_ts(
 
     // Build original message content
     auto const logtype_id = compressed_msg.get_logtype_id();
-    auto const& logtype_entry = m_logtype_dictionary.get_entry(logtype_id);
+    auto const& logtype_entry = m_logtype_dictionary->get_entry(logtype_id);
     if (false
         == EncodedVariableInterpreter::decode_variables_into_message(
                 logtype_entry,
-                m_var_dictionary,
+                *m_var_dictionary,
                 compressed_msg.get_vars(),
                 decompressed_msg
         ))
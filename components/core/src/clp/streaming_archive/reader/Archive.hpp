@@ -42,6 +42,16 @@ public:
      * @throw FileReader::OperationFailed if failed to open any dictionary
      */
     void open(std::string const& path);
+
+    /**
+     * Opens the same archive as another open reader, sharing that reader's dictionaries instead of
+     * loading another copy of them. Each reader still has its own metadata DB connection and
+     * segment manager, so the readers can be used by different threads to decompress messages.
+     * Neither reader's dictionaries may be refreshed while the readers share them.
+     * @param archive
+     * @throw Same as MetadataDB::open and SegmentManager::open
+     */
+    void open_with_shared_dictionaries(Archive const& archive);
     void close();
 
     /**
@@ -190,8 +200,13 @@ private:
     std::string m_id;
     std::string m_path;
     std::string m_segments_dir_path;
-    LogTypeDictionaryReader m_logtype_dictionary;
-    VariableDictionaryReader m_var_dictionary;
+    // Shared with any readers opened by open_with_shared_dictionaries
+    std::shared_ptr<LogTypeDictionaryReader> m_logtype_dictionary{
+            std::make_shared<LogTypeDictionaryReader>()
+    };
+    std::shared_ptr<VariableDictionaryReader> m_var_dictionary{
+            std::make_shared<VariableDictionaryReader>()
+    };
 
     SegmentManager m_segment_manager;
 
@@ -3,12 +3,15 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <climits>
+#include <cstring>
 
 #include <boost/filesystem.hpp>
 
 #include "../../FileReader.hpp"
 #include "../../spdlog_with_specializations.hpp"
+#include "../../streaming_compression/zstd/Constants.hpp"
 
 using std::make_unique;
 using std::string;
@@ -16,6 +19,20 @@ using std::to_string;
 using std::unique_ptr;
 
 namespace clp::streaming_archive::reader {
+namespace {
+/**
+ * @tparam ValueType
+ * @param data
+ * @return The numeric value stored at the given (potentially unaligned) location
+ */
+template <typename ValueType>
+ValueType read_numeric_value(char const* data) {
+    ValueType value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+}  // namespace
+
 Segment::~Segment() {
     // If user forgot to explicitly close the file for some reason, close it again (doesn't
     // hurt)
@@ -73,7 +90,9 @@ ErrorCode Segment::try_open(string const& segment_dir_path, segment_id_t segment
         return ErrorCode_Failure;
     }
 
-    m_decompressor.open(m_memory_mapped_segment_file.data(), segment_file_size);
+    if (false == load_seek_table()) {
+        m_decompressor.open(m_memory_mapped_segment_file.data(), segment_file_size);
+    }
 
     m_segment_path = segment_path;
     return ErrorCode_Success;
@@ -82,6 +101,8 @@ ErrorCode Segment::try_open(string const& segment_dir_path, segment_id_t segment
 void Segment::close() {
     if (!m_segment_path.empty()) {
         m_decompressor.close();
+        m_frames.clear();
+        m_open_frame_ix = cNoOpenFrame;
         m_memory_mapped_segment_file.close();
         m_segment_path.clear();
     }
@@ -96,10 +117,136 @@ Segment::try_read(uint64_t decompressed_stream_pos, char* extraction_buf, uint64
                      "during decompression");
         return ErrorCode_BadParam;
     }
+    if (false == m_frames.empty()) {
+        return try_read_frames(decompressed_stream_pos, extraction_buf, extraction_len);
+    }
     return m_decompressor.get_decompressed_stream_region(
             decompressed_stream_pos,
             extraction_buf,
             extraction_len
     );
 }
+
+bool Segment::load_seek_table() {
+    namespace seekable = streaming_compression::zstd::seekable;
+
+    auto const* segment = m_memory_mapped_segment_file.data();
+    auto const segment_size = m_memory_mapped_segment_file.size();
+    if (segment_size < seekable::cSkippableFrameHeaderSize + seekable::cSeekTableFooterSize) {
+        return false;
+    }
+
+    // Parse the footer
+    auto const* footer = segment + segment_size - seekable::cSeekTableFooterSize;
+    auto const num_frames = read_numeric_value<uint32_t>(footer);
+    auto const descriptor = read_numeric_value<uint8_t>(footer + sizeof(uint32_t));
+    auto const magic_number
+            = read_numeric_value<uint32_t>(footer + sizeof(uint32_t) + sizeof(uint8_t));
+    if (seekable::cSeekTableMagicNumber != magic_number) {
+        return false;
+    }
+
+    size_t entry_size = seekable::cSeekTableEntrySize;
+    if (descriptor & seekable::cSeekTableDescriptorChecksumFlag) {
+        entry_size += seekable::cSeekTableEntryChecksumSize;
+    }
+    uint64_t const seek_table_size
+            = static_cast<uint64_t>(num_frames) * entry_size + seekable::cSeekTableFooterSize;
+    if (segment_size < seekable::cSkippableFrameHeaderSize + seek_table_size) {
+        return false;
+    }
+
+    // Validate the skippable frame containing the seek table
+    auto const compressed_frames_size
+            = segment_size - seekable::cSkippableFrameHeaderSize - seek_table_size;
+    auto const* header = segment + compressed_frames_size;
+    if (seekable::cSkippableFrameMagicNumber
+                != (read_numeric_value<uint32_t>(header)
+                    & seekable::cSkippableFrameMagicNumberMask)
+        || seek_table_size != read_numeric_value<uint32_t>(header + sizeof(uint32_t)))
+    {
+        return false;
+    }
+
+    // Load the frames, ensuring they exactly cover the compressed data
+    std::vector<Frame> frames;
+    frames.reserve(num_frames);
+    uint64_t uncompressed_offset = 0;
+    size_t compressed_offset = 0;
+    auto const* entry = header + seekable::cSkippableFrameHeaderSize;
+    for (uint32_t i = 0; i < num_frames; ++i) {
+        auto const compressed_size = read_numeric_value<uint32_t>(entry);
+        auto const uncompressed_size = read_numeric_value<uint32_t>(entry + sizeof(uint32_t));
+        entry += entry_size;
+
+        frames.push_back(
+                {uncompressed_offset, uncompressed_size, compressed_offset, compressed_size}
+        );
+        uncompressed_offset += uncompressed_size;
+        compressed_offset += compressed_size;
+    }
+    if (frames.empty() || compressed_frames_size != compressed_offset) {
+        return false;
+    }
+
+    m_frames = std::move(frames);
+    m_open_frame_ix = cNoOpenFrame;
+    return true;
+}
+
+ErrorCode Segment::try_read_frames(
+        uint64_t decompressed_stream_pos,
+        char* extraction_buf,
+        uint64_t extraction_len
+) {
+    // Find the frame containing the start of the content
+    auto frame_it = std::upper_bound(
+            m_frames.cbegin(),
+            m_frames.cend(),
+            decompressed_stream_pos,
+            [](uint64_t pos, Frame const& frame) { return pos < frame.uncompressed_offset; }
+    );
+    if (m_frames.cbegin() == frame_it) {
+        return ErrorCode_Truncated;
+    }
+    --frame_it;
+
+    while (extraction_len > 0) {
+        if (m_frames.cend() == frame_it) {
+            return ErrorCode_Truncated;
+        }
+        auto const& frame = *frame_it;
+        auto const frame_ix = static_cast<size_t>(frame_it - m_frames.cbegin());
+        auto const pos_in_frame = decompressed_stream_pos - frame.uncompressed_offset;
+        if (pos_in_frame >= frame.uncompressed_size) {
+            return ErrorCode_Truncated;
+        }
+
+        if (frame_ix != m_open_frame_ix) {
+            m_decompressor.close();
+            m_decompressor.open(
+                    m_memory_mapped_segment_file.data() + frame.compressed_offset,
+                    frame.compressed_size
+            );
+            m_open_frame_ix = frame_ix;
+        }
+
+        auto const num_bytes_to_read
+                = std::min(extraction_len, frame.uncompressed_size - pos_in_frame);
+        auto const error_code = m_decompressor.get_decompressed_stream_region(
+                pos_in_frame,
+                extraction_buf,
+                num_bytes_to_read
+        );
+        if (ErrorCode_Success != error_code) {
+            return error_code;
+        }
+
+        decompressed_stream_pos += num_bytes_to_read;
+        extraction_buf += num_bytes_to_read;
+        extraction_len -= num_bytes_to_read;
+        ++frame_it;
+    }
+    return ErrorCode_Success;
+}
 }  // namespace clp::streaming_archive::reader
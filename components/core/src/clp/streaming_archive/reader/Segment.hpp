@@ -1,8 +1,11 @@
 #ifndef CLP_STREAMING_ARCHIVE_READER_SEGMENT_HPP
 #define CLP_STREAMING_ARCHIVE_READER_SEGMENT_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/iostreams/device/mapped_file.hpp>
 
@@ -16,11 +19,14 @@ namespace clp::streaming_archive::reader {
 /**
  * Class for reading segments. A segment is a container for multiple compressed buffers that
  * itself may be further compressed and stored on disk.
+ *
+ * If the segment ends with a seek table, reads only decompress the frames that overlap the
+ * requested content; otherwise, the segment is decompressed as a single stream.
  */
 class Segment {
 public:
     // Constructor
-    Segment() : m_segment_path({}) {};
+    Segment() : m_segment_path({}), m_open_frame_ix(cNoOpenFrame) {}
 
     // Destructor
     ~Segment();
@@ -52,6 +58,38 @@ public:
     try_read(uint64_t decompressed_stream_pos, char* extraction_buf, uint64_t extraction_len);
 
 private:
+    // Types
+    struct Frame {
+        uint64_t uncompressed_offset;
+        uint64_t uncompressed_size;
+        size_t compressed_offset;
+        size_t compressed_size;
+    };
+
+    // Constants
+    static constexpr size_t cNoOpenFrame = SIZE_MAX;
+
+    // Methods
+    /**
+     * Loads the frames listed in the seek table at the end of the memory-mapped segment, if any
+     * @return Whether the segment contains a valid seek table
+     */
+    bool load_seek_table();
+
+    /**
+     * Reads content from the segment's frames
+     * @param decompressed_stream_pos
+     * @param extraction_buf
+     * @param extraction_len
+     * @return Same as try_read
+     */
+    ErrorCode try_read_frames(
+            uint64_t decompressed_stream_pos,
+            char* extraction_buf,
+            uint64_t extraction_len
+    );
+
+    // Variables
     std::string m_segment_path;
     boost::iostreams::mapped_file_source m_memory_mapped_segment_file;
 
@@ -62,6 +100,8 @@ private:
 #else
     static_assert(false, "Unsupported compression mode.");
 #endif
+    std::vector<Frame> m_frames;
+    size_t m_open_frame_ix;
 };
 }  // namespace clp::streaming_archive::reader
 
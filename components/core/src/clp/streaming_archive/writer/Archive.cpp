@@ -119,6 +119,7 @@ void Archive::open(UserConfig const& user_config) {
     m_metadata_db.open(metadata_db_path.string());
 
     m_target_segment_uncompressed_size = user_config.target_segment_uncompressed_size;
+    m_segment_frame_size = user_config.segment_frame_size;
     m_next_segment_id = 0;
     m_compression_level = user_config.compression_level;
 
@@ -156,10 +157,14 @@ void Archive::open(UserConfig const& user_config) {
     }
 
     m_global_metadata_db = user_config.global_metadata_db;
+    m_global_metadata_db_mutex = user_config.global_metadata_db_mutex;
 
-    m_global_metadata_db->open();
-    m_global_metadata_db->add_archive(m_id_as_string, *m_local_metadata);
-    m_global_metadata_db->close();
+    {
+        auto lock = lock_global_metadata_db();
+        m_global_metadata_db->open();
+        m_global_metadata_db->add_archive(m_id_as_string, *m_local_metadata);
+        m_global_metadata_db->close();
+    }
 
     m_file = nullptr;
 
@@ -239,6 +244,7 @@ void Archive::close() {
     m_metadata_file_writer.close();
 
     m_global_metadata_db = nullptr;
+    m_global_metadata_db_mutex = nullptr;
 
     m_metadata_db.close();
 
@@ -494,7 +500,12 @@ void Archive::append_file_contents_to_segment(
         vector<File*>& files_in_segment
 ) {
     if (!segment.is_open()) {
-        segment.open(m_segments_dir_path, m_next_segment_id++, m_compression_level);
+        segment.open(
+                m_segments_dir_path,
+                m_next_segment_id++,
+                m_compression_level,
+                m_segment_frame_size
+        );
     }
 
     m_file->append_to_segment(m_logtype_dict, segment);
@@ -598,10 +609,13 @@ void Archive::close_segment_and_persist_file_metadata(
         file->mark_as_in_committed_segment();
     }
 
-    m_global_metadata_db->open();
-    persist_file_metadata(files);
-    update_metadata();
-    m_global_metadata_db->close();
+    {
+        auto lock = lock_global_metadata_db();
+        m_global_metadata_db->open();
+        persist_file_metadata(files);
+        update_metadata();
+        m_global_metadata_db->close();
+    }
 
     for (auto file : files) {
         delete file;
@@ -631,6 +645,13 @@ uint64_t Archive::get_dynamic_compressed_size() {
     return on_disk_size;
 }
 
+std::unique_lock<std::mutex> Archive::lock_global_metadata_db() {
+    if (nullptr == m_global_metadata_db_mutex) {
+        return {};
+    }
+    return std::unique_lock<std::mutex>{*m_global_metadata_db_mutex};
+}
+
 void Archive::update_metadata() {
     m_local_metadata->set_dynamic_uncompressed_size(0);
     m_local_metadata->set_dynamic_compressed_size(get_dynamic_compressed_size());
@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -33,6 +34,8 @@ public:
      * @param creator_id
      * @param creation_num
      * @param target_segment_uncompressed_size
+     * @param segment_frame_size Uncompressed size of each independently compressed frame in a
+     * segment, or 0 to compress each segment as a single frame
      * @param compression_level Compression level of the compressor being opened
      * @param output_dir Output directory
      * @param global_metadata_db
@@ -44,9 +47,13 @@ public:
         boost::uuids::uuid creator_id;
         size_t creation_num;
         size_t target_segment_uncompressed_size;
+        size_t segment_frame_size{0};
         int compression_level;
         std::string output_dir;
         GlobalMetadataDB* global_metadata_db;
+        // Serializes access to the global metadata DB when it's shared by concurrently written
+        // archives
+        std::mutex* global_metadata_db_mutex{nullptr};
         bool print_archive_stats_progress;
     };
 
@@ -278,6 +285,11 @@ private:
      * Updates the archive's metadata
      */
     void update_metadata();
+    /**
+     * Locks the global metadata DB if it's shared with other archives
+     * @return The lock, which doesn't own a mutex if the DB isn't shared
+     */
+    std::unique_lock<std::mutex> lock_global_metadata_db();
 
     // Variables
     boost::uuids::uuid m_id;
@@ -317,6 +329,7 @@ private:
     std::vector<File*> m_files_without_timestamps_in_segment;
 
     size_t m_target_segment_uncompressed_size;
+    size_t m_segment_frame_size;
     Segment m_segment_for_files_with_timestamps;
     ArrayBackedPosIntSet<logtype_dictionary_id_t>
             m_logtype_ids_in_segment_for_files_with_timestamps;
@@ -339,6 +352,7 @@ private:
     FileWriter m_metadata_file_writer;
 
     GlobalMetadataDB* m_global_metadata_db;
+    std::mutex* m_global_metadata_db_mutex{nullptr};
 
     bool m_print_archive_stats_progress;
 };
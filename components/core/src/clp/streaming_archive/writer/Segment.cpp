@@ -2,13 +2,16 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <climits>
 #include <cmath>
 #include <cstring>
+#include <limits>
 
 #include "../../ErrorCode.hpp"
 #include "../../FileWriter.hpp"
 #include "../../spdlog_with_specializations.hpp"
+#include "../../streaming_compression/zstd/Constants.hpp"
 
 using std::make_unique;
 using std::string;
@@ -26,7 +29,12 @@ Segment::~Segment() {
     }
 }
 
-void Segment::open(string const& segments_dir_path, segment_id_t id, int compression_level) {
+void Segment::open(
+        string const& segments_dir_path,
+        segment_id_t id,
+        int compression_level,
+        size_t frame_size
+) {
     if (!m_segment_path.empty()) {
         throw OperationFailed(ErrorCode_NotInit, __FILENAME__, __LINE__);
     }
@@ -40,11 +48,19 @@ void Segment::open(string const& segments_dir_path, segment_id_t id, int compres
     m_offset = 0;
     m_compressed_size = 0;
 
+    m_frame_begin_offset = 0;
+    m_frame_begin_compressed_pos = 0;
+    m_frame_sizes.clear();
+
     m_file_writer.open(m_segment_path, FileWriter::OpenMode::CREATE_FOR_WRITING);
 #if USE_PASSTHROUGH_COMPRESSION
     m_compressor.open(m_file_writer);
+    // Uncompressed segments can already be read from any offset
+    m_frame_size = 0;
 #elif USE_ZSTD_COMPRESSION
     m_compressor.open(m_file_writer, compression_level);
+    // The seek table stores each frame's sizes as 32-bit integers
+    m_frame_size = std::min<size_t>(frame_size, std::numeric_limits<uint32_t>::max() / 2);
 #else
     static_assert(false, "Unsupported compression mode.");
 #endif
@@ -52,6 +68,15 @@ void Segment::open(string const& segments_dir_path, segment_id_t id, int compres
 
 void Segment::close() {
     m_compressor.close();
+    if (m_frame_size > 0) {
+        if (m_offset > m_frame_begin_offset) {
+            m_frame_sizes.push_back(
+                    {static_cast<uint32_t>(m_file_writer.get_pos() - m_frame_begin_compressed_pos),
+                     static_cast<uint32_t>(m_offset - m_frame_begin_offset)}
+            );
+        }
+        write_seek_table();
+    }
     m_compressed_size = m_file_writer.get_pos();
 
     m_file_writer.flush();
@@ -62,12 +87,59 @@ void Segment::close() {
 }
 
 void Segment::append(char const* buf, uint64_t const buf_len, uint64_t& offset) {
-    // Compress
-    m_compressor.write(buf, buf_len);
-
     // Return offset and update it
     offset = m_offset;
-    m_offset += buf_len;
+
+    if (0 == m_frame_size) {
+        m_compressor.write(buf, buf_len);
+        m_offset += buf_len;
+        return;
+    }
+
+    // Split the buffer at frame boundaries
+    uint64_t num_bytes_appended = 0;
+    while (num_bytes_appended < buf_len) {
+        auto const num_bytes_to_append = std::min(
+                buf_len - num_bytes_appended,
+                m_frame_begin_offset + m_frame_size - m_offset
+        );
+        m_compressor.write(buf + num_bytes_appended, num_bytes_to_append);
+        num_bytes_appended += num_bytes_to_append;
+        m_offset += num_bytes_to_append;
+
+        if (m_offset - m_frame_begin_offset == m_frame_size) {
+            end_frame();
+        }
+    }
+}
+
+void Segment::end_frame() {
+    // Flushing the compressor ends the current zstd frame, so the next write starts a new one
+    m_compressor.flush();
+    auto const compressed_pos = m_file_writer.get_pos();
+    m_frame_sizes.push_back(
+            {static_cast<uint32_t>(compressed_pos - m_frame_begin_compressed_pos),
+             static_cast<uint32_t>(m_offset - m_frame_begin_offset)}
+    );
+    m_frame_begin_offset = m_offset;
+    m_frame_begin_compressed_pos = compressed_pos;
+}
+
+void Segment::write_seek_table() {
+    namespace seekable = streaming_compression::zstd::seekable;
+
+    auto const seek_table_size = m_frame_sizes.size() * seekable::cSeekTableEntrySize
+                                 + seekable::cSeekTableFooterSize;
+    m_file_writer.write_numeric_value(seekable::cSkippableFrameMagicNumber);
+    m_file_writer.write_numeric_value(static_cast<uint32_t>(seek_table_size));
+    for (auto const& frame_size : m_frame_sizes) {
+        m_file_writer.write_numeric_value(frame_size.compressed_size);
+        m_file_writer.write_numeric_value(frame_size.uncompressed_size);
+    }
+    m_file_writer.write_numeric_value(static_cast<uint32_t>(m_frame_sizes.size()));
+    // Descriptor without per-frame checksums
+    m_file_writer.write_numeric_value(static_cast<uint8_t>(0));
+    m_file_writer.write_numeric_value(seekable::cSeekTableMagicNumber);
 }
 
 uint64_t Segment::get_uncompressed_size() {
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "../../Defs.h"
 #include "../../ErrorCode.hpp"
@@ -15,6 +16,10 @@ namespace clp::streaming_archive::writer {
 /**
  * Class for writing segments. A segment is a container for multiple compressed buffers that
  * itself may be further compressed and then stored on disk.
+ *
+ * When compressed with zstd, a segment can be split into independently compressed frames of a
+ * fixed uncompressed size, followed by a seek table in the zstd seekable format. This allows
+ * readers to decompress only the frames containing the content they need.
  */
 class Segment {
 public:
@@ -32,7 +37,7 @@ public:
     };
 
     // Constructors
-    Segment() : m_id(cInvalidSegmentId), m_offset(0) {}
+    Segment() : m_id(cInvalidSegmentId), m_offset(0), m_frame_size(0), m_frame_begin_offset(0) {}
 
     // Destructor
     ~Segment();
@@ -43,10 +48,17 @@ public:
      * @param segments_dir_path
      * @param id
      * @param compression_level
+     * @param frame_size Uncompressed size of each independently compressed frame, or 0 to
+     * compress the segment as a single frame
      * @throw streaming_archive::writer::Segment::OperationFailed if segment wasn't closed
      * before this call
      */
-    void open(std::string const& segments_dir_path, segment_id_t id, int compression_level);
+    void open(
+            std::string const& segments_dir_path,
+            segment_id_t id,
+            int compression_level,
+            size_t frame_size
+    );
     /**
      * Closes the segment
      * @throw streaming_archive::writer::Segment::OperationFailed if compression fails
@@ -78,6 +90,24 @@ public:
     size_t get_compressed_size();
 
 private:
+    // Types
+    struct FrameSize {
+        uint32_t compressed_size;
+        uint32_t uncompressed_size;
+    };
+
+    // Methods
+    /**
+     * Ends the current frame and records its size in the seek table
+     * @throw streaming_archive::writer::Segment::OperationFailed if compression fails
+     */
+    void end_frame();
+    /**
+     * Writes the seek table as a skippable frame at the end of the segment
+     * @throw FileWriter::OperationFailed on write failure
+     */
+    void write_seek_table();
+
     // Variables
     std::string m_segment_path;
     segment_id_t m_id;
@@ -85,6 +115,11 @@ private:
     uint64_t m_offset;  // total input bytes processed
     uint64_t m_compressed_size;
 
+    size_t m_frame_size;
+    uint64_t m_frame_begin_offset;
+    size_t m_frame_begin_compressed_pos;
+    std::vector<FrameSize> m_frame_sizes;
+
     FileWriter m_file_writer;
 #if USE_PASSTHROUGH_COMPRESSION
     streaming_compression::passthrough::Compressor m_compressor;
@@ -6,6 +6,23 @@
 
 namespace clp::streaming_compression::zstd {
 constexpr int cDefaultCompressionLevel = 3;
+
+// Constants of the zstd seekable format, in which a stream of independently compressed frames is
+// followed by a seek table stored in a skippable frame
+namespace seekable {
+constexpr uint32_t cSkippableFrameMagicNumber = 0x184D'2A5E;
+// Skippable frames may use any magic number that matches this mask
+constexpr uint32_t cSkippableFrameMagicNumberMask = 0xFFFF'FFF0;
+constexpr uint32_t cSeekTableMagicNumber = 0x8F92'EAB1;
+constexpr size_t cSkippableFrameHeaderSize = 2 * sizeof(uint32_t);
+// Number of frames, descriptor, and magic number
+constexpr size_t cSeekTableFooterSize = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t);
+// Compressed and decompressed size of each frame
+constexpr size_t cSeekTableEntrySize = 2 * sizeof(uint32_t);
+// Size of an entry's optional checksum, indicated by the descriptor
+constexpr size_t cSeekTableEntryChecksumSize = sizeof(uint32_t);
+constexpr uint8_t cSeekTableDescriptorChecksumFlag = 1U << 7;
+}  // namespace seekable
 }  // namespace clp::streaming_compression::zstd
 
 #endif  // CLP_STREAMING_COMPRESSION_ZSTD_CONSTANTS_HPP
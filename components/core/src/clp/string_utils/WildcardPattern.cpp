@@ -0,0 +1,104 @@
+#include "string_utils/WildcardPattern.hpp"
+
+#include <string>
+#include <string_view>
+
+#include "string_utils/string_utils.hpp"
+
+using std::string;
+using std::string_view;
+
+namespace clp::string_utils {
+WildcardPattern::WildcardPattern(string_view wildcard_string, bool case_sensitive_match)
+        : m_wildcard_string{wildcard_string},
+          m_case_sensitive_match{case_sensitive_match} {
+    if (false == m_case_sensitive_match) {
+        to_lower(m_wildcard_string);
+    }
+    m_matches_all = "*" == m_wildcard_string;
+
+    // Split the pattern into literals delimited by unescaped wildcards
+    string literal;
+    bool is_prefix = true;
+    auto const wildcard_string_end = m_wildcard_string.cend();
+    for (auto it = m_wildcard_string.cbegin(); wildcard_string_end != it; ++it) {
+        auto c = *it;
+        if ('*' == c || '?' == c) {
+            m_contains_wildcards = true;
+            if ('*' == c) {
+                m_contains_star = true;
+            } else {
+                ++m_min_tame_length;
+            }
+
+            if (is_prefix) {
+                m_prefix = literal;
+                is_prefix = false;
+            }
+            if (literal.length() > m_longest_literal.length()) {
+                m_longest_literal = literal;
+            }
+            literal.clear();
+            continue;
+        }
+
+        if ('\\' == c) {
+            ++it;
+            if (wildcard_string_end == it) {
+                // The caller should've removed the dangling escape character
+                break;
+            }
+            c = *it;
+        }
+        literal += c;
+        ++m_min_tame_length;
+    }
+    if (is_prefix) {
+        m_prefix = literal;
+    } else {
+        m_suffix = literal;
+    }
+    if (literal.length() > m_longest_literal.length()) {
+        m_longest_literal = literal;
+    }
+}
+
+bool WildcardPattern::matches(string_view tame) const {
+    if (m_case_sensitive_match || m_matches_all) {
+        return matches_case_folded(tame);
+    }
+    // Avoid lowercasing strings which can't match
+    if (false == is_possible_match_length(tame.length())) {
+        return false;
+    }
+    string lowercase_tame{tame};
+    to_lower(lowercase_tame);
+    return matches_case_folded(lowercase_tame);
+}
+
+bool WildcardPattern::matches_case_folded(string_view tame) const {
+    if (m_matches_all) {
+        return true;
+    }
+    if (false == is_possible_match_length(tame.length())) {
+        return false;
+    }
+    if (false == m_contains_wildcards) {
+        return tame == m_prefix;
+    }
+
+    if (false == tame.starts_with(m_prefix) || false == tame.ends_with(m_suffix)) {
+        return false;
+    }
+    // NOTE: string_view::find uses memchr to skip to each occurrence of the literal's first
+    // character
+    if (m_longest_literal.length() > m_prefix.length()
+        && m_longest_literal.length() > m_suffix.length()
+        && string_view::npos == tame.find(m_longest_literal))
+    {
+        return false;
+    }
+
+    return wildcard_match_unsafe_case_sensitive(tame, m_wildcard_string);
+}
+}  // namespace clp::string_utils
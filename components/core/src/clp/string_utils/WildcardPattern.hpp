@@ -0,0 +1,79 @@
+#ifndef CLP_STRING_UTILS_WILDCARDPATTERN_HPP
+#define CLP_STRING_UTILS_WILDCARDPATTERN_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace clp::string_utils {
+/**
+ * A wildcard string compiled for matching against many strings. It supports the same syntax and
+ * has the same requirements as ``wildcard_match_unsafe``, but the wildcard string is only parsed
+ * and case-folded once.
+ * <br/>
+ * Before running the full match, the pattern rejects strings that are too short, that don't start
+ * or end with the pattern's literal prefix or suffix, or that don't contain the pattern's longest
+ * literal. The latter is found with a memchr-based substring search, so most non-matching strings
+ * are rejected without running the backtracking matcher.
+ */
+class WildcardPattern {
+public:
+    // Constructors
+    /**
+     * @param wildcard_string A wildcard string cleaned up as required by
+     * ``wildcard_match_unsafe_case_sensitive``
+     * @param case_sensitive_match Whether to consider case when matching
+     */
+    WildcardPattern(std::string_view wildcard_string, bool case_sensitive_match);
+
+    // Methods
+    /**
+     * @param tame
+     * @return Whether the given string matches the pattern
+     */
+    [[nodiscard]] bool matches(std::string_view tame) const;
+
+    /**
+     * Matches a string that the caller already lowercased if the match is case-insensitive. This
+     * lets callers testing many patterns against the same string lowercase it only once.
+     * @param tame
+     * @return Whether the given string matches the pattern
+     */
+    [[nodiscard]] bool matches_case_folded(std::string_view tame) const;
+
+    /**
+     * @return The wildcard string, lowercased if the match is case-insensitive
+     */
+    [[nodiscard]] std::string const& get_wildcard_string() const { return m_wildcard_string; }
+
+    [[nodiscard]] bool is_case_sensitive_match() const { return m_case_sensitive_match; }
+
+private:
+    // Methods
+    /**
+     * @param tame_length
+     * @return Whether a string of the given length can match the pattern
+     */
+    [[nodiscard]] bool is_possible_match_length(size_t tame_length) const {
+        return tame_length >= m_min_tame_length
+               && (m_contains_star || tame_length == m_min_tame_length);
+    }
+
+    // Variables
+    std::string m_wildcard_string;
+    bool m_case_sensitive_match;
+
+    bool m_matches_all{false};
+    bool m_contains_wildcards{false};
+    bool m_contains_star{false};
+    // Minimum length of a matching string (i.e., the number of characters not matched by a '*')
+    size_t m_min_tame_length{0};
+    // Unescaped literals at the start and end of the pattern, and the longest literal anywhere in
+    // the pattern
+    std::string m_prefix;
+    std::string m_suffix;
+    std::string m_longest_literal;
+};
+}  // namespace clp::string_utils
+
+#endif  // CLP_STRING_UTILS_WILDCARDPATTERN_HPP
@@ -1,8 +1,12 @@
 #include "ArchiveReader.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <string_view>
 
+#include <spdlog/spdlog.h>
+
 #include "archive_constants.hpp"
 #include "ReaderUtils.hpp"
 
@@ -27,11 +31,38 @@ void ArchiveReader::open(string_view archives_dir, string_view archive_id) {
     m_schema_tree = ReaderUtils::read_schema_tree(archive_path_str);
     m_schema_map = ReaderUtils::read_schemas(archive_path_str);
 
-    m_tables_file_reader.open(archive_path_str + constants::cArchiveTablesFile);
+    auto const tables_path = archive_path_str + constants::cArchiveTablesFile;
+    boost::system::error_code boost_error_code;
+    auto const tables_file_size = boost::filesystem::file_size(tables_path, boost_error_code);
+    if (boost_error_code) {
+        SPDLOG_ERROR(
+                "Unable to obtain file size for '{}' - {}.",
+                tables_path,
+                boost_error_code.message()
+        );
+        throw OperationFailed(ErrorCodeFileNotFound, __FILENAME__, __LINE__);
+    }
+    // Empty files can't be mapped, but an archive without any tables has nothing to read anyway
+    if (tables_file_size > 0) {
+        boost::iostreams::mapped_file_params memory_map_params;
+        memory_map_params.path = tables_path;
+        memory_map_params.flags = boost::iostreams::mapped_file::readonly;
+        memory_map_params.length = tables_file_size;
+        m_tables_file.open(memory_map_params);
+        if (false == m_tables_file.is_open()) {
+            SPDLOG_ERROR("Unable to memory map the tables file with path: {}", tables_path);
+            throw OperationFailed(ErrorCodeFailure, __FILENAME__, __LINE__);
+        }
+    }
     m_table_metadata_file_reader.open(archive_path_str + constants::cArchiveTableMetadataFile);
 }
 
 void ArchiveReader::read_metadata() {
+    if (m_has_read_metadata) {
+        return;
+    }
+    m_has_read_metadata = true;
+
     constexpr size_t cDecompressorFileReadBufferCapacity = 64 * 1024;  // 64 KB
     m_table_metadata_decompressor.open(
             m_table_metadata_file_reader,
@@ -48,8 +79,7 @@ void ArchiveReader::read_metadata() {
     for (size_t i = 0; i < num_schemas; i++) {
         int32_t schema_id;
         uint64_t num_messages;
-        size_t table_offset;
-        size_t uncompressed_size;
+        size_t num_row_groups;
 
         if (auto error = m_table_metadata_decompressor.try_read_numeric_value(schema_id);
             ErrorCodeSuccess != error)
@@ -63,19 +93,78 @@ void ArchiveReader::read_metadata() {
             throw OperationFailed(error, __FILENAME__, __LINE__);
         }
 
-        if (auto error = m_table_metadata_decompressor.try_read_numeric_value(table_offset);
+        if (auto error = m_table_metadata_decompressor.try_read_numeric_value(num_row_groups);
             ErrorCodeSuccess != error)
         {
             throw OperationFailed(error, __FILENAME__, __LINE__);
         }
 
-        if (auto error = m_table_metadata_decompressor.try_read_numeric_value(uncompressed_size);
-            ErrorCodeSuccess != error)
-        {
-            throw OperationFailed(error, __FILENAME__, __LINE__);
+        auto& table_metadata = m_id_to_table_metadata[schema_id];
+        table_metadata.num_messages = num_messages;
+        table_metadata.row_groups.resize(num_row_groups);
+        for (auto& row_group : table_metadata.row_groups) {
+            if (auto error
+                = m_table_metadata_decompressor.try_read_numeric_value(row_group.num_messages);
+                ErrorCodeSuccess != error)
+            {
+                throw OperationFailed(error, __FILENAME__, __LINE__);
+            }
+
+            if (auto error = m_table_metadata_decompressor.try_read_numeric_value(row_group.offset);
+                ErrorCodeSuccess != error)
+            {
+                throw OperationFailed(error, __FILENAME__, __LINE__);
+            }
+
+            if (auto error = m_table_metadata_decompressor.try_read_numeric_value(
+                        row_group.uncompressed_size
+                );
+                ErrorCodeSuccess != error)
+            {
+                throw OperationFailed(error, __FILENAME__, __LINE__);
+            }
+
+            size_t num_statistics;
+            if (auto error = m_table_metadata_decompressor.try_read_numeric_value(num_statistics);
+                ErrorCodeSuccess != error)
+            {
+                throw OperationFailed(error, __FILENAME__, __LINE__);
+            }
+            row_group.statistics.reserve(num_statistics);
+            for (size_t j = 0; j < num_statistics; ++j) {
+                row_group.statistics.push_back(
+                        ColumnStatistics::read(m_table_metadata_decompressor)
+                );
+            }
+
+            size_t num_column_chunks;
+            if (auto error
+                = m_table_metadata_decompressor.try_read_numeric_value(num_column_chunks);
+                ErrorCodeSuccess != error)
+            {
+                throw OperationFailed(error, __FILENAME__, __LINE__);
+            }
+            row_group.column_chunks.resize(num_column_chunks);
+            size_t column_chunk_offset = row_group.offset;
+            for (auto& column_chunk : row_group.column_chunks) {
+                if (auto error = m_table_metadata_decompressor.try_read_numeric_value(
+                            column_chunk.compressed_size
+                    );
+                    ErrorCodeSuccess != error)
+                {
+                    throw OperationFailed(error, __FILENAME__, __LINE__);
+                }
+                if (auto error = m_table_metadata_decompressor.try_read_numeric_value(
+                            column_chunk.uncompressed_size
+                    );
+                    ErrorCodeSuccess != error)
+                {
+                    throw OperationFailed(error, __FILENAME__, __LINE__);
+                }
+                column_chunk.offset = column_chunk_offset;
+                column_chunk_offset += column_chunk.compressed_size;
+            }
         }
-
-        m_id_to_table_metadata[schema_id] = {num_messages, table_offset, uncompressed_size};
         m_schema_ids.push_back(schema_id);
     }
     m_table_metadata_decompressor.close();
@@ -89,54 +178,170 @@ void ArchiveReader::read_dictionaries_and_metadata() {
     read_metadata();
 }
 
-SchemaReader& ArchiveReader::read_table(
+SchemaReader::TableMetadata const& ArchiveReader::get_table_metadata(int32_t schema_id) const {
+    auto it = m_id_to_table_metadata.find(schema_id);
+    if (m_id_to_table_metadata.end() == it) {
+        throw OperationFailed(ErrorCodeFileNotFound, __FILENAME__, __LINE__);
+    }
+    return it->second;
+}
+
+SchemaReader& ArchiveReader::read_row_group(
         int32_t schema_id,
+        size_t row_group,
         bool should_extract_timestamp,
-        bool should_marshal_records
+        bool should_marshal_records,
+        std::unordered_set<int32_t> const* searched_columns
 ) {
-    constexpr size_t cDecompressorFileReadBufferCapacity = 64 * 1024;  // 64 KB
-
-    if (m_id_to_table_metadata.count(schema_id) == 0) {
-        throw OperationFailed(ErrorCodeFileNotFound, __FILENAME__, __LINE__);
+    auto const& table_metadata = get_table_metadata(schema_id);
+    if (row_group >= table_metadata.row_groups.size()) {
+        throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
     }
 
-    initialize_schema_reader(
+    load_row_group(
             m_schema_reader,
             schema_id,
+            table_metadata.row_groups[row_group],
             should_extract_timestamp,
-            should_marshal_records
+            should_marshal_records,
+            searched_columns
     );
+    return m_schema_reader;
+}
+
+void ArchiveReader::read_row_group(
+        SchemaReader& reader,
+        int32_t schema_id,
+        size_t row_group,
+        bool should_extract_timestamp,
+        bool should_marshal_records,
+        std::unordered_set<int32_t> const* searched_columns
+) const {
+    auto const& table_metadata = get_table_metadata(schema_id);
+    if (row_group >= table_metadata.row_groups.size()) {
+        throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
+    }
 
-    m_tables_file_reader.try_seek_from_begin(m_id_to_table_metadata[schema_id].offset);
-    m_tables_decompressor.open(m_tables_file_reader, cDecompressorFileReadBufferCapacity);
-    m_schema_reader.load(
-            m_tables_decompressor,
-            m_id_to_table_metadata[schema_id].uncompressed_size
+    load_row_group(
+            reader,
+            schema_id,
+            table_metadata.row_groups[row_group],
+            should_extract_timestamp,
+            should_marshal_records,
+            searched_columns
     );
-    m_tables_decompressor.close_for_reuse();
-    return m_schema_reader;
 }
 
-std::vector<std::shared_ptr<SchemaReader>> ArchiveReader::read_all_tables() {
-    constexpr size_t cDecompressorFileReadBufferCapacity = 64 * 1024;  // 64 KB
+void ArchiveReader::load_row_group(
+        SchemaReader& reader,
+        int32_t schema_id,
+        SchemaReader::RowGroupMetadata const& row_group_metadata,
+        bool should_extract_timestamp,
+        bool should_marshal_records,
+        std::unordered_set<int32_t> const* searched_columns
+) const {
+    initialize_schema_reader(
+            reader,
+            schema_id,
+            row_group_metadata.num_messages,
+            should_extract_timestamp,
+            should_marshal_records,
+            searched_columns
+    );
+    reader.load(get_tables_file(), row_group_metadata.column_chunks);
+}
 
-    std::vector<std::shared_ptr<SchemaReader>> readers;
-    readers.reserve(m_id_to_table_metadata.size());
-    for (auto const& [id, table_metadata] : m_id_to_table_metadata) {
-        auto schema_reader = std::make_shared<SchemaReader>();
-        initialize_schema_reader(*schema_reader, id, true, true);
+int32_t ArchiveReader::get_timestamp_column_id(int32_t schema_id) const {
+    // Like initialize_schema_reader, take messages' timestamps from the last authoritative
+    // timestamp column in the ordered part of their schema
+    auto const& timestamp_column_ids = m_timestamp_dict->get_authoritative_timestamp_column_ids();
+    int32_t timestamp_column_id{-1};
+    for (int32_t column_id : m_schema_map->at(schema_id).get_ordered_schema_view()) {
+        if (timestamp_column_ids.contains(column_id)) {
+            timestamp_column_id = column_id;
+        }
+    }
+    return timestamp_column_id;
+}
 
-        m_tables_file_reader.try_seek_from_begin(table_metadata.offset);
-        m_tables_decompressor.open(m_tables_file_reader, cDecompressorFileReadBufferCapacity);
-        schema_reader->load(m_tables_decompressor, table_metadata.uncompressed_size);
-        m_tables_decompressor.close_for_reuse();
+std::optional<epochtime_t> ArchiveReader::get_row_group_begin_timestamp(
+        int32_t schema_id,
+        SchemaReader::RowGroupMetadata const& row_group_metadata
+) const {
+    auto const timestamp_column_id = get_timestamp_column_id(schema_id);
+    if (-1 == timestamp_column_id) {
+        // Messages without a timestamp are given a timestamp of 0
+        return 0;
+    }
 
-        readers.push_back(std::move(schema_reader));
+    std::optional<epochtime_t> begin_timestamp;
+    for (auto const& statistics : row_group_metadata.statistics) {
+        if (statistics.get_column_id() != timestamp_column_id) {
+            continue;
+        }
+        epochtime_t column_begin_timestamp;
+        if (ColumnStatistics::Type::IntegerRange == statistics.get_type()) {
+            column_begin_timestamp = statistics.get_int_min();
+        } else if (ColumnStatistics::Type::FloatRange == statistics.get_type()
+                   && statistics.get_float_min() > static_cast<double>(cEpochTimeMin))
+        {
+            column_begin_timestamp
+                    = static_cast<epochtime_t>(std::floor(statistics.get_float_min()));
+        } else {
+            return std::nullopt;
+        }
+        begin_timestamp = std::min(begin_timestamp.value_or(cEpochTimeMax), column_begin_timestamp);
     }
-    return readers;
+    return begin_timestamp;
 }
 
-BaseColumnReader* ArchiveReader::append_reader_column(SchemaReader& reader, int32_t column_id) {
+std::optional<epochtime_t> ArchiveReader::get_row_group_end_timestamp(
+        int32_t schema_id,
+        SchemaReader::RowGroupMetadata const& row_group_metadata
+) const {
+    auto const timestamp_column_id = get_timestamp_column_id(schema_id);
+    if (-1 == timestamp_column_id) {
+        // Messages without a timestamp are given a timestamp of 0
+        return 0;
+    }
+
+    std::optional<epochtime_t> end_timestamp;
+    for (auto const& statistics : row_group_metadata.statistics) {
+        if (statistics.get_column_id() != timestamp_column_id) {
+            continue;
+        }
+        epochtime_t column_end_timestamp;
+        if (ColumnStatistics::Type::IntegerRange == statistics.get_type()) {
+            column_end_timestamp = statistics.get_int_max();
+        } else if (ColumnStatistics::Type::FloatRange == statistics.get_type()
+                   && statistics.get_float_max() < static_cast<double>(cEpochTimeMax))
+        {
+            column_end_timestamp = static_cast<epochtime_t>(std::ceil(statistics.get_float_max()));
+        } else {
+            return std::nullopt;
+        }
+        end_timestamp = std::max(end_timestamp.value_or(cEpochTimeMin), column_end_timestamp);
+    }
+    return end_timestamp;
+}
+
+bool ArchiveReader::should_load_column(
+        int32_t column_id,
+        bool should_marshal_records,
+        std::unordered_set<int32_t> const* searched_columns
+) const {
+    if (nullptr == searched_columns || searched_columns->contains(column_id)) {
+        return true;
+    }
+    return should_marshal_records
+           && (nullptr == m_projection || m_projection->matches_node(column_id));
+}
+
+BaseColumnReader* ArchiveReader::append_reader_column(
+        SchemaReader& reader,
+        int32_t column_id,
+        bool should_load
+) const {
     BaseColumnReader* column_reader = nullptr;
     auto const& node = m_schema_tree->get_node(column_id);
     switch (node.get_type()) {
@@ -170,7 +375,7 @@ BaseColumnReader* ArchiveReader::append_reader_column(SchemaReader& reader, int3
     }
 
     if (column_reader) {
-        reader.append_column(column_reader);
+        reader.append_column(column_reader, should_load);
     }
     return column_reader;
 }
@@ -179,8 +384,13 @@ void ArchiveReader::append_unordered_reader_columns(
         SchemaReader& reader,
         int32_t mst_subtree_root_node_id,
         std::span<int32_t> schema_ids,
-        bool should_marshal_records
-) {
+        bool should_marshal_records,
+        std::unordered_set<int32_t> const* searched_columns
+) const {
+    // Unordered objects are marshalled as a whole, so they're projected if their root is
+    should_marshal_records = should_marshal_records
+                             && (nullptr == m_projection
+                                 || m_projection->matches_node(mst_subtree_root_node_id));
     size_t object_begin_pos = reader.get_column_size();
     for (int32_t column_id : schema_ids) {
         if (Schema::schema_entry_is_unordered_object(column_id)) {
@@ -217,7 +427,10 @@ void ArchiveReader::append_unordered_reader_columns(
         }
 
         if (column_reader) {
-            reader.append_unordered_column(column_reader);
+            reader.append_unordered_column(
+                    column_reader,
+                    should_load_column(column_id, should_marshal_records, searched_columns)
+            );
         }
     }
 
@@ -229,17 +442,28 @@ void ArchiveReader::append_unordered_reader_columns(
 void ArchiveReader::initialize_schema_reader(
         SchemaReader& reader,
         int32_t schema_id,
+        uint64_t num_messages,
         bool should_extract_timestamp,
-        bool should_marshal_records
-) {
-    auto& schema = (*m_schema_map)[schema_id];
+        bool should_marshal_records,
+        std::unordered_set<int32_t> const* searched_columns
+) const {
+    auto& schema = m_schema_map->at(schema_id);
     reader.reset(
             m_schema_tree,
             schema_id,
             schema.get_ordered_schema_view(),
-            m_id_to_table_metadata[schema_id].num_messages,
+            num_messages,
             should_marshal_records
     );
+    if (should_marshal_records && nullptr != m_projection) {
+        std::vector<int32_t> projected_schema;
+        for (int32_t column_id : schema.get_ordered_schema_view()) {
+            if (m_projection->matches_node(column_id)) {
+                projected_schema.push_back(column_id);
+            }
+        }
+        reader.set_projected_schema(std::move(projected_schema));
+    }
     auto timestamp_column_ids = m_timestamp_dict->get_authoritative_timestamp_column_ids();
     for (size_t i = 0; i < schema.size(); ++i) {
         int32_t column_id = schema[i];
@@ -256,7 +480,8 @@ void ArchiveReader::initialize_schema_reader(
                     reader,
                     mst_subtree_root_node_id,
                     sub_schema,
-                    should_marshal_records
+                    should_marshal_records,
+                    searched_columns
             );
             i += length;
             continue;
@@ -269,14 +494,21 @@ void ArchiveReader::initialize_schema_reader(
                     reader,
                     column_id,
                     std::span<int32_t>(),
-                    should_marshal_records
+                    should_marshal_records,
+                    searched_columns
             );
             continue;
         }
-        BaseColumnReader* column_reader = append_reader_column(reader, column_id);
-
-        if (should_extract_timestamp && column_reader && timestamp_column_ids.count(column_id) > 0)
-        {
+        bool const is_timestamp_column
+                = should_extract_timestamp && timestamp_column_ids.count(column_id) > 0;
+        BaseColumnReader* column_reader = append_reader_column(
+                reader,
+                column_id,
+                is_timestamp_column
+                        || should_load_column(column_id, should_marshal_records, searched_columns)
+        );
+
+        if (is_timestamp_column && column_reader) {
             reader.mark_column_as_timestamp(column_reader);
         }
     }
@@ -286,9 +518,11 @@ void ArchiveReader::store(FileWriter& writer) {
     std::string message;
 
     for (auto& [id, table_metadata] : m_id_to_table_metadata) {
-        auto& schema_reader = read_table(id, false, true);
-        while (schema_reader.get_next_message(message)) {
-            writer.write(message.c_str(), message.length());
+        for (size_t row_group = 0; row_group < table_metadata.row_groups.size(); ++row_group) {
+            auto& schema_reader = read_row_group(id, row_group, false, true);
+            while (schema_reader.get_next_message(message)) {
+                writer.write(message.c_str(), message.length());
+            }
         }
     }
 }
@@ -304,11 +538,15 @@ void ArchiveReader::close() {
     m_array_dict->close();
     m_timestamp_dict->close();
 
-    m_tables_file_reader.close();
+    if (m_tables_file.is_open()) {
+        m_tables_file.close();
+    }
     m_table_metadata_file_reader.close();
 
     m_id_to_table_metadata.clear();
     m_schema_ids.clear();
+    m_has_read_metadata = false;
+    m_projection.reset();
 }
 
 }  // namespace clp_s
@@ -2,16 +2,20 @@
 #define CLP_S_ARCHIVEREADER_HPP
 
 #include <map>
+#include <optional>
 #include <set>
 #include <span>
 #include <string_view>
+#include <unordered_set>
 #include <utility>
 
 #include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 
 #include "DictionaryReader.hpp"
 #include "ReaderUtils.hpp"
 #include "SchemaReader.hpp"
+#include "search/Projection.hpp"
 #include "TimestampDictionaryReader.hpp"
 #include "Utils.hpp"
 
@@ -71,7 +75,7 @@ public:
     }
 
     /**
-     * Reads the metadata from the archive.
+     * Reads the metadata from the archive if it hasn't already been read.
      */
     void read_metadata();
 
@@ -85,20 +89,80 @@ public:
     }
 
     /**
-     * Reads a table from the archive.
      * @param schema_id
+     * @return the metadata of the table for the given schema, including its row groups
+     */
+    SchemaReader::TableMetadata const& get_table_metadata(int32_t schema_id) const;
+
+    /**
+     * Sets the columns which should be marshalled into records by schema readers. Columns outside
+     * of the projection are only loaded if they're searched.
+     * @param projection A projection resolved against this archive's schema tree, or nullptr to
+     * marshal every column
+     */
+    void set_projection(std::shared_ptr<search::Projection> projection) {
+        m_projection = std::move(projection);
+    }
+
+    /**
+     * Reads a row group of a table from the archive.
+     * @param schema_id
+     * @param row_group the index of the row group within the table
      * @param should_extract_timestamp
      * @param should_marshal_records
+     * @param searched_columns The columns a query needs in addition to those being marshalled, or
+     * nullptr to load every column
      * @return the schema reader
      */
-    SchemaReader&
-    read_table(int32_t schema_id, bool should_extract_timestamp, bool should_marshal_records);
+    SchemaReader& read_row_group(
+            int32_t schema_id,
+            size_t row_group,
+            bool should_extract_timestamp,
+            bool should_marshal_records,
+            std::unordered_set<int32_t> const* searched_columns = nullptr
+    );
 
     /**
-     * Loads all of the tables in the archive and returns SchemaReaders for them.
-     * @return the schema readers for every table in the archive
+     * Reads a row group of a table from the archive into the given schema reader. Unlike the
+     * overload above, this only reads from the memory mapped tables file, so it can be called
+     * concurrently by multiple threads as long as each passes a different reader.
+     * @param reader
+     * @param schema_id
+     * @param row_group the index of the row group within the table
+     * @param should_extract_timestamp
+     * @param should_marshal_records
+     * @param searched_columns
      */
-    std::vector<std::shared_ptr<SchemaReader>> read_all_tables();
+    void read_row_group(
+            SchemaReader& reader,
+            int32_t schema_id,
+            size_t row_group,
+            bool should_extract_timestamp,
+            bool should_marshal_records,
+            std::unordered_set<int32_t> const* searched_columns = nullptr
+    ) const;
+
+    /**
+     * @param schema_id
+     * @param row_group_metadata
+     * @return the earliest timestamp of any message in a row group of the given schema, or
+     * std::nullopt if it can't be bounded using the row group's column statistics
+     */
+    std::optional<epochtime_t> get_row_group_begin_timestamp(
+            int32_t schema_id,
+            SchemaReader::RowGroupMetadata const& row_group_metadata
+    ) const;
+
+    /**
+     * @param schema_id
+     * @param row_group_metadata
+     * @return the latest timestamp of any message in a row group of the given schema, or
+     * std::nullopt if it can't be bounded using the row group's column statistics
+     */
+    std::optional<epochtime_t> get_row_group_end_timestamp(
+            int32_t schema_id,
+            SchemaReader::RowGroupMetadata const& row_group_metadata
+    ) const;
 
     std::string_view get_archive_id() { return m_archive_id; }
 
@@ -138,24 +202,77 @@ private:
      * Initializes a schema reader passed by reference to become a reader for a given schema.
      * @param reader
      * @param schema_id
+     * @param num_messages
      * @param should_extract_timestamp
      * @param should_marshal_records
+     * @param searched_columns
      */
     void initialize_schema_reader(
             SchemaReader& reader,
             int32_t schema_id,
+            uint64_t num_messages,
             bool should_extract_timestamp,
-            bool should_marshal_records
-    );
+            bool should_marshal_records,
+            std::unordered_set<int32_t> const* searched_columns
+    ) const;
+
+    /**
+     * Initializes a schema reader for a row group and loads the row group's messages into it.
+     * @param reader
+     * @param schema_id
+     * @param row_group_metadata
+     * @param should_extract_timestamp
+     * @param should_marshal_records
+     * @param searched_columns
+     */
+    void load_row_group(
+            SchemaReader& reader,
+            int32_t schema_id,
+            SchemaReader::RowGroupMetadata const& row_group_metadata,
+            bool should_extract_timestamp,
+            bool should_marshal_records,
+            std::unordered_set<int32_t> const* searched_columns
+    ) const;
+
+    /**
+     * @param schema_id
+     * @return the ID of the column messages of the given schema take their timestamp from, or -1
+     * if they don't have a timestamp
+     */
+    int32_t get_timestamp_column_id(int32_t schema_id) const;
+
+    /**
+     * @return the contents of the memory mapped tables file
+     */
+    std::span<char const> get_tables_file() const {
+        if (false == m_tables_file.is_open()) {
+            return {};
+        }
+        return {m_tables_file.data(), m_tables_file.size()};
+    }
+
+    /**
+     * @param column_id
+     * @param should_marshal_records
+     * @param searched_columns
+     * @return whether the given column's data needs to be decompressed
+     */
+    bool should_load_column(
+            int32_t column_id,
+            bool should_marshal_records,
+            std::unordered_set<int32_t> const* searched_columns
+    ) const;
 
     /**
      * Appends a column to the schema reader.
      * @param reader
      * @param column_id
+     * @param should_load
      * @return a pointer to the newly appended column reader or nullptr if no column reader was
      * created
      */
-    BaseColumnReader* append_reader_column(SchemaReader& reader, int32_t column_id);
+    BaseColumnReader*
+    append_reader_column(SchemaReader& reader, int32_t column_id, bool should_load) const;
 
     /**
      * Appends columns for the entire schema of an unordered object.
@@ -163,13 +280,15 @@ private:
      * @param mst_subtree_root_node_id
      * @param schema_ids
      * @param should_marshal_records
+     * @param searched_columns
      */
     void append_unordered_reader_columns(
             SchemaReader& reader,
             int32_t mst_subtree_root_node_id,
             std::span<int32_t> schema_ids,
-            bool should_marshal_records
-    );
+            bool should_marshal_records,
+            std::unordered_set<int32_t> const* searched_columns
+    ) const;
 
     bool m_is_open;
     std::string m_archive_id;
@@ -182,10 +301,11 @@ private:
     std::shared_ptr<ReaderUtils::SchemaMap> m_schema_map;
     std::vector<int32_t> m_schema_ids;
     std::map<int32_t, SchemaReader::TableMetadata> m_id_to_table_metadata;
+    bool m_has_read_metadata{false};
+    std::shared_ptr<search::Projection> m_projection;
 
-    FileReader m_tables_file_reader;
+    boost::iostreams::mapped_file_source m_tables_file;
     FileReader m_table_metadata_file_reader;
-    ZstdDecompressor m_tables_decompressor;
     ZstdDecompressor m_table_metadata_decompressor;
     SchemaReader m_schema_reader;
 };
@@ -0,0 +1,153 @@
+#include "ArchiveReaderCache.hpp"
+
+#include <iterator>
+
+namespace clp_s {
+std::shared_ptr<ArchiveReader> ArchiveReaderCache::get(std::string const& archive_id) {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (auto reader = wait_and_acquire(archive_id, lock); nullptr != reader) {
+            return reader;
+        }
+    }
+
+    // Archives are read without holding the lock so that other archives can still be looked up.
+    // The dictionaries are read eagerly (and not lazily) since later searches may need them to be
+    // fully decoded.
+    auto reader = std::make_shared<ArchiveReader>();
+    reader->open(m_archives_dir, archive_id);
+    reader->read_dictionaries_and_metadata();
+    auto const memory_usage = estimate_memory_usage(*reader);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (auto cached_reader = wait_and_acquire(archive_id, lock); nullptr != cached_reader) {
+        // Another search read the archive concurrently
+        return cached_reader;
+    }
+    m_lru_archive_ids.push_front(archive_id);
+    auto const it = m_entries.emplace(
+            archive_id,
+            Entry{reader,
+                  memory_usage,
+                  estimate_index_memory_usage(*reader),
+                  true,
+                  m_lru_archive_ids.begin()}
+    ).first;
+    m_memory_usage += memory_usage;
+    evict();
+    return make_releasing_pointer(archive_id, it->second);
+}
+
+std::shared_ptr<ArchiveReader> ArchiveReaderCache::wait_and_acquire(
+        std::string const& archive_id,
+        std::unique_lock<std::mutex>& lock
+) {
+    while (true) {
+        auto it = m_entries.find(archive_id);
+        if (m_entries.end() == it) {
+            return nullptr;
+        }
+        auto& entry = it->second;
+        if (false == entry.is_in_use) {
+            entry.is_in_use = true;
+            m_lru_archive_ids.splice(
+                    m_lru_archive_ids.begin(),
+                    m_lru_archive_ids,
+                    entry.lru_position
+            );
+            return make_releasing_pointer(archive_id, entry);
+        }
+        m_reader_released.wait(lock);
+    }
+}
+
+std::shared_ptr<ArchiveReader>
+ArchiveReaderCache::make_releasing_pointer(std::string const& archive_id, Entry const& entry) {
+    // The entry keeps the reader alive while it's in use, since readers in use aren't evicted
+    return {entry.reader.get(), [this, archive_id](ArchiveReader*) { release(archive_id); }};
+}
+
+void ArchiveReaderCache::release(std::string const& archive_id) {
+    std::lock_guard<std::mutex> const lock(m_mutex);
+    auto& entry = m_entries.at(archive_id);
+    entry.is_in_use = false;
+    // Only the dictionaries' search indices grow while a reader is used
+    auto const index_memory_usage = estimate_index_memory_usage(*entry.reader);
+    m_memory_usage = m_memory_usage - entry.index_memory_usage + index_memory_usage;
+    entry.memory_usage = entry.memory_usage - entry.index_memory_usage + index_memory_usage;
+    entry.index_memory_usage = index_memory_usage;
+    evict();
+    m_reader_released.notify_all();
+}
+
+size_t ArchiveReaderCache::estimate_memory_usage(ArchiveReader& reader) {
+    size_t memory_usage{0};
+    for (auto const& entry : reader.get_variable_dictionary()->get_entries()) {
+        memory_usage += sizeof(entry) + entry.get_value().size();
+    }
+    for (auto const& entry : reader.get_log_type_dictionary()->get_entries()) {
+        memory_usage += sizeof(entry) + entry.get_value().size();
+    }
+    for (auto const& entry : reader.get_array_dictionary()->get_entries()) {
+        memory_usage += sizeof(entry) + entry.get_value().size();
+    }
+    for (auto const& node : reader.get_schema_tree()->get_nodes()) {
+        memory_usage += sizeof(node) + node.get_key_name().size();
+    }
+    for (auto const& [schema_id, schema] : *reader.get_schema_map()) {
+        memory_usage += sizeof(schema_id) + sizeof(schema) + schema.size() * sizeof(int32_t);
+    }
+    for (auto const schema_id : reader.get_schema_ids()) {
+        auto const& table_metadata = reader.get_table_metadata(schema_id);
+        memory_usage += sizeof(schema_id) + sizeof(table_metadata);
+        for (auto const& row_group : table_metadata.row_groups) {
+            memory_usage += sizeof(row_group)
+                            + row_group.column_chunks.size()
+                                      * sizeof(SchemaReader::ColumnChunkMetadata);
+            for (auto const& statistics : row_group.statistics) {
+                memory_usage += sizeof(statistics)
+                                + statistics.get_dictionary_ids().size() * sizeof(uint64_t);
+            }
+        }
+    }
+
+    auto const timestamp_dict = reader.get_timestamp_dictionary();
+    for (auto it = timestamp_dict->pattern_begin(); timestamp_dict->pattern_end() != it; ++it) {
+        memory_usage += sizeof(*it) + it->second.get_format().size();
+    }
+    for (auto it = timestamp_dict->tokenized_column_to_range_begin();
+         timestamp_dict->tokenized_column_to_range_end() != it;
+         ++it)
+    {
+        memory_usage += sizeof(*it) + sizeof(*it->second);
+        for (auto const& token : it->first) {
+            memory_usage += sizeof(token) + token.size();
+        }
+    }
+    return memory_usage + estimate_index_memory_usage(reader);
+}
+
+size_t ArchiveReaderCache::estimate_index_memory_usage(ArchiveReader& reader) {
+    return reader.get_variable_dictionary()->get_index_memory_usage()
+           + reader.get_log_type_dictionary()->get_index_memory_usage()
+           + reader.get_array_dictionary()->get_index_memory_usage();
+}
+
+void ArchiveReaderCache::evict() {
+    // Archives before `lru_it` are candidates for eviction, from the least recently used one
+    auto lru_it = m_lru_archive_ids.end();
+    while ((m_memory_usage > m_memory_budget || m_lru_archive_ids.size() > m_max_num_readers)
+           && m_lru_archive_ids.begin() != lru_it
+           && m_lru_archive_ids.begin() != std::prev(lru_it))
+    {
+        --lru_it;
+        auto it = m_entries.find(*lru_it);
+        if (it->second.is_in_use) {
+            continue;
+        }
+        m_memory_usage -= it->second.memory_usage;
+        m_entries.erase(it);
+        lru_it = m_lru_archive_ids.erase(lru_it);
+    }
+}
+}  // namespace clp_s
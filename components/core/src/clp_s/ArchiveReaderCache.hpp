@@ -0,0 +1,127 @@
+#ifndef CLP_S_ARCHIVEREADERCACHE_HPP
+#define CLP_S_ARCHIVEREADERCACHE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "ArchiveReader.hpp"
+
+namespace clp_s {
+/**
+ * A cache of open archive readers, each with its dictionaries and metadata already read, so that
+ * repeated searches of the same archives don't re-read them from disk. When the estimated memory
+ * used by the cached readers exceeds the cache's budget, or more readers than the cache's limit are
+ * open, the least recently used readers which aren't in use are evicted. The limit bounds the
+ * memory mappings and file descriptors held open by the cached readers, which aren't included in
+ * the memory estimate.
+ *
+ * The cache may be used by several threads at once, but an archive reader isn't thread-safe, so
+ * each cached reader is only given to one search at a time. A search holds its reader until it
+ * releases every copy of the pointer returned by `get`, and other searches of the same archive
+ * wait until then. Since the dictionaries build search indices as they're used, a reader's memory
+ * usage is re-estimated whenever it's released.
+ */
+class ArchiveReaderCache {
+public:
+    // Constructors
+    ArchiveReaderCache(std::string archives_dir, size_t memory_budget, size_t max_num_readers)
+            : m_archives_dir(std::move(archives_dir)),
+              m_memory_budget(memory_budget),
+              m_max_num_readers(max_num_readers) {}
+
+    // Methods
+    /**
+     * Gets an open reader for the given archive, opening the archive and reading its dictionaries
+     * and metadata if it isn't already cached. If another search is using the cached reader, waits
+     * until that search releases it. To avoid deadlocks, callers must release any reader they hold
+     * before getting another one. The returned reader must be released before the cache is
+     * destroyed.
+     * @param archive_id
+     * @return the archive reader
+     * @throw ArchiveReader::OperationFailed or any exception thrown while reading the archive
+     */
+    std::shared_ptr<ArchiveReader> get(std::string const& archive_id);
+
+    /**
+     * @return the estimated memory used by the cached readers
+     */
+    size_t get_memory_usage() const {
+        std::lock_guard<std::mutex> const lock(m_mutex);
+        return m_memory_usage;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<ArchiveReader> reader;
+        size_t memory_usage;
+        size_t index_memory_usage;
+        bool is_in_use;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    /**
+     * @param reader
+     * @return an estimate of the memory used by the dictionaries, schemas, and table metadata of
+     * the given reader, including the dictionaries' search indices
+     */
+    static size_t estimate_memory_usage(ArchiveReader& reader);
+
+    /**
+     * @param reader
+     * @return an estimate of the memory used by the search indices of the given reader's
+     * dictionaries
+     */
+    static size_t estimate_index_memory_usage(ArchiveReader& reader);
+
+    /**
+     * Waits until the cached reader for the given archive, if any, isn't in use, and then marks it
+     * as used by the caller
+     * @param archive_id
+     * @param lock A lock holding `m_mutex`
+     * @return the reader, released to the cache when the caller releases it, or nullptr if the
+     * archive isn't cached
+     */
+    std::shared_ptr<ArchiveReader>
+    wait_and_acquire(std::string const& archive_id, std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @param archive_id
+     * @param entry The archive's entry, which must be in use by the caller
+     * @return a pointer to the entry's reader which releases it to the cache once every copy of the
+     * pointer is destroyed
+     */
+    std::shared_ptr<ArchiveReader>
+    make_releasing_pointer(std::string const& archive_id, Entry const& entry);
+
+    /**
+     * Marks the cached reader for the given archive as no longer in use and re-estimates its
+     * memory usage
+     * @param archive_id
+     */
+    void release(std::string const& archive_id);
+
+    /**
+     * Evicts the least recently used readers which aren't in use until the cache is within its
+     * budget and reader limit, always keeping the most recently used reader
+     */
+    void evict();
+
+    std::string m_archives_dir;
+    size_t m_memory_budget;
+    size_t m_max_num_readers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_reader_released;
+    size_t m_memory_usage{0};
+    // Archive IDs ordered from the most to the least recently used
+    std::list<std::string> m_lru_archive_ids;
+    std::unordered_map<std::string, Entry> m_entries;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_ARCHIVEREADERCACHE_HPP
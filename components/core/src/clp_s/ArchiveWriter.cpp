@@ -1,5 +1,15 @@
 #include "ArchiveWriter.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
 #include <json/single_include/nlohmann/json.hpp>
 
 #include "archive_constants.hpp"
@@ -7,10 +17,41 @@
 #include "SchemaTree.hpp"
 
 namespace clp_s {
+namespace {
+// Serializes archive stats printed by concurrently running ArchiveWriters
+std::mutex stats_output_mutex;
+// Serializes metadata DB updates from concurrently running ArchiveWriters, which may share a
+// connection
+std::mutex metadata_db_mutex;
+
+/**
+ * Runs the given worker on up to the given number of threads, up to one thread per task
+ * @param num_threads
+ * @param num_tasks
+ * @param worker
+ */
+template <typename Worker>
+void run_workers(size_t num_threads, size_t num_tasks, Worker const& worker) {
+    size_t num_workers = std::min(num_threads, num_tasks);
+    std::vector<std::future<void>> futures;
+    for (size_t i = 1; i < num_workers; ++i) {
+        futures.emplace_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+}  // namespace
+
 void ArchiveWriter::open(ArchiveWriterOption const& option) {
     m_id = boost::uuids::to_string(option.id);
     m_compression_level = option.compression_level;
     m_print_archive_stats = option.print_archive_stats;
+    m_row_group_size = option.row_group_size;
+    m_max_buffered_table_size = option.max_buffered_table_size;
+    m_sort_by_timestamp = option.sort_by_timestamp;
+    m_num_threads = std::max<size_t>(option.num_threads, 1);
     auto archive_path = boost::filesystem::path(option.archives_dir) / m_id;
 
     boost::system::error_code boost_error_code;
@@ -43,12 +84,34 @@ void ArchiveWriter::open(ArchiveWriterOption const& option) {
 }
 
 void ArchiveWriter::close() {
-    m_compressed_size += m_var_dict->close();
-    m_compressed_size += m_log_dict->close();
-    m_compressed_size += m_array_dict->close();
-    m_compressed_size += m_timestamp_dict->close();
-    m_compressed_size += m_schema_tree.store(m_archive_path, m_compression_level);
-    m_compressed_size += m_schema_map.store(m_archive_path, m_compression_level);
+    // Each dictionary, the schema tree, and the schema map are written to separate files, so they
+    // can be compressed concurrently. They share this archive's threads with the tables, which are
+    // compressed afterwards.
+    std::array<std::function<size_t()>, 6> const store_tasks{
+            [&]() {
+                // The filter is built from the dictionary's values, which are released once it's
+                // closed
+                auto const filter_size = m_var_dict->store_filter(
+                        m_archive_path + constants::cArchiveVarDictFilterFile
+                );
+                return filter_size + m_var_dict->close();
+            },
+            [&]() { return m_log_dict->close(); },
+            [&]() { return m_array_dict->close(); },
+            [&]() { return m_timestamp_dict->close(); },
+            [&]() { return m_schema_tree.store(m_archive_path, m_compression_level); },
+            [&]() { return m_schema_map.store(m_archive_path, m_compression_level); }
+    };
+    std::array<size_t, store_tasks.size()> stored_sizes{};
+    std::atomic_size_t next_task{0};
+    run_workers(m_num_threads, store_tasks.size(), [&]() {
+        for (size_t i = next_task++; i < store_tasks.size(); i = next_task++) {
+            stored_sizes[i] = store_tasks[i]();
+        }
+    });
+    for (auto const stored_size : stored_sizes) {
+        m_compressed_size += stored_size;
+    }
     m_compressed_size += store_tables();
 
     if (m_metadata_db) {
@@ -60,9 +123,13 @@ void ArchiveWriter::close() {
     }
 
     m_id_to_schema_writer.clear();
+    m_id_to_schema.clear();
+    m_spilled_row_groups.clear();
+    m_spilled_runs.clear();
     m_schema_tree.clear();
     m_schema_map.clear();
     m_encoded_message_size = 0UL;
+    m_buffered_message_size = 0UL;
     m_uncompressed_size = 0UL;
     m_compressed_size = 0UL;
 }
@@ -80,9 +147,17 @@ void ArchiveWriter::append_message(
         schema_writer = new SchemaWriter();
         initialize_schema_writer(schema_writer, schema);
         m_id_to_schema_writer[schema_id] = schema_writer;
+        if (m_sort_by_timestamp) {
+            m_id_to_schema.emplace(schema_id, schema);
+        }
     }
 
-    m_encoded_message_size += schema_writer->append_message(message);
+    size_t message_size = schema_writer->append_message(message);
+    m_encoded_message_size += message_size;
+    m_buffered_message_size += message_size;
+    if (0 != m_max_buffered_table_size && m_buffered_message_size >= m_max_buffered_table_size) {
+        spill_tables();
+    }
 }
 
 size_t ArchiveWriter::get_data_size() {
@@ -125,9 +200,183 @@ void ArchiveWriter::initialize_schema_writer(SchemaWriter* writer, Schema const&
                 break;
         }
     }
+
+    if (m_sort_by_timestamp) {
+        // Like the reader, take messages' timestamps from the last timestamp column in the ordered
+        // part of their schema
+        for (size_t i = 0; i < schema.get_num_ordered(); ++i) {
+            if (m_timestamp_dict->is_timestamp_column(schema[i])) {
+                writer->set_sort_column(schema[i]);
+            }
+        }
+    }
+}
+
+std::vector<ArchiveWriter::RowGroup> ArchiveWriter::compress_row_groups(
+        std::vector<std::pair<int32_t, SchemaWriter*>> const& schema_writers,
+        std::vector<size_t>& first_row_group,
+        bool delete_schema_writers
+) {
+    // Tables are sorted before they're split so that each row group covers a narrow range of
+    // timestamps
+    if (m_sort_by_timestamp) {
+        std::atomic_size_t next_table{0};
+        run_workers(m_num_threads, schema_writers.size(), [&]() {
+            for (size_t i = next_table++; i < schema_writers.size(); i = next_table++) {
+                schema_writers[i].second->sort_messages();
+            }
+        });
+    }
+
+    // Each table is split into row groups of at most m_row_group_size messages. Every row group is
+    // compressed into its own buffer concurrently. Within a row group, each column is compressed
+    // into its own frame.
+    first_row_group.resize(schema_writers.size());
+    std::vector<RowGroup> row_groups;
+    for (size_t i = 0; i < schema_writers.size(); ++i) {
+        uint64_t num_messages = schema_writers[i].second->get_num_messages();
+        first_row_group[i] = row_groups.size();
+        uint64_t row_group_size = 0 == m_row_group_size ? num_messages : m_row_group_size;
+        for (uint64_t begin = 0; begin < num_messages; begin += row_group_size) {
+            row_groups.push_back({i, begin, std::min(begin + row_group_size, num_messages)});
+        }
+    }
+
+    // When requested, a table's writer is deleted as soon as all of its row groups have been
+    // compressed
+    std::vector<std::atomic_size_t> num_remaining_row_groups(schema_writers.size());
+    for (size_t i = 0; i < schema_writers.size(); ++i) {
+        size_t end = i + 1 < schema_writers.size() ? first_row_group[i + 1] : row_groups.size();
+        num_remaining_row_groups[i] = end - first_row_group[i];
+        if (delete_schema_writers && 0 == num_remaining_row_groups[i]) {
+            delete schema_writers[i].second;
+        }
+    }
+
+    std::atomic_size_t next_row_group{0};
+    auto compress = [&]() {
+        ZstdCompressor tables_compressor;
+        for (size_t i = next_row_group++; i < row_groups.size(); i = next_row_group++) {
+            auto& row_group = row_groups[i];
+            auto* schema_writer = schema_writers[row_group.table].second;
+            row_group.column_chunks = schema_writer->store(
+                    tables_compressor,
+                    row_group.compressed_data,
+                    m_compression_level,
+                    row_group.begin,
+                    row_group.end
+            );
+            for (auto const& column_chunk : row_group.column_chunks) {
+                row_group.uncompressed_size += column_chunk.uncompressed_size;
+            }
+            row_group.statistics = schema_writer->get_statistics(row_group.begin, row_group.end);
+            if (1 == num_remaining_row_groups[row_group.table]-- && delete_schema_writers) {
+                delete schema_writer;
+            }
+        }
+    };
+
+    run_workers(m_num_threads, row_groups.size(), compress);
+    return row_groups;
+}
+
+void ArchiveWriter::spill_tables() {
+    std::vector<std::pair<int32_t, SchemaWriter*>> schema_writers(
+            m_id_to_schema_writer.begin(),
+            m_id_to_schema_writer.end()
+    );
+    if (m_spilled_row_groups.empty() && m_spilled_runs.empty()) {
+        m_spill_file_writer.open(
+                m_archive_path + constants::cArchiveSpillFile,
+                FileWriter::OpenMode::CreateForWriting
+        );
+    }
+
+    if (m_sort_by_timestamp) {
+        // Row groups of separately sorted spills would overlap, so each table is spilled as a
+        // sorted run to be merged with the table's other runs when the archive is closed
+        std::vector<std::vector<char>> runs(schema_writers.size());
+        std::atomic_size_t next_table{0};
+        run_workers(m_num_threads, schema_writers.size(), [&]() {
+            ZstdCompressor compressor;
+            for (size_t i = next_table++; i < schema_writers.size(); i = next_table++) {
+                auto* schema_writer = schema_writers[i].second;
+                uint64_t num_messages = schema_writer->get_num_messages();
+                if (0 == num_messages) {
+                    continue;
+                }
+                schema_writer->sort_messages();
+                compressor.open(runs[i], m_compression_level);
+                for (uint64_t begin = 0; begin < num_messages; begin += cSpilledRunBlockSize) {
+                    auto end = std::min<uint64_t>(begin + cSpilledRunBlockSize, num_messages);
+                    schema_writer->write_messages(compressor, begin, end);
+                }
+                compressor.close();
+            }
+        });
+        for (size_t i = 0; i < schema_writers.size(); ++i) {
+            auto* schema_writer = schema_writers[i].second;
+            if (0 == schema_writer->get_num_messages()) {
+                continue;
+            }
+            m_spilled_runs[schema_writers[i].first].push_back(
+                    {m_spill_file_writer.get_pos(),
+                     runs[i].size(),
+                     schema_writer->get_num_messages()}
+            );
+            m_spill_file_writer.write(runs[i].data(), runs[i].size());
+            std::vector<char>().swap(runs[i]);
+            schema_writer->clear();
+        }
+        m_buffered_message_size = 0;
+        return;
+    }
+
+    std::vector<size_t> first_row_group;
+    auto row_groups = compress_row_groups(schema_writers, first_row_group, false);
+    for (auto& row_group : row_groups) {
+        auto& compressed_data = row_group.compressed_data;
+        row_group.spill_offset = m_spill_file_writer.get_pos();
+        row_group.spill_size = compressed_data.size();
+        m_spill_file_writer.write(compressed_data.data(), compressed_data.size());
+        std::vector<char>().swap(compressed_data);
+        auto& spilled_row_groups = m_spilled_row_groups[schema_writers[row_group.table].first];
+        spilled_row_groups.push_back(std::move(row_group));
+    }
+
+    for (auto& [schema_id, schema_writer] : schema_writers) {
+        schema_writer->clear();
+    }
+    m_buffered_message_size = 0;
 }
 
 size_t ArchiveWriter::store_tables() {
+    // The buffered messages are compressed into row groups, then the row groups of each table are
+    // written out in order, starting with those which were spilled. Tables with spilled runs are
+    // instead merged as they're written.
+    std::vector<std::pair<int32_t, SchemaWriter*>> schema_writers(
+            m_id_to_schema_writer.begin(),
+            m_id_to_schema_writer.end()
+    );
+    std::vector<uint64_t> num_messages(schema_writers.size());
+    std::vector<std::pair<int32_t, SchemaWriter*>> unmerged_schema_writers;
+    std::vector<size_t> unmerged_index(schema_writers.size());
+    for (size_t i = 0; i < schema_writers.size(); ++i) {
+        num_messages[i] = schema_writers[i].second->get_num_messages();
+        if (false == m_spilled_runs.contains(schema_writers[i].first)) {
+            unmerged_index[i] = unmerged_schema_writers.size();
+            unmerged_schema_writers.push_back(schema_writers[i]);
+        }
+    }
+    std::vector<size_t> first_row_group;
+    auto row_groups = compress_row_groups(unmerged_schema_writers, first_row_group, true);
+
+    boost::iostreams::mapped_file_source spill_file;
+    if (false == m_spilled_row_groups.empty() || false == m_spilled_runs.empty()) {
+        m_spill_file_writer.close();
+        spill_file.open(m_archive_path + constants::cArchiveSpillFile);
+    }
+
     size_t compressed_size = 0;
     m_tables_file_writer.open(
             m_archive_path + constants::cArchiveTablesFile,
@@ -138,18 +387,51 @@ size_t ArchiveWriter::store_tables() {
             FileWriter::OpenMode::CreateForWriting
     );
     m_table_metadata_compressor.open(m_table_metadata_file_writer, m_compression_level);
-    m_table_metadata_compressor.write_numeric_value(m_id_to_schema_writer.size());
-    for (auto& i : m_id_to_schema_writer) {
-        m_table_metadata_compressor.write_numeric_value(i.first);
-        m_table_metadata_compressor.write_numeric_value(i.second->get_num_messages());
-        m_table_metadata_compressor.write_numeric_value(m_tables_file_writer.get_pos());
 
-        m_tables_compressor.open(m_tables_file_writer, m_compression_level);
-        size_t uncompressed_size = i.second->store(m_tables_compressor);
-        m_tables_compressor.close();
-        delete i.second;
+    std::vector<RowGroup> const no_spilled_row_groups;
+    m_table_metadata_compressor.write_numeric_value(schema_writers.size());
+    for (size_t i = 0; i < schema_writers.size(); ++i) {
+        auto const schema_id = schema_writers[i].first;
+        auto const spilled_runs_it = m_spilled_runs.find(schema_id);
+        if (m_spilled_runs.end() != spilled_runs_it) {
+            write_merged_table(
+                    schema_id,
+                    schema_writers[i].second,
+                    spilled_runs_it->second,
+                    spill_file.data()
+            );
+            continue;
+        }
+
+        auto const spilled_it = m_spilled_row_groups.find(schema_id);
+        auto const& spilled_row_groups = m_spilled_row_groups.end() == spilled_it
+                                                 ? no_spilled_row_groups
+                                                 : spilled_it->second;
+        uint64_t total_num_messages = num_messages[i];
+        for (auto const& row_group : spilled_row_groups) {
+            total_num_messages += row_group.end - row_group.begin;
+        }
+        m_table_metadata_compressor.write_numeric_value(schema_id);
+        m_table_metadata_compressor.write_numeric_value(total_num_messages);
 
-        m_table_metadata_compressor.write_numeric_value(uncompressed_size);
+        auto const table = unmerged_index[i];
+        size_t end = table + 1 < unmerged_schema_writers.size() ? first_row_group[table + 1]
+                                                                : row_groups.size();
+        m_table_metadata_compressor.write_numeric_value(
+                spilled_row_groups.size() + end - first_row_group[table]
+        );
+        for (auto const& row_group : spilled_row_groups) {
+            write_row_group(
+                    row_group,
+                    spill_file.data() + row_group.spill_offset,
+                    row_group.spill_size
+            );
+        }
+        for (size_t j = first_row_group[table]; j < end; ++j) {
+            auto& compressed_data = row_groups[j].compressed_data;
+            write_row_group(row_groups[j], compressed_data.data(), compressed_data.size());
+            std::vector<char>().swap(compressed_data);
+        }
     }
     m_table_metadata_compressor.close();
 
@@ -159,10 +441,147 @@ size_t ArchiveWriter::store_tables() {
     m_table_metadata_file_writer.close();
     m_tables_file_writer.close();
 
+    if (spill_file.is_open()) {
+        spill_file.close();
+        boost::filesystem::remove(m_archive_path + constants::cArchiveSpillFile);
+    }
+
     return compressed_size;
 }
 
+void ArchiveWriter::write_merged_table(
+        int32_t schema_id,
+        SchemaWriter* schema_writer,
+        std::vector<SpilledRun> const& spilled_runs,
+        char const* spill_data
+) {
+    // Each run is read a block at a time, and the buffered messages form the last run
+    struct MergeRun {
+        SchemaWriter* messages;
+        size_t next_message{0};
+        uint64_t num_unread_messages{0};
+        ZstdDecompressor decompressor;
+    };
+    Schema const& schema = m_id_to_schema.at(schema_id);
+    std::vector<std::unique_ptr<SchemaWriter>> run_writers;
+    std::vector<std::unique_ptr<MergeRun>> runs;
+    uint64_t total_num_messages{0};
+    for (auto const& spilled_run : spilled_runs) {
+        auto& run_writer = run_writers.emplace_back(std::make_unique<SchemaWriter>());
+        initialize_schema_writer(run_writer.get(), schema);
+        auto& run = runs.emplace_back(std::make_unique<MergeRun>());
+        run->messages = run_writer.get();
+        run->decompressor.open(spill_data + spilled_run.spill_offset, spilled_run.spill_size);
+        auto const num_messages
+                = std::min<uint64_t>(spilled_run.num_messages, cSpilledRunBlockSize);
+        run->messages->read_messages(run->decompressor, num_messages);
+        run->num_unread_messages = spilled_run.num_messages - num_messages;
+        total_num_messages += spilled_run.num_messages;
+    }
+    schema_writer->sort_messages();
+    if (schema_writer->get_num_messages() > 0) {
+        auto& run = runs.emplace_back(std::make_unique<MergeRun>());
+        run->messages = schema_writer;
+        total_num_messages += schema_writer->get_num_messages();
+    }
+
+    uint64_t const row_group_size = 0 == m_row_group_size ? total_num_messages : m_row_group_size;
+    m_table_metadata_compressor.write_numeric_value(schema_id);
+    m_table_metadata_compressor.write_numeric_value(total_num_messages);
+    m_table_metadata_compressor.write_numeric_value(
+            (total_num_messages + row_group_size - 1) / row_group_size
+    );
+
+    // Runs are ordered by their next message, and runs with equal messages by their position, so
+    // that messages with equal timestamps keep the order they were appended in
+    auto is_after = [&](size_t lhs, size_t rhs) {
+        auto const& lhs_run = *runs[lhs];
+        auto const& rhs_run = *runs[rhs];
+        auto const lhs_next = lhs_run.next_message;
+        auto const rhs_next = rhs_run.next_message;
+        if (rhs_run.messages->is_message_less(rhs_next, *lhs_run.messages, lhs_next)) {
+            return true;
+        }
+        if (lhs_run.messages->is_message_less(lhs_next, *rhs_run.messages, rhs_next)) {
+            return false;
+        }
+        return rhs < lhs;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(is_after)> next_runs(is_after);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        next_runs.push(i);
+    }
+
+    // Merged messages are compressed a batch of row groups at a time, so that each thread can
+    // compress a row group
+    SchemaWriter merged_messages;
+    initialize_schema_writer(&merged_messages, schema);
+    uint64_t const batch_size = row_group_size * m_num_threads;
+    auto write_merged_messages = [&]() {
+        std::vector<size_t> first_row_group;
+        auto row_groups
+                = compress_row_groups({{schema_id, &merged_messages}}, first_row_group, false);
+        for (auto& row_group : row_groups) {
+            write_row_group(
+                    row_group,
+                    row_group.compressed_data.data(),
+                    row_group.compressed_data.size()
+            );
+        }
+        merged_messages.clear();
+    };
+    while (false == next_runs.empty()) {
+        auto const run_index = next_runs.top();
+        next_runs.pop();
+        auto& run = *runs[run_index];
+        merged_messages.append_message_from(*run.messages, run.next_message++);
+        if (merged_messages.get_num_messages() == batch_size) {
+            write_merged_messages();
+        }
+
+        if (run.next_message == run.messages->get_num_messages()) {
+            if (0 == run.num_unread_messages) {
+                continue;
+            }
+            auto const num_messages
+                    = std::min<uint64_t>(run.num_unread_messages, cSpilledRunBlockSize);
+            run.messages->clear();
+            run.messages->read_messages(run.decompressor, num_messages);
+            run.num_unread_messages -= num_messages;
+            run.next_message = 0;
+        }
+        next_runs.push(run_index);
+    }
+    if (merged_messages.get_num_messages() > 0) {
+        write_merged_messages();
+    }
+
+    for (auto& run : runs) {
+        if (run->messages != schema_writer) {
+            run->decompressor.close();
+        }
+    }
+    delete schema_writer;
+}
+
+void ArchiveWriter::write_row_group(RowGroup const& row_group, char const* data, size_t size) {
+    m_table_metadata_compressor.write_numeric_value(row_group.end - row_group.begin);
+    m_table_metadata_compressor.write_numeric_value(m_tables_file_writer.get_pos());
+    m_table_metadata_compressor.write_numeric_value(row_group.uncompressed_size);
+    m_table_metadata_compressor.write_numeric_value(row_group.statistics.size());
+    for (auto const& statistics : row_group.statistics) {
+        statistics.write(m_table_metadata_compressor);
+    }
+    m_table_metadata_compressor.write_numeric_value(row_group.column_chunks.size());
+    for (auto const& column_chunk : row_group.column_chunks) {
+        m_table_metadata_compressor.write_numeric_value(column_chunk.compressed_size);
+        m_table_metadata_compressor.write_numeric_value(column_chunk.uncompressed_size);
+    }
+    m_tables_file_writer.write(data, size);
+}
+
 void ArchiveWriter::update_metadata_db() {
+    std::lock_guard<std::mutex> lock(metadata_db_mutex);
     m_metadata_db->open();
     clp::streaming_archive::ArchiveMetadata metadata(
             cArchiveFormatDevelopmentVersionFlag,
@@ -185,6 +604,7 @@ void ArchiveWriter::print_archive_stats() {
     json_msg["id"] = m_id;
     json_msg["uncompressed_size"] = m_uncompressed_size;
     json_msg["size"] = m_compressed_size;
+    std::lock_guard<std::mutex> lock(stats_output_mutex);
     std::cout << json_msg.dump(-1, ' ', true, nlohmann::json::error_handler_t::ignore) << std::endl;
 }
 }  // namespace clp_s
@@ -1,9 +1,12 @@
 #ifndef CLP_S_ARCHIVEWRITER_HPP
 #define CLP_S_ARCHIVEWRITER_HPP
 
+#include <map>
 #include <utility>
+#include <vector>
 
 #include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
@@ -21,6 +24,10 @@ struct ArchiveWriterOption {
     std::string archives_dir;
     int compression_level;
     bool print_archive_stats;
+    size_t row_group_size;
+    size_t max_buffered_table_size;
+    bool sort_by_timestamp;
+    size_t num_threads;
 };
 
 class ArchiveWriter {
@@ -65,10 +72,15 @@ public:
      * @param key
      * @return the node id
      */
-    int32_t add_node(int parent_node_id, NodeType type, std::string const& key) {
+    int32_t add_node(int parent_node_id, NodeType type, std::string_view key) {
         return m_schema_tree.add_node(parent_node_id, type, key);
     }
 
+    /**
+     * Marks the start of a new record in the schema tree
+     */
+    void start_record() { m_schema_tree.start_record(); }
+
     /**
      * Return a schema's Id and add the schema to the
      * schema map if it does not already exist.
@@ -120,6 +132,32 @@ public:
     size_t get_data_size();
 
 private:
+    // A compressed range of a table's messages
+    struct RowGroup {
+        size_t table;
+        uint64_t begin;
+        uint64_t end;
+        std::vector<char> compressed_data;
+        size_t uncompressed_size{0};
+        std::vector<SchemaWriter::ColumnChunk> column_chunks;
+        std::vector<ColumnStatistics> statistics;
+        // Location of the compressed data in the spill file, once the row group has been spilled
+        size_t spill_offset{0};
+        size_t spill_size{0};
+    };
+
+    // A sorted run of a table's messages in the spill file, written when tables are sorted by
+    // timestamp
+    struct SpilledRun {
+        size_t spill_offset;
+        size_t spill_size;
+        uint64_t num_messages;
+    };
+
+    // Number of messages written to a spilled run at a time, and so the number of messages of each
+    // run which are buffered while the runs are merged
+    static constexpr size_t cSpilledRunBlockSize = 4096;
+
     /**
      * Initializes the schema writer
      * @param writer
@@ -128,11 +166,62 @@ private:
     void initialize_schema_writer(SchemaWriter* writer, Schema const& schema);
 
     /**
-     * Stores the tables
+     * Stores the tables as row groups along with per-column statistics for each row group,
+     * compressing independent row groups concurrently
      * @return Size of the compressed data in bytes
      */
     [[nodiscard]] size_t store_tables();
 
+    /**
+     * Compresses every message buffered in the given schema writers into row groups, compressing
+     * independent row groups concurrently
+     * @param schema_writers
+     * @param first_row_group Returns the index of the first row group of each table
+     * @param delete_schema_writers Whether to delete each schema writer once its row groups have
+     * been compressed
+     * @return the row groups, ordered by table
+     */
+    std::vector<RowGroup> compress_row_groups(
+            std::vector<std::pair<int32_t, SchemaWriter*>> const& schema_writers,
+            std::vector<size_t>& first_row_group,
+            bool delete_schema_writers
+    );
+
+    /**
+     * Compresses the buffered messages of every table into row groups, writes them to the
+     * archive's spill file, and releases the memory the messages used. The spilled row groups are
+     * copied into the tables file by `store_tables`.
+     *
+     * When tables are sorted by timestamp, each table's buffered messages are instead sorted and
+     * written to the spill file as a run, so that `store_tables` can merge the runs into a single
+     * sorted table.
+     */
+    void spill_tables();
+
+    /**
+     * Merges a table's spilled runs and its buffered messages into row groups ordered by the
+     * table's sort column, and writes them to the tables file
+     * @param schema_id
+     * @param schema_writer The table's schema writer, which is deleted once its messages have been
+     * merged
+     * @param spilled_runs
+     * @param spill_data The contents of the spill file
+     */
+    void write_merged_table(
+            int32_t schema_id,
+            SchemaWriter* schema_writer,
+            std::vector<SpilledRun> const& spilled_runs,
+            char const* spill_data
+    );
+
+    /**
+     * Writes a row group's metadata to the table metadata file and its data to the tables file
+     * @param row_group
+     * @param data
+     * @param size
+     */
+    void write_row_group(RowGroup const& row_group, char const* data, size_t size);
+
     /**
      * Updates the metadata db with the archive's metadata (id, size, timestamp ranges, etc.)
      */
@@ -144,6 +233,8 @@ private:
     void print_archive_stats();
 
     size_t m_encoded_message_size{};
+    // Size of the encoded messages which haven't been spilled
+    size_t m_buffered_message_size{};
     size_t m_uncompressed_size{};
     size_t m_compressed_size{};
 
@@ -159,15 +250,23 @@ private:
     std::shared_ptr<clp::GlobalMySQLMetadataDB> m_metadata_db;
     int m_compression_level{};
     bool m_print_archive_stats{};
+    size_t m_row_group_size{};
+    size_t m_max_buffered_table_size{};
+    bool m_sort_by_timestamp{};
+    size_t m_num_threads{1};
 
     SchemaMap m_schema_map;
     SchemaTree m_schema_tree;
 
     std::map<int32_t, SchemaWriter*> m_id_to_schema_writer;
+    // Schemas of the tables, kept when tables are sorted so that their spilled runs can be read
+    std::map<int32_t, Schema> m_id_to_schema;
+    std::map<int32_t, std::vector<RowGroup>> m_spilled_row_groups;
+    std::map<int32_t, std::vector<SpilledRun>> m_spilled_runs;
+    FileWriter m_spill_file_writer;
 
     FileWriter m_tables_file_writer;
     FileWriter m_table_metadata_file_writer;
-    ZstdCompressor m_tables_compressor;
     ZstdCompressor m_table_metadata_compressor;
 };
 }  // namespace clp_s
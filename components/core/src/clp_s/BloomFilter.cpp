@@ -0,0 +1,82 @@
+#include "BloomFilter.hpp"
+
+#include <algorithm>
+
+namespace clp_s {
+BloomFilter::BloomFilter(size_t num_values) {
+    auto const num_words = (std::max<size_t>(num_values, 1) * cBitsPerValue + cBitsPerWord - 1)
+                           / cBitsPerWord;
+    m_words.resize(num_words, 0);
+    m_num_bits = num_words * cBitsPerWord;
+}
+
+void BloomFilter::add(std::string_view value) {
+    auto [h1, h2] = hash(value);
+    for (uint32_t i = 0; i < m_num_hash_functions; ++i) {
+        auto const bit = (h1 + i * h2) % m_num_bits;
+        m_words[bit / cBitsPerWord] |= uint64_t{1} << (bit % cBitsPerWord);
+    }
+}
+
+bool BloomFilter::possibly_contains(std::string_view value) const {
+    if (0 == m_num_bits) {
+        return true;
+    }
+
+    auto [h1, h2] = hash(value);
+    for (uint32_t i = 0; i < m_num_hash_functions; ++i) {
+        auto const bit = (h1 + i * h2) % m_num_bits;
+        if (0 == (m_words[bit / cBitsPerWord] & (uint64_t{1} << (bit % cBitsPerWord)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t BloomFilter::write(FileWriter& writer) const {
+    writer.write_numeric_value(m_num_hash_functions);
+    writer.write_numeric_value(m_num_bits);
+    writer.write(reinterpret_cast<char const*>(m_words.data()), m_words.size() * sizeof(uint64_t));
+    return sizeof(m_num_hash_functions) + sizeof(m_num_bits) + m_words.size() * sizeof(uint64_t);
+}
+
+void BloomFilter::read(FileReader& reader) {
+    auto error_code = reader.try_read_numeric_value(m_num_hash_functions);
+    if (ErrorCodeSuccess != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+    error_code = reader.try_read_numeric_value(m_num_bits);
+    if (ErrorCodeSuccess != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+    if (0 != m_num_bits % cBitsPerWord) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+
+    m_words.resize(m_num_bits / cBitsPerWord);
+    error_code = reader.try_read_exact_length(
+            reinterpret_cast<char*>(m_words.data()),
+            m_words.size() * sizeof(uint64_t)
+    );
+    if (ErrorCodeSuccess != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+}
+
+std::pair<uint64_t, uint64_t> BloomFilter::hash(std::string_view value) {
+    // 64-bit FNV-1a
+    uint64_t h1 = 0xcbf2'9ce4'8422'2325ULL;
+    for (char const c : value) {
+        h1 ^= static_cast<unsigned char>(c);
+        h1 *= 0x100'0000'01b3ULL;
+    }
+
+    // Derive the second hash with the splitmix64 finalizer; it must be odd so that successive bit
+    // positions don't repeat when the number of bits is a power of two
+    uint64_t h2 = h1;
+    h2 = (h2 ^ (h2 >> 30)) * 0xbf58'476d'1ce4'e5b9ULL;
+    h2 = (h2 ^ (h2 >> 27)) * 0x94d0'49bb'1331'11ebULL;
+    h2 ^= h2 >> 31;
+    return {h1, h2 | 1};
+}
+}  // namespace clp_s
@@ -0,0 +1,83 @@
+#ifndef CLP_S_BLOOMFILTER_HPP
+#define CLP_S_BLOOMFILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "FileReader.hpp"
+#include "FileWriter.hpp"
+#include "TraceableException.hpp"
+
+namespace clp_s {
+/**
+ * A bloom filter over strings, used to rule out values which can't be present in an archive
+ * without reading the archive itself. The hash functions are stable so that filters can be stored
+ * and read back by a different process.
+ */
+class BloomFilter {
+public:
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    BloomFilter() = default;
+
+    /**
+     * Creates an empty filter sized to hold the given number of values with a false positive rate
+     * of roughly 1%
+     * @param num_values
+     */
+    explicit BloomFilter(size_t num_values);
+
+    /**
+     * Adds a value to the filter
+     * @param value
+     */
+    void add(std::string_view value);
+
+    /**
+     * @param value
+     * @return false if the value was definitely never added to the filter, true otherwise
+     */
+    bool possibly_contains(std::string_view value) const;
+
+    /**
+     * Writes the filter to the given file
+     * @param writer
+     * @return the number of bytes written
+     */
+    size_t write(FileWriter& writer) const;
+
+    /**
+     * Reads a filter previously written by `write`
+     * @param reader
+     * @throw BloomFilter::OperationFailed if the filter couldn't be read
+     */
+    void read(FileReader& reader);
+
+private:
+    static constexpr size_t cBitsPerValue = 10;
+    static constexpr uint32_t cNumHashFunctions = 7;
+    static constexpr size_t cBitsPerWord = 64;
+
+    /**
+     * Computes the two hashes used to derive every bit position of a value
+     * @param value
+     * @return the pair of hashes
+     */
+    static std::pair<uint64_t, uint64_t> hash(std::string_view value);
+
+    uint32_t m_num_hash_functions{cNumHashFunctions};
+    uint64_t m_num_bits{0};
+    std::vector<uint64_t> m_words;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_BLOOMFILTER_HPP
@@ -2,11 +2,12 @@
 
 #include "BufferViewReader.hpp"
 #include "ColumnWriter.hpp"
+#include "IntegerEncoder.hpp"
 #include "VariableDecoder.hpp"
 
 namespace clp_s {
 void Int64ColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
-    m_values = reader.read_unaligned_span<int64_t>(num_messages);
+    m_values = IntegerEncoder::decode<int64_t>(reader, num_messages, m_decoded_values);
 }
 
 std::variant<int64_t, double, std::string, uint8_t> Int64ColumnReader::extract_value(
@@ -16,7 +17,7 @@ std::variant<int64_t, double, std::string, uint8_t> Int64ColumnReader::extract_v
 }
 
 void FloatColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
-    m_values = reader.read_unaligned_span<double>(num_messages);
+    m_values = IntegerEncoder::decode<double>(reader, num_messages, m_decoded_values);
 }
 
 void Int64ColumnReader::extract_string_value_into_buffer(
@@ -33,7 +34,12 @@ std::variant<int64_t, double, std::string, uint8_t> FloatColumnReader::extract_v
 }
 
 void BooleanColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
-    m_values = reader.read_unaligned_span<uint8_t>(num_messages);
+    auto bitmap = reader.read_unaligned_span<uint8_t>((num_messages + 7) / 8);
+    m_decoded_values.resize(num_messages);
+    for (size_t i = 0; i < num_messages; ++i) {
+        m_decoded_values[i] = (bitmap[i / 8] >> (i % 8)) & 1;
+    }
+    m_values = {reinterpret_cast<char*>(m_decoded_values.data()), num_messages};
 }
 
 void FloatColumnReader::extract_string_value_into_buffer(
@@ -130,8 +136,12 @@ int64_t VariableStringColumnReader::get_variable_id(uint64_t cur_message) {
 }
 
 void DateStringColumnReader::load(BufferViewReader& reader, uint64_t num_messages) {
-    m_timestamps = reader.read_unaligned_span<int64_t>(num_messages);
-    m_timestamp_encodings = reader.read_unaligned_span<int64_t>(num_messages);
+    m_timestamps = IntegerEncoder::decode<int64_t>(reader, num_messages, m_decoded_timestamps);
+    m_timestamp_encodings = IntegerEncoder::decode<int64_t>(
+            reader,
+            num_messages,
+            m_decoded_timestamp_encodings
+    );
 }
 
 std::variant<int64_t, double, std::string, uint8_t> DateStringColumnReader::extract_value(
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <variant>
+#include <vector>
 
 #include "BufferViewReader.hpp"
 #include "DictionaryReader.hpp"
@@ -75,8 +76,14 @@ public:
 
     void extract_string_value_into_buffer(uint64_t cur_message, std::string& buffer) override;
 
+    /**
+     * @return the values of every message in the table
+     */
+    UnalignedMemSpan<int64_t> get_values() { return m_values; }
+
 private:
     UnalignedMemSpan<int64_t> m_values;
+    std::vector<int64_t> m_decoded_values;
 };
 
 class FloatColumnReader : public BaseColumnReader {
@@ -97,8 +104,14 @@ public:
 
     void extract_string_value_into_buffer(uint64_t cur_message, std::string& buffer) override;
 
+    /**
+     * @return the values of every message in the table
+     */
+    UnalignedMemSpan<double> get_values() { return m_values; }
+
 private:
     UnalignedMemSpan<double> m_values;
+    std::vector<int64_t> m_decoded_values;
 };
 
 class BooleanColumnReader : public BaseColumnReader {
@@ -119,8 +132,14 @@ public:
 
     void extract_string_value_into_buffer(uint64_t cur_message, std::string& buffer) override;
 
+    /**
+     * @return the values of every message in the table
+     */
+    UnalignedMemSpan<uint8_t> get_values() { return m_values; }
+
 private:
     UnalignedMemSpan<uint8_t> m_values;
+    std::vector<uint8_t> m_decoded_values;
 };
 
 class ClpStringColumnReader : public BaseColumnReader {
@@ -203,6 +222,11 @@ public:
      */
     int64_t get_variable_id(uint64_t cur_message);
 
+    /**
+     * @return the variable ids of every message in the table
+     */
+    UnalignedMemSpan<uint64_t> get_variable_ids() { return m_variables; }
+
 private:
     std::shared_ptr<VariableDictionaryReader> m_var_dict;
 
@@ -235,11 +259,18 @@ public:
      */
     epochtime_t get_encoded_time(uint64_t cur_message);
 
+    /**
+     * @return the encoded times of every message in the table
+     */
+    UnalignedMemSpan<int64_t> get_encoded_times() { return m_timestamps; }
+
 private:
     std::shared_ptr<TimestampDictionaryReader> m_timestamp_dict;
 
     UnalignedMemSpan<int64_t> m_timestamps;
     UnalignedMemSpan<int64_t> m_timestamp_encodings;
+    std::vector<int64_t> m_decoded_timestamps;
+    std::vector<int64_t> m_decoded_timestamp_encodings;
 };
 }  // namespace clp_s
 
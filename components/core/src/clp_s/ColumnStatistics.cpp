@@ -0,0 +1,205 @@
+#include "ColumnStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+using clp_s::search::FilterOperation;
+
+namespace clp_s {
+namespace {
+/**
+ * Evaluates a filter operation against every value in a range
+ * @tparam T
+ * @param op
+ * @param min
+ * @param max
+ * @param operand
+ * @return EvaluatedValue::True if every value in [min, max] satisfies the operation,
+ * EvaluatedValue::False if no value does, EvaluatedValue::Unknown otherwise
+ */
+template <typename T>
+EvaluatedValue evaluate_range(FilterOperation op, T min, T max, T operand) {
+    switch (op) {
+        case FilterOperation::EQ:
+            if (operand < min || operand > max) {
+                return EvaluatedValue::False;
+            }
+            return min == max ? EvaluatedValue::True : EvaluatedValue::Unknown;
+        case FilterOperation::NEQ:
+            if (operand < min || operand > max) {
+                return EvaluatedValue::True;
+            }
+            return min == max ? EvaluatedValue::False : EvaluatedValue::Unknown;
+        case FilterOperation::LT:
+            if (max < operand) {
+                return EvaluatedValue::True;
+            }
+            return min >= operand ? EvaluatedValue::False : EvaluatedValue::Unknown;
+        case FilterOperation::GT:
+            if (min > operand) {
+                return EvaluatedValue::True;
+            }
+            return max <= operand ? EvaluatedValue::False : EvaluatedValue::Unknown;
+        case FilterOperation::LTE:
+            if (max <= operand) {
+                return EvaluatedValue::True;
+            }
+            return min > operand ? EvaluatedValue::False : EvaluatedValue::Unknown;
+        case FilterOperation::GTE:
+            if (min >= operand) {
+                return EvaluatedValue::True;
+            }
+            return max < operand ? EvaluatedValue::False : EvaluatedValue::Unknown;
+        default:
+            return EvaluatedValue::Unknown;
+    }
+}
+
+/**
+ * Reads a numeric value from the decompressor
+ * @tparam ValueType
+ * @param decompressor
+ * @return the value
+ * @throw ColumnStatistics::OperationFailed if the value couldn't be read
+ */
+template <typename ValueType>
+ValueType read_numeric_value(ZstdDecompressor& decompressor) {
+    ValueType value;
+    if (auto error = decompressor.try_read_numeric_value(value); ErrorCodeSuccess != error) {
+        throw ColumnStatistics::OperationFailed(error, __FILENAME__, __LINE__);
+    }
+    return value;
+}
+}  // namespace
+
+EvaluatedValue ColumnStatistics::evaluate_filter(FilterOperation op, int64_t operand) const {
+    if (Type::IntegerRange != m_type) {
+        return EvaluatedValue::Unknown;
+    }
+    return evaluate_range(op, m_int_min, m_int_max, operand);
+}
+
+EvaluatedValue ColumnStatistics::evaluate_filter(FilterOperation op, double operand) const {
+    if (Type::FloatRange != m_type || std::isnan(operand)) {
+        return EvaluatedValue::Unknown;
+    }
+    return evaluate_range(op, m_float_min, m_float_max, operand);
+}
+
+EvaluatedValue ColumnStatistics::evaluate_filter(
+        FilterOperation op,
+        std::unordered_set<int64_t> const& matching_ids
+) const {
+    if (Type::DictionaryIds != m_type || (FilterOperation::EQ != op && FilterOperation::NEQ != op))
+    {
+        return EvaluatedValue::Unknown;
+    }
+    auto num_matched = std::count_if(
+            m_dictionary_ids.begin(),
+            m_dictionary_ids.end(),
+            [&](uint64_t id) { return matching_ids.count(static_cast<int64_t>(id)) > 0; }
+    );
+    bool const is_eq = FilterOperation::EQ == op;
+    if (0 == num_matched) {
+        return is_eq ? EvaluatedValue::False : EvaluatedValue::True;
+    }
+    if (m_dictionary_ids.size() == static_cast<size_t>(num_matched)) {
+        return is_eq ? EvaluatedValue::True : EvaluatedValue::False;
+    }
+    return EvaluatedValue::Unknown;
+}
+
+void ColumnStatistics::merge(ColumnStatistics const& other) {
+    if (m_type != other.m_type) {
+        m_type = Type::None;
+        m_dictionary_ids.clear();
+        return;
+    }
+
+    switch (m_type) {
+        case Type::IntegerRange:
+            m_int_min = std::min(m_int_min, other.m_int_min);
+            m_int_max = std::max(m_int_max, other.m_int_max);
+            break;
+        case Type::FloatRange:
+            m_float_min = std::min(m_float_min, other.m_float_min);
+            m_float_max = std::max(m_float_max, other.m_float_max);
+            break;
+        case Type::DictionaryIds: {
+            std::vector<uint64_t> merged_ids;
+            std::set_union(
+                    m_dictionary_ids.begin(),
+                    m_dictionary_ids.end(),
+                    other.m_dictionary_ids.begin(),
+                    other.m_dictionary_ids.end(),
+                    std::back_inserter(merged_ids)
+            );
+            m_dictionary_ids = std::move(merged_ids);
+            break;
+        }
+        case Type::None:
+            break;
+    }
+}
+
+void ColumnStatistics::write(ZstdCompressor& compressor) const {
+    compressor.write_numeric_value(m_column_id);
+    compressor.write_numeric_value(m_type);
+    switch (m_type) {
+        case Type::IntegerRange:
+            compressor.write_numeric_value(m_int_min);
+            compressor.write_numeric_value(m_int_max);
+            break;
+        case Type::FloatRange:
+            compressor.write_numeric_value(m_float_min);
+            compressor.write_numeric_value(m_float_max);
+            break;
+        case Type::DictionaryIds:
+            compressor.write_numeric_value(static_cast<uint64_t>(m_dictionary_ids.size()));
+            compressor.write(
+                    reinterpret_cast<char const*>(m_dictionary_ids.data()),
+                    m_dictionary_ids.size() * sizeof(uint64_t)
+            );
+            break;
+        case Type::None:
+            break;
+    }
+}
+
+ColumnStatistics ColumnStatistics::read(ZstdDecompressor& decompressor) {
+    auto column_id = read_numeric_value<int32_t>(decompressor);
+    switch (read_numeric_value<Type>(decompressor)) {
+        case Type::None:
+            return ColumnStatistics{column_id};
+        case Type::IntegerRange: {
+            auto min = read_numeric_value<int64_t>(decompressor);
+            auto max = read_numeric_value<int64_t>(decompressor);
+            return {column_id, min, max};
+        }
+        case Type::FloatRange: {
+            auto min = read_numeric_value<double>(decompressor);
+            auto max = read_numeric_value<double>(decompressor);
+            return {column_id, min, max};
+        }
+        case Type::DictionaryIds: {
+            auto num_ids = read_numeric_value<uint64_t>(decompressor);
+            std::vector<uint64_t> dictionary_ids(num_ids);
+            if (0 == num_ids) {
+                return {column_id, std::move(dictionary_ids)};
+            }
+            if (auto error = decompressor.try_read_exact_length(
+                        reinterpret_cast<char*>(dictionary_ids.data()),
+                        num_ids * sizeof(uint64_t)
+                );
+                ErrorCodeSuccess != error)
+            {
+                throw OperationFailed(error, __FILENAME__, __LINE__);
+            }
+            return {column_id, std::move(dictionary_ids)};
+        }
+        default:
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+}
+}  // namespace clp_s
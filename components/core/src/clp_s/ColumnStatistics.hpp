@@ -0,0 +1,145 @@
+#ifndef CLP_S_COLUMNSTATISTICS_HPP
+#define CLP_S_COLUMNSTATISTICS_HPP
+
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "search/FilterOperation.hpp"
+#include "TraceableException.hpp"
+#include "Utils.hpp"
+#include "ZstdCompressor.hpp"
+#include "ZstdDecompressor.hpp"
+
+namespace clp_s {
+/**
+ * A summary of the values a column takes within a row group, used to skip row groups which can't
+ * match a query. Numeric columns record the range of their values while dictionary-encoded columns
+ * record the distinct dictionary ids they reference.
+ */
+class ColumnStatistics {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    enum class Type : uint8_t {
+        None = 0,
+        IntegerRange,
+        FloatRange,
+        DictionaryIds
+    };
+
+    // Columns referencing more distinct dictionary ids than this don't record them
+    static constexpr size_t cMaxNumDictionaryIds = 256;
+
+    // Constructors
+    ColumnStatistics() = default;
+
+    explicit ColumnStatistics(int32_t column_id) : m_column_id(column_id) {}
+
+    ColumnStatistics(int32_t column_id, int64_t min, int64_t max)
+            : m_column_id(column_id),
+              m_type(Type::IntegerRange),
+              m_int_min(min),
+              m_int_max(max) {}
+
+    ColumnStatistics(int32_t column_id, double min, double max)
+            : m_column_id(column_id),
+              m_type(Type::FloatRange),
+              m_float_min(min),
+              m_float_max(max) {}
+
+    /**
+     * @param column_id
+     * @param dictionary_ids the distinct dictionary ids, sorted in ascending order
+     */
+    ColumnStatistics(int32_t column_id, std::vector<uint64_t> dictionary_ids)
+            : m_column_id(column_id),
+              m_type(Type::DictionaryIds),
+              m_dictionary_ids(std::move(dictionary_ids)) {}
+
+    // Methods
+    int32_t get_column_id() const { return m_column_id; }
+
+    Type get_type() const { return m_type; }
+
+    int64_t get_int_min() const { return m_int_min; }
+
+    int64_t get_int_max() const { return m_int_max; }
+
+    double get_float_min() const { return m_float_min; }
+
+    double get_float_max() const { return m_float_max; }
+
+    std::vector<uint64_t> const& get_dictionary_ids() const { return m_dictionary_ids; }
+
+    /**
+     * Evaluates a filter against the integer range summarized by these statistics
+     * @param op
+     * @param operand
+     * @return EvaluatedValue::True if every value in the range satisfies the filter,
+     * EvaluatedValue::False if no value does, EvaluatedValue::Unknown otherwise or if these
+     * statistics don't summarize an integer range
+     */
+    EvaluatedValue evaluate_filter(search::FilterOperation op, int64_t operand) const;
+
+    /**
+     * Evaluates a filter against the float range summarized by these statistics
+     * @param op
+     * @param operand
+     * @return Same as the integer overload, with EvaluatedValue::Unknown if the operand is NaN
+     */
+    EvaluatedValue evaluate_filter(search::FilterOperation op, double operand) const;
+
+    /**
+     * Evaluates an EQ or NEQ filter against the dictionary ids summarized by these statistics
+     * @param op
+     * @param matching_ids the ids of the dictionary entries which equal the filter's operand
+     * @return EvaluatedValue::True if every id satisfies the filter, EvaluatedValue::False if no id
+     * does, EvaluatedValue::Unknown otherwise, for any other operation, or if these statistics
+     * don't summarize dictionary ids
+     */
+    EvaluatedValue evaluate_filter(
+            search::FilterOperation op,
+            std::unordered_set<int64_t> const& matching_ids
+    ) const;
+
+    /**
+     * Widens these statistics to also cover the values summarized by `other`. Statistics of
+     * different types can't be combined, so merging them discards all information.
+     * @param other
+     */
+    void merge(ColumnStatistics const& other);
+
+    /**
+     * Writes the statistics to the compressor
+     * @param compressor
+     */
+    void write(ZstdCompressor& compressor) const;
+
+    /**
+     * Reads statistics written by `write`
+     * @param decompressor
+     * @return the statistics
+     * @throw OperationFailed if the statistics couldn't be read
+     */
+    static ColumnStatistics read(ZstdDecompressor& decompressor);
+
+private:
+    int32_t m_column_id{-1};
+    Type m_type{Type::None};
+    int64_t m_int_min{0};
+    int64_t m_int_max{0};
+    double m_float_min{0.0};
+    double m_float_max{0.0};
+    std::vector<uint64_t> m_dictionary_ids;
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_COLUMNSTATISTICS_HPP
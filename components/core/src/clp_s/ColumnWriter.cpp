@@ -1,15 +1,184 @@
 #include "ColumnWriter.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <span>
+
+#include "IntegerEncoder.hpp"
+
 namespace clp_s {
+namespace {
+/**
+ * @param column_id
+ * @param values
+ * @return statistics recording the range of the given values
+ */
+ColumnStatistics get_integer_range_statistics(int32_t column_id, std::span<int64_t const> values) {
+    if (values.empty()) {
+        return ColumnStatistics{column_id};
+    }
+    auto [min, max] = std::minmax_element(values.begin(), values.end());
+    return {column_id, *min, *max};
+}
+
+/**
+ * @tparam IdGetter a callable taking an index and returning the dictionary id at that index
+ * @param column_id
+ * @param num_values
+ * @param get_id
+ * @return statistics recording the distinct dictionary ids, or no statistics if there are more
+ * than ColumnStatistics::cMaxNumDictionaryIds of them
+ */
+template <typename IdGetter>
+ColumnStatistics
+get_dictionary_id_statistics(int32_t column_id, size_t num_values, IdGetter get_id) {
+    std::vector<uint64_t> ids;
+    for (size_t i = 0; i < num_values; ++i) {
+        uint64_t id = get_id(i);
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (ids.end() != it && *it == id) {
+            continue;
+        }
+        if (ids.size() == ColumnStatistics::cMaxNumDictionaryIds) {
+            return ColumnStatistics{column_id};
+        }
+        ids.insert(it, id);
+    }
+    return {column_id, std::move(ids)};
+}
+
+/**
+ * @tparam Less a strict weak ordering of the values
+ * @param values
+ * @param less
+ * @return the indices of the values in stably sorted order
+ */
+template <typename T, typename Less = std::less<T>>
+std::vector<size_t> get_stable_sorted_order(std::vector<T> const& values, Less less = {}) {
+    std::vector<size_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return less(values[lhs], values[rhs]);
+    });
+    return order;
+}
+
+/**
+ * Orders doubles with NaNs, which can't be ordered, after every other value
+ * @param lhs
+ * @param rhs
+ * @return whether lhs orders before rhs
+ */
+bool is_float_less(double lhs, double rhs) {
+    return std::isnan(rhs) ? false == std::isnan(lhs) : lhs < rhs;
+}
+
+/**
+ * Writes the values in [begin, end) as raw bytes
+ * @param compressor
+ * @param values
+ * @param begin
+ * @param end
+ */
+template <typename T>
+void write_raw_values(
+        ZstdCompressor& compressor,
+        std::vector<T> const& values,
+        size_t begin,
+        size_t end
+) {
+    compressor.write(
+            reinterpret_cast<char const*>(values.data() + begin),
+            (end - begin) * sizeof(T)
+    );
+}
+
+/**
+ * Appends values written by `write_raw_values`
+ * @param decompressor
+ * @param values
+ * @param num_values
+ * @throw BaseColumnWriter::OperationFailed if the values couldn't be read
+ */
+template <typename T>
+void read_raw_values(ZstdDecompressor& decompressor, std::vector<T>& values, size_t num_values) {
+    if (0 == num_values) {
+        return;
+    }
+    size_t const num_existing_values = values.size();
+    values.resize(num_existing_values + num_values);
+    auto const error_code = decompressor.try_read_exact_length(
+            reinterpret_cast<char*>(values.data() + num_existing_values),
+            num_values * sizeof(T)
+    );
+    if (ErrorCodeSuccess != error_code) {
+        throw BaseColumnWriter::OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+}
+
+/**
+ * Reorders the values so that the value at position i is the one previously at order[i]
+ * @param values
+ * @param order
+ */
+template <typename T>
+void reorder_values(std::vector<T>& values, std::vector<size_t> const& order) {
+    std::vector<T> reordered_values;
+    reordered_values.reserve(values.size());
+    for (size_t i : order) {
+        reordered_values.push_back(values[i]);
+    }
+    values = std::move(reordered_values);
+}
+}  // namespace
+
 void Int64ColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size) {
     size = sizeof(int64_t);
     m_values.push_back(std::get<int64_t>(value));
 }
 
-size_t Int64ColumnWriter::store(ZstdCompressor& compressor) {
-    size_t size = m_values.size() * sizeof(int64_t);
-    compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
-    return size;
+size_t Int64ColumnWriter::store(ZstdCompressor& compressor, size_t begin, size_t end) {
+    return IntegerEncoder::encode(std::span(m_values).subspan(begin, end - begin), compressor);
+}
+
+ColumnStatistics Int64ColumnWriter::get_statistics(size_t begin, size_t end) const {
+    return get_integer_range_statistics(m_id, std::span(m_values).subspan(begin, end - begin));
+}
+
+std::vector<size_t> Int64ColumnWriter::get_sorted_order() const {
+    return get_stable_sorted_order(m_values);
+}
+
+bool Int64ColumnWriter::is_value_less(
+        size_t index,
+        BaseColumnWriter const& other,
+        size_t other_index
+) const {
+    return m_values[index] < static_cast<Int64ColumnWriter const&>(other).m_values[other_index];
+}
+
+void Int64ColumnWriter::reorder(std::vector<size_t> const& order) {
+    reorder_values(m_values, order);
+}
+
+void Int64ColumnWriter::write_values(ZstdCompressor& compressor, size_t begin, size_t end) const {
+    write_raw_values(compressor, m_values, begin, end);
+}
+
+void Int64ColumnWriter::read_values(ZstdDecompressor& decompressor, size_t num_values) {
+    read_raw_values(decompressor, m_values, num_values);
+}
+
+size_t Int64ColumnWriter::append_value_from(BaseColumnWriter const& other, size_t index) {
+    m_values.push_back(static_cast<Int64ColumnWriter const&>(other).m_values[index]);
+    return sizeof(int64_t);
+}
+
+void Int64ColumnWriter::clear() {
+    std::vector<int64_t>().swap(m_values);
 }
 
 void FloatColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size) {
@@ -17,10 +186,67 @@ void FloatColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size
     m_values.push_back(std::get<double>(value));
 }
 
-size_t FloatColumnWriter::store(ZstdCompressor& compressor) {
-    size_t size = m_values.size() * sizeof(double);
-    compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
-    return size;
+size_t FloatColumnWriter::store(ZstdCompressor& compressor, size_t begin, size_t end) {
+    // Encode the bit patterns so that repeated and low-cardinality values still benefit
+    std::vector<int64_t> bit_patterns;
+    bit_patterns.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        bit_patterns.push_back(std::bit_cast<int64_t>(m_values[i]));
+    }
+    return IntegerEncoder::encode(bit_patterns, compressor);
+}
+
+ColumnStatistics FloatColumnWriter::get_statistics(size_t begin, size_t end) const {
+    if (begin == end) {
+        return ColumnStatistics{m_id};
+    }
+    double min = m_values[begin];
+    double max = m_values[begin];
+    for (size_t i = begin; i < end; ++i) {
+        // NaNs can't be ordered, so no range can describe them
+        if (std::isnan(m_values[i])) {
+            return ColumnStatistics{m_id};
+        }
+        min = std::min(min, m_values[i]);
+        max = std::max(max, m_values[i]);
+    }
+    return {m_id, min, max};
+}
+
+std::vector<size_t> FloatColumnWriter::get_sorted_order() const {
+    return get_stable_sorted_order(m_values, is_float_less);
+}
+
+bool FloatColumnWriter::is_value_less(
+        size_t index,
+        BaseColumnWriter const& other,
+        size_t other_index
+) const {
+    return is_float_less(
+            m_values[index],
+            static_cast<FloatColumnWriter const&>(other).m_values[other_index]
+    );
+}
+
+void FloatColumnWriter::reorder(std::vector<size_t> const& order) {
+    reorder_values(m_values, order);
+}
+
+void FloatColumnWriter::write_values(ZstdCompressor& compressor, size_t begin, size_t end) const {
+    write_raw_values(compressor, m_values, begin, end);
+}
+
+void FloatColumnWriter::read_values(ZstdDecompressor& decompressor, size_t num_values) {
+    read_raw_values(decompressor, m_values, num_values);
+}
+
+size_t FloatColumnWriter::append_value_from(BaseColumnWriter const& other, size_t index) {
+    m_values.push_back(static_cast<FloatColumnWriter const&>(other).m_values[index]);
+    return sizeof(double);
+}
+
+void FloatColumnWriter::clear() {
+    std::vector<double>().swap(m_values);
 }
 
 void BooleanColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size) {
@@ -28,19 +254,46 @@ void BooleanColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& si
     m_values.push_back(std::get<bool>(value) ? 1 : 0);
 }
 
-size_t BooleanColumnWriter::store(ZstdCompressor& compressor) {
-    size_t size = m_values.size() * sizeof(uint8_t);
-    compressor.write(reinterpret_cast<char const*>(m_values.data()), size);
+size_t BooleanColumnWriter::store(ZstdCompressor& compressor, size_t begin, size_t end) {
+    // Store the values as a bitmap
+    size_t const num_values = end - begin;
+    std::vector<uint8_t> bitmap((num_values + 7) / 8, 0);
+    for (size_t i = 0; i < num_values; ++i) {
+        bitmap[i / 8] |= m_values[begin + i] << (i % 8);
+    }
+    size_t size = bitmap.size() * sizeof(uint8_t);
+    compressor.write(reinterpret_cast<char const*>(bitmap.data()), size);
     return size;
 }
 
+void BooleanColumnWriter::reorder(std::vector<size_t> const& order) {
+    reorder_values(m_values, order);
+}
+
+void BooleanColumnWriter::write_values(ZstdCompressor& compressor, size_t begin, size_t end) const {
+    write_raw_values(compressor, m_values, begin, end);
+}
+
+void BooleanColumnWriter::read_values(ZstdDecompressor& decompressor, size_t num_values) {
+    read_raw_values(decompressor, m_values, num_values);
+}
+
+size_t BooleanColumnWriter::append_value_from(BaseColumnWriter const& other, size_t index) {
+    m_values.push_back(static_cast<BooleanColumnWriter const&>(other).m_values[index]);
+    return sizeof(uint8_t);
+}
+
+void BooleanColumnWriter::clear() {
+    std::vector<uint8_t>().swap(m_values);
+}
+
 void ClpStringColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size) {
     size = sizeof(int64_t);
-    std::string string_var = std::get<std::string>(value);
+    m_string_buffer.assign(std::get<std::string_view>(value));
     uint64_t id;
     uint64_t offset = m_encoded_vars.size();
     VariableEncoder::encode_and_add_to_dictionary(
-            string_var,
+            m_string_buffer,
             m_logtype_entry,
             *m_var_dict,
             m_encoded_vars
@@ -51,28 +304,159 @@ void ClpStringColumnWriter::add_value(ParsedMessage::variable_t& value, size_t&
     size += sizeof(int64_t) * (m_encoded_vars.size() - offset);
 }
 
-size_t ClpStringColumnWriter::store(ZstdCompressor& compressor) {
-    size_t logtypes_size = m_logtypes.size() * sizeof(int64_t);
-    compressor.write(reinterpret_cast<char const*>(m_logtypes.data()), logtypes_size);
-    size_t encoded_vars_size = m_encoded_vars.size() * sizeof(int64_t);
-    size_t num_encoded_vars = m_encoded_vars.size();
+size_t ClpStringColumnWriter::store(ZstdCompressor& compressor, size_t begin, size_t end) {
+    write_values(compressor, begin, end);
+    auto const [vars_begin, vars_end] = get_encoded_vars_range(begin, end);
+    return (end - begin) * sizeof(int64_t) + sizeof(size_t)
+           + (vars_end - vars_begin) * sizeof(int64_t);
+}
+
+void ClpStringColumnWriter::write_values(ZstdCompressor& compressor, size_t begin, size_t end)
+        const {
+    // Rebase the encoded variable offsets so that they're relative to the first message stored
+    auto const [vars_begin, vars_end] = get_encoded_vars_range(begin, end);
+    std::vector<int64_t> logtypes;
+    logtypes.reserve(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+        logtypes.push_back(encode_log_dict_id(
+                get_encoded_log_dict_id(m_logtypes[i]),
+                get_encoded_offset(m_logtypes[i]) - vars_begin
+        ));
+    }
+
+    size_t logtypes_size = logtypes.size() * sizeof(int64_t);
+    compressor.write(reinterpret_cast<char const*>(logtypes.data()), logtypes_size);
+    size_t num_encoded_vars = vars_end - vars_begin;
+    size_t encoded_vars_size = num_encoded_vars * sizeof(int64_t);
     compressor.write_numeric_value(num_encoded_vars);
-    compressor.write(reinterpret_cast<char const*>(m_encoded_vars.data()), encoded_vars_size);
-    return logtypes_size + sizeof(num_encoded_vars) + encoded_vars_size;
+    compressor.write(
+            reinterpret_cast<char const*>(m_encoded_vars.data() + vars_begin),
+            encoded_vars_size
+    );
+}
+
+void ClpStringColumnWriter::read_values(ZstdDecompressor& decompressor, size_t num_values) {
+    size_t const first_value = m_logtypes.size();
+    read_raw_values(decompressor, m_logtypes, num_values);
+    size_t num_encoded_vars{0};
+    auto const error_code = decompressor.try_read_numeric_value(num_encoded_vars);
+    if (ErrorCodeSuccess != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+
+    // The offsets were written relative to the first value, so rebase them onto the existing
+    // encoded variables
+    size_t const vars_offset = m_encoded_vars.size();
+    for (size_t i = first_value; i < m_logtypes.size(); ++i) {
+        auto const offset = static_cast<size_t>(get_encoded_offset(m_logtypes[i]));
+        if (offset > num_encoded_vars) {
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+        }
+        m_logtypes[i] = encode_log_dict_id(
+                get_encoded_log_dict_id(m_logtypes[i]),
+                vars_offset + offset
+        );
+    }
+    read_raw_values(decompressor, m_encoded_vars, num_encoded_vars);
+}
+
+size_t ClpStringColumnWriter::append_value_from(BaseColumnWriter const& other, size_t index) {
+    auto const& other_writer = static_cast<ClpStringColumnWriter const&>(other);
+    auto const [vars_begin, vars_end] = other_writer.get_encoded_vars_range(index, index + 1);
+    m_logtypes.push_back(encode_log_dict_id(
+            get_encoded_log_dict_id(other_writer.m_logtypes[index]),
+            m_encoded_vars.size()
+    ));
+    m_encoded_vars.insert(
+            m_encoded_vars.end(),
+            other_writer.m_encoded_vars.begin() + vars_begin,
+            other_writer.m_encoded_vars.begin() + vars_end
+    );
+    return sizeof(int64_t) * (1 + vars_end - vars_begin);
+}
+
+std::pair<size_t, size_t> ClpStringColumnWriter::get_encoded_vars_range(size_t begin, size_t end)
+        const {
+    size_t vars_begin = begin < m_logtypes.size() ? get_encoded_offset(m_logtypes[begin]) : 0;
+    size_t vars_end = end < m_logtypes.size() ? get_encoded_offset(m_logtypes[end])
+                                              : m_encoded_vars.size();
+    return {vars_begin, vars_end};
+}
+
+ColumnStatistics ClpStringColumnWriter::get_statistics(size_t begin, size_t end) const {
+    return get_dictionary_id_statistics(m_id, end - begin, [&](size_t i) -> uint64_t {
+        return get_encoded_log_dict_id(m_logtypes[begin + i]);
+    });
+}
+
+void ClpStringColumnWriter::reorder(std::vector<size_t> const& order) {
+    // Each message's encoded variables move along with it, so their offsets are recomputed
+    std::vector<int64_t> logtypes;
+    logtypes.reserve(m_logtypes.size());
+    std::vector<int64_t> encoded_vars;
+    encoded_vars.reserve(m_encoded_vars.size());
+    for (size_t i : order) {
+        auto const [vars_begin, vars_end] = get_encoded_vars_range(i, i + 1);
+        logtypes.push_back(
+                encode_log_dict_id(get_encoded_log_dict_id(m_logtypes[i]), encoded_vars.size())
+        );
+        encoded_vars.insert(
+                encoded_vars.end(),
+                m_encoded_vars.begin() + vars_begin,
+                m_encoded_vars.begin() + vars_end
+        );
+    }
+    m_logtypes = std::move(logtypes);
+    m_encoded_vars = std::move(encoded_vars);
+}
+
+void ClpStringColumnWriter::clear() {
+    std::vector<int64_t>().swap(m_logtypes);
+    std::vector<int64_t>().swap(m_encoded_vars);
 }
 
 void VariableStringColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size) {
     size = sizeof(int64_t);
-    std::string string_var = std::get<std::string>(value);
+    m_string_buffer.assign(std::get<std::string_view>(value));
     uint64_t id;
-    m_var_dict->add_entry(string_var, id);
+    m_var_dict->add_entry(m_string_buffer, id);
     m_variables.push_back(id);
 }
 
-size_t VariableStringColumnWriter::store(ZstdCompressor& compressor) {
-    size_t size = m_variables.size() * sizeof(int64_t);
-    compressor.write(reinterpret_cast<char const*>(m_variables.data()), size);
-    return size;
+size_t VariableStringColumnWriter::store(ZstdCompressor& compressor, size_t begin, size_t end) {
+    write_raw_values(compressor, m_variables, begin, end);
+    return (end - begin) * sizeof(int64_t);
+}
+
+ColumnStatistics VariableStringColumnWriter::get_statistics(size_t begin, size_t end) const {
+    return get_dictionary_id_statistics(m_id, end - begin, [&](size_t i) -> uint64_t {
+        return m_variables[begin + i];
+    });
+}
+
+void VariableStringColumnWriter::reorder(std::vector<size_t> const& order) {
+    reorder_values(m_variables, order);
+}
+
+void VariableStringColumnWriter::write_values(
+        ZstdCompressor& compressor,
+        size_t begin,
+        size_t end
+) const {
+    write_raw_values(compressor, m_variables, begin, end);
+}
+
+void VariableStringColumnWriter::read_values(ZstdDecompressor& decompressor, size_t num_values) {
+    read_raw_values(decompressor, m_variables, num_values);
+}
+
+size_t VariableStringColumnWriter::append_value_from(BaseColumnWriter const& other, size_t index) {
+    m_variables.push_back(static_cast<VariableStringColumnWriter const&>(other).m_variables[index]);
+    return sizeof(int64_t);
+}
+
+void VariableStringColumnWriter::clear() {
+    std::vector<int64_t>().swap(m_variables);
 }
 
 void DateStringColumnWriter::add_value(ParsedMessage::variable_t& value, size_t& size) {
@@ -82,11 +466,60 @@ void DateStringColumnWriter::add_value(ParsedMessage::variable_t& value, size_t&
     m_timestamp_encodings.push_back(encoded_timestamp.first);
 }
 
-size_t DateStringColumnWriter::store(ZstdCompressor& compressor) {
-    size_t timestamps_size = m_timestamps.size() * sizeof(int64_t);
-    compressor.write(reinterpret_cast<char const*>(m_timestamps.data()), timestamps_size);
-    size_t encodings_size = m_timestamp_encodings.size() * sizeof(int64_t);
-    compressor.write(reinterpret_cast<char const*>(m_timestamp_encodings.data()), encodings_size);
+size_t DateStringColumnWriter::store(ZstdCompressor& compressor, size_t begin, size_t end) {
+    size_t timestamps_size = IntegerEncoder::encode(
+            std::span(m_timestamps).subspan(begin, end - begin),
+            compressor
+    );
+    size_t encodings_size = IntegerEncoder::encode(
+            std::span(m_timestamp_encodings).subspan(begin, end - begin),
+            compressor
+    );
     return timestamps_size + encodings_size;
 }
+
+ColumnStatistics DateStringColumnWriter::get_statistics(size_t begin, size_t end) const {
+    return get_integer_range_statistics(m_id, std::span(m_timestamps).subspan(begin, end - begin));
+}
+
+std::vector<size_t> DateStringColumnWriter::get_sorted_order() const {
+    return get_stable_sorted_order(m_timestamps);
+}
+
+bool DateStringColumnWriter::is_value_less(
+        size_t index,
+        BaseColumnWriter const& other,
+        size_t other_index
+) const {
+    return m_timestamps[index]
+           < static_cast<DateStringColumnWriter const&>(other).m_timestamps[other_index];
+}
+
+void DateStringColumnWriter::reorder(std::vector<size_t> const& order) {
+    reorder_values(m_timestamps, order);
+    reorder_values(m_timestamp_encodings, order);
+}
+
+void DateStringColumnWriter::write_values(ZstdCompressor& compressor, size_t begin, size_t end)
+        const {
+    write_raw_values(compressor, m_timestamps, begin, end);
+    write_raw_values(compressor, m_timestamp_encodings, begin, end);
+}
+
+void DateStringColumnWriter::read_values(ZstdDecompressor& decompressor, size_t num_values) {
+    read_raw_values(decompressor, m_timestamps, num_values);
+    read_raw_values(decompressor, m_timestamp_encodings, num_values);
+}
+
+size_t DateStringColumnWriter::append_value_from(BaseColumnWriter const& other, size_t index) {
+    auto const& other_writer = static_cast<DateStringColumnWriter const&>(other);
+    m_timestamps.push_back(other_writer.m_timestamps[index]);
+    m_timestamp_encodings.push_back(other_writer.m_timestamp_encodings[index]);
+    return 2 * sizeof(int64_t);
+}
+
+void DateStringColumnWriter::clear() {
+    std::vector<int64_t>().swap(m_timestamps);
+    std::vector<int64_t>().swap(m_timestamp_encodings);
+}
 }  // namespace clp_s
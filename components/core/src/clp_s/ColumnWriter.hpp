@@ -1,23 +1,36 @@
 #ifndef CLP_S_COLUMNWRITER_HPP
 #define CLP_S_COLUMNWRITER_HPP
 
+#include <string>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include <simdjson.h>
 
+#include "ColumnStatistics.hpp"
 #include "DictionaryWriter.hpp"
 #include "FileWriter.hpp"
 #include "ParsedMessage.hpp"
 #include "TimestampDictionaryWriter.hpp"
+#include "TraceableException.hpp"
 #include "VariableEncoder.hpp"
 #include "ZstdCompressor.hpp"
+#include "ZstdDecompressor.hpp"
 
 using namespace simdjson;
 
 namespace clp_s {
 class BaseColumnWriter {
 public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
     // Constructor
     explicit BaseColumnWriter(int32_t id) : m_id(id) {}
 
@@ -32,11 +45,79 @@ public:
     virtual void add_value(ParsedMessage::variable_t& value, size_t& size) = 0;
 
     /**
-     * Stores the column to a compressed file.
+     * Stores the values of the messages in [begin, end) to a compressed file.
      * @param compressor
+     * @param begin
+     * @param end
      * @return the in-memory uncompressed size of the data written to the compressor
      */
-    virtual size_t store(ZstdCompressor& compressor) = 0;
+    virtual size_t store(ZstdCompressor& compressor, size_t begin, size_t end) = 0;
+
+    /**
+     * @param begin
+     * @param end
+     * @return statistics summarizing the values of the messages in [begin, end)
+     */
+    virtual ColumnStatistics get_statistics(size_t begin, size_t end) const {
+        return ColumnStatistics{m_id};
+    }
+
+    /**
+     * @return the indices of the messages ordered by their values in this column, with messages
+     * with equal values kept in their original order, or an empty vector if the column's values
+     * can't be ordered
+     */
+    virtual std::vector<size_t> get_sorted_order() const { return {}; }
+
+    /**
+     * @param index
+     * @param other A column writer of the same type
+     * @param other_index
+     * @return whether the value of the message at `index` orders before the value of the message at
+     * `other_index` in `other`, using the same order as `get_sorted_order`
+     */
+    virtual bool
+    is_value_less(size_t index, BaseColumnWriter const& other, size_t other_index) const {
+        return false;
+    }
+
+    /**
+     * Reorders the values of the messages in the column
+     * @param order The index of the message to move to each position
+     */
+    virtual void reorder(std::vector<size_t> const& order) = 0;
+
+    /**
+     * Writes the values of the messages in [begin, end) in their in-memory form, so that they can
+     * be appended back to a column of the same type by `read_values`
+     * @param compressor
+     * @param begin
+     * @param end
+     */
+    virtual void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const = 0;
+
+    /**
+     * Appends values previously written by `write_values`
+     * @param decompressor
+     * @param num_values
+     * @throw BaseColumnWriter::OperationFailed if the values couldn't be read
+     */
+    virtual void read_values(ZstdDecompressor& decompressor, size_t num_values) = 0;
+
+    /**
+     * Appends the value of a message in another column
+     * @param other A column writer of the same type
+     * @param index
+     * @return the size of the appended value in bytes
+     */
+    virtual size_t append_value_from(BaseColumnWriter const& other, size_t index) = 0;
+
+    /**
+     * Removes every value from the column and releases the memory they used
+     */
+    virtual void clear() = 0;
+
+    int32_t get_id() const { return m_id; }
 
 protected:
     int32_t m_id;
@@ -53,7 +134,24 @@ public:
     // Methods inherited from BaseColumnWriter
     void add_value(ParsedMessage::variable_t& value, size_t& size) override;
 
-    size_t store(ZstdCompressor& compressor) override;
+    size_t store(ZstdCompressor& compressor, size_t begin, size_t end) override;
+
+    ColumnStatistics get_statistics(size_t begin, size_t end) const override;
+
+    std::vector<size_t> get_sorted_order() const override;
+
+    bool is_value_less(size_t index, BaseColumnWriter const& other, size_t other_index)
+            const override;
+
+    void reorder(std::vector<size_t> const& order) override;
+
+    void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const override;
+
+    void read_values(ZstdDecompressor& decompressor, size_t num_values) override;
+
+    size_t append_value_from(BaseColumnWriter const& other, size_t index) override;
+
+    void clear() override;
 
 private:
     std::vector<int64_t> m_values;
@@ -70,7 +168,24 @@ public:
     // Methods inherited from BaseColumnWriter
     void add_value(ParsedMessage::variable_t& value, size_t& size) override;
 
-    size_t store(ZstdCompressor& compressor) override;
+    size_t store(ZstdCompressor& compressor, size_t begin, size_t end) override;
+
+    ColumnStatistics get_statistics(size_t begin, size_t end) const override;
+
+    std::vector<size_t> get_sorted_order() const override;
+
+    bool is_value_less(size_t index, BaseColumnWriter const& other, size_t other_index)
+            const override;
+
+    void reorder(std::vector<size_t> const& order) override;
+
+    void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const override;
+
+    void read_values(ZstdDecompressor& decompressor, size_t num_values) override;
+
+    size_t append_value_from(BaseColumnWriter const& other, size_t index) override;
+
+    void clear() override;
 
 private:
     std::vector<double> m_values;
@@ -87,7 +202,17 @@ public:
     // Methods inherited from BaseColumnWriter
     void add_value(ParsedMessage::variable_t& value, size_t& size) override;
 
-    size_t store(ZstdCompressor& compressor) override;
+    size_t store(ZstdCompressor& compressor, size_t begin, size_t end) override;
+
+    void reorder(std::vector<size_t> const& order) override;
+
+    void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const override;
+
+    void read_values(ZstdDecompressor& decompressor, size_t num_values) override;
+
+    size_t append_value_from(BaseColumnWriter const& other, size_t index) override;
+
+    void clear() override;
 
 private:
     std::vector<uint8_t> m_values;
@@ -111,7 +236,19 @@ public:
     // Methods inherited from BaseColumnWriter
     void add_value(ParsedMessage::variable_t& value, size_t& size) override;
 
-    size_t store(ZstdCompressor& compressor) override;
+    size_t store(ZstdCompressor& compressor, size_t begin, size_t end) override;
+
+    ColumnStatistics get_statistics(size_t begin, size_t end) const override;
+
+    void reorder(std::vector<size_t> const& order) override;
+
+    void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const override;
+
+    void read_values(ZstdDecompressor& decompressor, size_t num_values) override;
+
+    size_t append_value_from(BaseColumnWriter const& other, size_t index) override;
+
+    void clear() override;
 
     /**
      * @param encoded_id
@@ -130,6 +267,13 @@ public:
     }
 
 private:
+    /**
+     * @param begin
+     * @param end
+     * @return the range of encoded variables belonging to the messages in [begin, end)
+     */
+    std::pair<size_t, size_t> get_encoded_vars_range(size_t begin, size_t end) const;
+
     /**
      * Encodes a log dict id
      * @param id
@@ -147,6 +291,8 @@ private:
     std::shared_ptr<VariableDictionaryWriter> m_var_dict;
     std::shared_ptr<LogTypeDictionaryWriter> m_log_dict;
     LogTypeDictionaryEntry m_logtype_entry;
+    // Reused for every value since dictionary lookups require an owned string
+    std::string m_string_buffer;
 
     std::vector<int64_t> m_logtypes;
     std::vector<int64_t> m_encoded_vars;
@@ -165,10 +311,23 @@ public:
     // Methods inherited from BaseColumnWriter
     void add_value(ParsedMessage::variable_t& value, size_t& size) override;
 
-    size_t store(ZstdCompressor& compressor) override;
+    size_t store(ZstdCompressor& compressor, size_t begin, size_t end) override;
+
+    ColumnStatistics get_statistics(size_t begin, size_t end) const override;
+
+    void reorder(std::vector<size_t> const& order) override;
+
+    void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const override;
+
+    void read_values(ZstdDecompressor& decompressor, size_t num_values) override;
+
+    size_t append_value_from(BaseColumnWriter const& other, size_t index) override;
+
+    void clear() override;
 
 private:
     std::shared_ptr<VariableDictionaryWriter> m_var_dict;
+    std::string m_string_buffer;
     std::vector<int64_t> m_variables;
 };
 
@@ -183,7 +342,24 @@ public:
     // Methods inherited from BaseColumnWriter
     void add_value(ParsedMessage::variable_t& value, size_t& size) override;
 
-    size_t store(ZstdCompressor& compressor) override;
+    size_t store(ZstdCompressor& compressor, size_t begin, size_t end) override;
+
+    ColumnStatistics get_statistics(size_t begin, size_t end) const override;
+
+    std::vector<size_t> get_sorted_order() const override;
+
+    bool is_value_less(size_t index, BaseColumnWriter const& other, size_t other_index)
+            const override;
+
+    void reorder(std::vector<size_t> const& order) override;
+
+    void write_values(ZstdCompressor& compressor, size_t begin, size_t end) const override;
+
+    void read_values(ZstdDecompressor& decompressor, size_t num_values) override;
+
+    size_t append_value_from(BaseColumnWriter const& other, size_t index) override;
+
+    void clear() override;
 
 private:
     std::vector<int64_t> m_timestamps;
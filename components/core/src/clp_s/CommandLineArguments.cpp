@@ -106,11 +106,13 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 std::cerr << "  c - compress" << std::endl;
                 std::cerr << "  x - decompress" << std::endl;
                 std::cerr << "  s - search" << std::endl;
+                std::cerr << "  r - run a resident search server" << std::endl;
                 std::cerr << std::endl;
                 std::cerr << "Try "
                           << " c --help OR"
                           << " x --help OR"
-                          << " s --help for command-specific details." << std::endl;
+                          << " s --help OR"
+                          << " r --help for command-specific details." << std::endl;
 
                 po::options_description visible_options;
                 visible_options.add(general_options);
@@ -125,6 +127,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
             case (char)Command::Compress:
             case (char)Command::Extract:
             case (char)Command::Search:
+            case (char)Command::Serve:
                 m_command = (Command)command_input;
                 break;
             default:
@@ -189,6 +192,42 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                     "structurize-arrays",
                     po::bool_switch(&m_structurize_arrays),
                     "Structurize arrays instead of compressing them as clp strings."
+            )(
+                    "num-threads",
+                    po::value<size_t>(&m_num_threads)->value_name("NUM_THREADS")->
+                        default_value(m_num_threads),
+                    "Number of threads to compress with. Input files are distributed across "
+                    "threads and each thread writes its own archives. Threads not needed for "
+                    "parsing input are used to compress each archive's tables. Parsing is only "
+                    "parallelized across input files, so a single large input file is still "
+                    "parsed by one thread."
+            )(
+                    "max-pending-archives",
+                    po::value<size_t>(&m_max_pending_archives)->value_name("NUM_ARCHIVES")->
+                        default_value(m_max_pending_archives),
+                    "Maximum number of completed archives (per thread) that can be finalized in "
+                    "the background while compression continues. 0 finalizes archives in the "
+                    "foreground. Background archives share the --num-threads budget with the "
+                    "archive being written, so at most NUM_THREADS - 1 are finalized at once."
+            )(
+                    "row-group-size",
+                    po::value<size_t>(&m_row_group_size)->value_name("NUM_MESSAGES")->
+                        default_value(m_row_group_size),
+                    "Maximum number of messages in each independently compressed row group of a "
+                    "table. 0 stores every table as a single row group."
+            )(
+                    "max-buffered-table-size",
+                    po::value<size_t>(&m_max_buffered_table_size)->value_name("SIZE")->
+                        default_value(m_max_buffered_table_size),
+                    "Maximum size (B) of the encoded messages buffered in memory before they're "
+                    "compressed and spilled to a temporary file in the archive. 0 buffers every "
+                    "message until the archive is closed."
+            )(
+                    "sort-by-timestamp",
+                    po::bool_switch(&m_sort_by_timestamp),
+                    "Sort each table's messages by their timestamp before storing them, so that "
+                    "row groups cover narrow time ranges that searches can skip. Requires "
+                    "--timestamp-key."
             );
             // clang-format on
 
@@ -242,6 +281,14 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 throw std::invalid_argument("No input paths specified.");
             }
 
+            if (0 == m_num_threads) {
+                throw std::invalid_argument("Number of threads must be greater than 0.");
+            }
+
+            if (m_sort_by_timestamp && m_timestamp_key.empty()) {
+                throw std::invalid_argument("--sort-by-timestamp requires --timestamp-key.");
+            }
+
             // Parse and validate global metadata DB config
             if (false == metadata_db_config_file_path.empty()) {
                 clp::GlobalMetadataDBConfig metadata_db_config;
@@ -287,11 +334,19 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
             extraction_options.add(input_options);
 
             po::options_description decompression_options("Decompression Options");
+            // clang-format off
             decompression_options.add_options()(
                     "ordered",
                     po::bool_switch(&m_ordered_decompression),
                     "Enable decompression in ascending timestamp order for this archive"
+            )(
+                    "num-threads",
+                    po::value<size_t>(&m_num_threads)->value_name("NUM_THREADS")->
+                        default_value(m_num_threads),
+                    "Number of threads to decompress each archive's tables with when decompression"
+                    " isn't ordered."
             );
+            // clang-format on
             extraction_options.add(decompression_options);
 
             po::positional_options_description positional_options;
@@ -383,6 +438,18 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 "archive-id",
                 po::value<std::string>(&m_archive_id)->value_name("ID"),
                 "Limit search to the archive with the given ID"
+            )(
+                "projection",
+                po::value<std::vector<std::string>>(&m_projection_columns)->value_name("COLUMN"),
+                "Only output the given column (and its descendants) of matching records. Can be"
+                " specified multiple times. Columns which are neither projected nor searched"
+                " aren't decompressed."
+            )(
+                "num-threads",
+                po::value<size_t>(&m_num_threads)->value_name("NUM_THREADS")->
+                    default_value(m_num_threads),
+                "Number of threads to search with. Archives are distributed across threads, and"
+                " any remaining threads are used to decompress each archive's tables in parallel."
             );
             // clang-format on
             search_options.add(match_options);
@@ -397,6 +464,27 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                     "count-by-time",
                     po::value<int64_t>(&m_count_by_time_bucket_size)->value_name("SIZE"),
                     "Count the number of results in each time span of the given size (ms)"
+            )(
+                    "sum",
+                    po::value<std::string>()->value_name("COLUMN"),
+                    "Sum the values of the given numeric column in the results"
+            )(
+                    "min",
+                    po::value<std::string>()->value_name("COLUMN"),
+                    "Find the minimum value of the given numeric column in the results"
+            )(
+                    "max",
+                    po::value<std::string>()->value_name("COLUMN"),
+                    "Find the maximum value of the given numeric column in the results"
+            )(
+                    "avg",
+                    po::value<std::string>()->value_name("COLUMN"),
+                    "Average the values of the given numeric column in the results"
+            )(
+                    "group-by",
+                    po::value<std::string>(&m_group_by_field)->value_name("COLUMN"),
+                    "Compute the sum, min, max, or average separately for each value of the given"
+                    " column"
             );
             // clang-format on
             search_options.add(aggregation_options);
@@ -415,6 +503,25 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
             );
             // clang-format on
 
+            po::options_description columnar_output_handler_options(
+                    "Columnar Output Handler Options"
+            );
+            // clang-format off
+            columnar_output_handler_options.add_options()(
+                    "output-path",
+                    po::value<std::string>(&m_columnar_output_path)->value_name("PATH"),
+                    "File to write column batches to (defaults to stdout)"
+            )(
+                    "host",
+                    po::value<std::string>(&m_network_dest_host)->value_name("HOST"),
+                    "Network destination host to send column batches to"
+            )(
+                    "port",
+                    po::value<int>(&m_network_dest_port)->value_name("PORT"),
+                    "Network destination port to send column batches to"
+            );
+            // clang-format on
+
             po::options_description reducer_output_handler_options("Reducer Output Handler Options"
             );
             // clang-format off
@@ -472,6 +579,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
             constexpr char cReducerOutputHandlerName[] = "reducer";
             constexpr char cResultsCacheOutputHandlerName[] = "results-cache";
             constexpr char cStdoutCacheOutputHandlerName[] = "stdout";
+            constexpr char cColumnarOutputHandlerName[] = "columnar";
 
             if (parsed_command_line_options.count("help")) {
                 print_search_usage();
@@ -484,6 +592,10 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                           << " - Output to the results cache" << std::endl;
                 std::cerr << "  " << static_cast<char const*>(cReducerOutputHandlerName)
                           << " - Output to the reducer" << std::endl;
+                std::cerr << "  " << static_cast<char const*>(cColumnarOutputHandlerName)
+                          << " - Output msgpack column batches to stdout, a file, or a network"
+                             " destination"
+                          << std::endl;
                 std::cerr << std::endl;
 
                 std::cerr << "Examples:" << std::endl;
@@ -522,6 +634,25 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                           << " --host localhost"
                           << " --port 14009"
                           << " --job-id 1" << std::endl;
+                std::cerr << std::endl;
+
+                std::cerr << "  # Search archives in archives-dir for logs matching a KQL query"
+                             R"( "level: INFO" and find the maximum latency of each service)"
+                          << std::endl;
+                std::cerr << "  " << m_program_name << R"( s archives-dir "level: INFO")"
+                          << " " << cReducerOutputHandlerName << " --max latency"
+                          << " --group-by service.name"
+                          << " --host localhost"
+                          << " --port 14009"
+                          << " --job-id 1" << std::endl;
+                std::cerr << std::endl;
+
+                std::cerr << "  # Search archives in archives-dir for logs matching a KQL query"
+                             R"( "level: INFO" and output column batches to a file)"
+                          << std::endl;
+                std::cerr << "  " << m_program_name << R"( s archives-dir "level: INFO")"
+                          << " " << cColumnarOutputHandlerName << " --output-path results.msgpack"
+                          << std::endl;
 
                 po::options_description visible_options;
                 visible_options.add(general_options);
@@ -530,6 +661,7 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 visible_options.add(network_output_handler_options);
                 visible_options.add(results_cache_output_handler_options);
                 visible_options.add(reducer_output_handler_options);
+                visible_options.add(columnar_output_handler_options);
                 std::cerr << visible_options << '\n';
                 return ParsingResult::InfoCommand;
             }
@@ -542,6 +674,10 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 throw std::invalid_argument("No query specified");
             }
 
+            if (0 == m_num_threads) {
+                throw std::invalid_argument("Number of threads must be greater than 0.");
+            }
+
             if (parsed_command_line_options.count("tge")) {
                 m_search_begin_ts = parsed_command_line_options["tge"].as<epochtime_t>();
             }
@@ -566,6 +702,36 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 }
             }
 
+            for (auto const* aggregation_name : {"sum", "min", "max", "avg"}) {
+                if (0 == parsed_command_line_options.count(aggregation_name)) {
+                    continue;
+                }
+                if (m_aggregation_type.has_value()) {
+                    throw std::invalid_argument(
+                            "The --sum, --min, --max, and --avg options are mutually exclusive."
+                    );
+                }
+                m_aggregation_type = reducer::get_aggregation_type(aggregation_name);
+                m_aggregation_field
+                        = parsed_command_line_options[aggregation_name].as<std::string>();
+                if (m_aggregation_field.empty()) {
+                    throw std::invalid_argument(
+                            std::string("Column for ") + aggregation_name + " cannot be empty."
+                    );
+                }
+            }
+
+            if (parsed_command_line_options.count("group-by") > 0) {
+                if (false == m_aggregation_type.has_value()) {
+                    throw std::invalid_argument(
+                            "The --group-by option requires one of --sum, --min, --max, or --avg."
+                    );
+                }
+                if (m_group_by_field.empty()) {
+                    throw std::invalid_argument("Column for group-by cannot be empty.");
+                }
+            }
+
             if (parsed_command_line_options.count("output-handler") > 0) {
                 if (static_cast<char const*>(cNetworkOutputHandlerName) == output_handler_name) {
                     m_output_handler_type = OutputHandlerType::Network;
@@ -581,6 +747,10 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                             == output_handler_name))
                 {
                     m_output_handler_type = OutputHandlerType::Stdout;
+                } else if ((static_cast<char const*>(cColumnarOutputHandlerName)
+                            == output_handler_name))
+                {
+                    m_output_handler_type = OutputHandlerType::Columnar;
                 } else if (output_handler_name.empty()) {
                     throw std::invalid_argument("OUTPUT_HANDLER cannot be an empty string.");
                 } else {
@@ -606,6 +776,12 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                         search_parsed.options,
                         parsed_command_line_options
                 );
+            } else if (OutputHandlerType::Columnar == m_output_handler_type) {
+                parse_columnar_output_handler_options(
+                        columnar_output_handler_options,
+                        search_parsed.options,
+                        parsed_command_line_options
+                );
             } else if (m_output_handler_type != OutputHandlerType::Stdout) {
                 throw std::invalid_argument(
                         "Unhandled OutputHandlerType="
@@ -613,8 +789,9 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                 );
             }
 
-            bool aggregation_was_specified
-                    = m_do_count_by_time_aggregation || m_do_count_results_aggregation;
+            bool aggregation_was_specified = m_do_count_by_time_aggregation
+                                             || m_do_count_results_aggregation
+                                             || m_aggregation_type.has_value();
             if (aggregation_was_specified && OutputHandlerType::Reducer != m_output_handler_type) {
                 throw std::invalid_argument(
                         "Aggregations are only supported with the reducer output handler."
@@ -622,8 +799,8 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
             } else if ((false == aggregation_was_specified
                         && OutputHandlerType::Reducer == m_output_handler_type))
             {
-                throw std::invalid_argument("The reducer output handler currently only supports "
-                                            "count and count-by-time aggregations.");
+                throw std::invalid_argument("The reducer output handler requires an aggregation."
+                );
             }
 
             if (m_do_count_by_time_aggregation && m_do_count_results_aggregation) {
@@ -631,6 +808,143 @@ CommandLineArguments::parse_arguments(int argc, char const** argv) {
                         "The --count-by-time and --count options are mutually exclusive."
                 );
             }
+
+            if (m_aggregation_type.has_value()
+                && (m_do_count_by_time_aggregation || m_do_count_results_aggregation))
+            {
+                throw std::invalid_argument("The --count and --count-by-time options can't be"
+                                            " combined with other aggregations.");
+            }
+        } else if ((char)Command::Serve == command_input) {
+            po::options_description serve_positional_options;
+            // clang-format off
+            serve_positional_options.add_options()(
+                    "archives-dir",
+                    po::value<std::string>(&m_archives_dir),
+                    "The directory containing the archives"
+            );
+            // clang-format on
+
+            po::options_description server_options("Server Options");
+            // clang-format off
+            server_options.add_options()(
+                    "socket",
+                    po::value<std::string>(&m_server_socket_path)->value_name("PATH"),
+                    "Listen on a Unix domain socket at the given path"
+            )(
+                    "host",
+                    po::value<std::string>(&m_server_host)->value_name("HOST")->
+                        default_value(m_server_host),
+                    "Host to listen on when listening on a TCP port"
+            )(
+                    "port",
+                    po::value<int>(&m_server_port)->value_name("PORT"),
+                    "Listen on the given TCP port"
+            )(
+                    "cache-size",
+                    po::value<size_t>(&m_archive_cache_size)->value_name("SIZE")->
+                        default_value(m_archive_cache_size),
+                    "Approximate amount of memory (B) used to cache the dictionaries and metadata"
+                    " of recently searched archives"
+            )(
+                    "max-cached-archives",
+                    po::value<size_t>(&m_max_cached_archives)->value_name("NUM")->
+                        default_value(m_max_cached_archives),
+                    "Maximum number of recently searched archives to keep open"
+            )(
+                    "max-concurrent-requests",
+                    po::value<size_t>(&m_max_concurrent_requests)->value_name("NUM")->
+                        default_value(m_max_concurrent_requests),
+                    "Maximum number of requests to serve at once. Requests searching the same"
+                    " archive still take turns using its cached reader."
+            )(
+                    "num-threads",
+                    po::value<size_t>(&m_num_threads)->value_name("NUM_THREADS")->
+                        default_value(m_num_threads),
+                    "Number of threads to search each request's archives with"
+            );
+            // clang-format on
+
+            po::options_description serve_options;
+            serve_options.add(serve_positional_options);
+            serve_options.add(server_options);
+
+            po::positional_options_description positional_options;
+            positional_options.add("archives-dir", 1);
+
+            std::vector<std::string> unrecognized_options
+                    = po::collect_unrecognized(parsed.options, po::include_positional);
+            unrecognized_options.erase(unrecognized_options.begin());
+            po::store(
+                    po::command_line_parser(unrecognized_options)
+                            .options(serve_options)
+                            .positional(positional_options)
+                            .run(),
+                    parsed_command_line_options
+            );
+
+            po::notify(parsed_command_line_options);
+
+            if (parsed_command_line_options.count("help")) {
+                print_serve_usage();
+
+                std::cerr << "Each connection sends one request: a JSON array containing a"
+                             " KQL query and any of the search command's --tge, --tle,"
+                             " --ignore-case, --projection, and --archive-id options, as well as"
+                             " --max-num-results to limit the number of results, terminated by a"
+                             " newline. Results are written to the connection, which is closed"
+                             " once the search completes."
+                          << std::endl;
+                std::cerr << std::endl;
+
+                std::cerr << "Examples:" << std::endl;
+                std::cerr << "  # Serve searches of archives in archives-dir over a Unix domain"
+                             " socket"
+                          << std::endl;
+                std::cerr << "  " << m_program_name << " r archives-dir --socket /tmp/clp-s.sock"
+                          << std::endl;
+                std::cerr << std::endl;
+                std::cerr << "  # Example request" << std::endl;
+                std::cerr << R"(  ["level: INFO", "--tge", "1700000000000"])" << std::endl;
+                std::cerr << std::endl;
+
+                po::options_description visible_options;
+                visible_options.add(general_options);
+                visible_options.add(server_options);
+                std::cerr << visible_options << std::endl;
+                return ParsingResult::InfoCommand;
+            }
+
+            if (m_archives_dir.empty()) {
+                throw std::invalid_argument("No archives directory specified");
+            }
+
+            bool const has_port = parsed_command_line_options.count("port") > 0;
+            if (m_server_socket_path.empty() && false == has_port) {
+                throw std::invalid_argument("No socket or port specified");
+            }
+            if (false == m_server_socket_path.empty() && has_port) {
+                throw std::invalid_argument(
+                        "The --socket and --port options are mutually exclusive."
+                );
+            }
+            if (has_port && (m_server_port < 0 || m_server_port > UINT16_MAX)) {
+                throw std::invalid_argument("Invalid port: " + std::to_string(m_server_port));
+            }
+
+            if (0 == m_num_threads) {
+                throw std::invalid_argument("Number of threads must be greater than 0.");
+            }
+
+            if (0 == m_max_cached_archives) {
+                throw std::invalid_argument("Maximum number of cached archives must be greater than 0.");
+            }
+
+            if (0 == m_max_concurrent_requests) {
+                throw std::invalid_argument(
+                        "Maximum number of concurrent requests must be greater than 0."
+                );
+            }
         }
     } catch (std::exception& e) {
         SPDLOG_ERROR("{}", e.what());
@@ -665,6 +979,33 @@ void CommandLineArguments::parse_network_dest_output_handler_options(
     }
 }
 
+void CommandLineArguments::parse_columnar_output_handler_options(
+        po::options_description const& options_description,
+        std::vector<po::option> const& options,
+        po::variables_map& parsed_options
+) {
+    clp::parse_unrecognized_options(options_description, options, parsed_options);
+
+    bool const has_output_path = parsed_options.count("output-path") > 0;
+    bool const has_host = parsed_options.count("host") > 0;
+    bool const has_port = parsed_options.count("port") > 0;
+    if (has_output_path && m_columnar_output_path.empty()) {
+        throw std::invalid_argument("output-path cannot be an empty string.");
+    }
+    if (has_host != has_port) {
+        throw std::invalid_argument("host and port must be specified together.");
+    }
+    if (has_output_path && has_host) {
+        throw std::invalid_argument("output-path can't be specified with host and port.");
+    }
+    if (has_host && m_network_dest_host.empty()) {
+        throw std::invalid_argument("host cannot be an empty string.");
+    }
+    if (has_port && m_network_dest_port <= 0) {
+        throw std::invalid_argument("port must be greater than zero.");
+    }
+}
+
 void CommandLineArguments::parse_reducer_output_handler_options(
         po::options_description const& options_description,
         std::vector<po::option> const& options,
@@ -738,6 +1079,10 @@ void CommandLineArguments::print_decompression_usage() const {
     std::cerr << "Usage: " << m_program_name << " x [OPTIONS] ARCHIVES_DIR OUTPUT_DIR" << std::endl;
 }
 
+void CommandLineArguments::print_serve_usage() const {
+    std::cerr << "Usage: " << m_program_name << " r [OPTIONS] ARCHIVES_DIR" << std::endl;
+}
+
 void CommandLineArguments::print_search_usage() const {
     std::cerr << "Usage: " << m_program_name
               << " s [OPTIONS] ARCHIVES_DIR KQL_QUERY"
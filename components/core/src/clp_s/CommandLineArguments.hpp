@@ -10,6 +10,7 @@
 #include <boost/program_options/variables_map.hpp>
 
 #include "../clp/GlobalMetadataDBConfig.hpp"
+#include "../reducer/Aggregation.hpp"
 #include "../reducer/types.hpp"
 #include "Defs.hpp"
 
@@ -26,7 +27,8 @@ public:
     enum class Command : char {
         Compress = 'c',
         Extract = 'x',
-        Search = 's'
+        Search = 's',
+        Serve = 'r'
     };
 
     enum class OutputHandlerType : uint8_t {
@@ -34,6 +36,7 @@ public:
         Reducer,
         ResultsCache,
         Stdout,
+        Columnar,
     };
 
     // Constructors
@@ -74,6 +77,8 @@ public:
 
     int const& get_network_dest_port() const { return m_network_dest_port; }
 
+    std::string const& get_columnar_output_path() const { return m_columnar_output_path; }
+
     std::string const& get_query() const { return m_query; }
 
     std::optional<epochtime_t> get_search_begin_ts() const { return m_search_begin_ts; }
@@ -84,6 +89,8 @@ public:
 
     std::string const& get_archive_id() const { return m_archive_id; }
 
+    std::vector<std::string> const& get_projection_columns() const { return m_projection_columns; }
+
     std::optional<clp::GlobalMetadataDBConfig> const& get_metadata_db_config() const {
         return m_metadata_db_config;
     }
@@ -100,12 +107,42 @@ public:
 
     int64_t get_count_by_time_bucket_size() const { return m_count_by_time_bucket_size; }
 
+    std::optional<reducer::AggregationType> get_aggregation_type() const {
+        return m_aggregation_type;
+    }
+
+    std::string const& get_aggregation_field() const { return m_aggregation_field; }
+
+    std::string const& get_group_by_field() const { return m_group_by_field; }
+
     OutputHandlerType get_output_handler_type() const { return m_output_handler_type; }
 
     bool get_structurize_arrays() const { return m_structurize_arrays; }
 
+    size_t get_num_threads() const { return m_num_threads; }
+
+    size_t get_max_pending_archives() const { return m_max_pending_archives; }
+
+    size_t get_row_group_size() const { return m_row_group_size; }
+
+    size_t get_max_buffered_table_size() const { return m_max_buffered_table_size; }
+
+    bool get_sort_by_timestamp() const { return m_sort_by_timestamp; }
+
     bool get_ordered_decompression() const { return m_ordered_decompression; }
 
+    std::string const& get_server_socket_path() const { return m_server_socket_path; }
+
+    std::string const& get_server_host() const { return m_server_host; }
+
+    int get_server_port() const { return m_server_port; }
+
+    size_t get_archive_cache_size() const { return m_archive_cache_size; }
+
+    size_t get_max_cached_archives() const { return m_max_cached_archives; }
+
+    size_t get_max_concurrent_requests() const { return m_max_concurrent_requests; }
+
 private:
     // Methods
     /**
@@ -134,6 +171,19 @@ private:
             boost::program_options::variables_map& parsed_options
     );
 
+    /**
+     * Validates output options related to the Columnar output handler.
+     * @param options_description
+     * @param options Vector of options previously parsed by boost::program_options and which may
+     * contain options that have the unrecognized flag set
+     * @param parsed_options Returns any parsed options that were newly recognized
+     */
+    void parse_columnar_output_handler_options(
+            boost::program_options::options_description const& options_description,
+            std::vector<boost::program_options::option> const& options,
+            boost::program_options::variables_map& parsed_options
+    );
+
     /**
      * Validates output options related to the Results Cache output handler.
      * @param options_description
@@ -155,6 +205,8 @@ private:
 
     void print_search_usage() const;
 
+    void print_serve_usage() const;
+
     // Variables
     std::string m_program_name;
     Command m_command;
@@ -170,6 +222,11 @@ private:
     size_t m_max_document_size{512ULL * 1024 * 1024};  // 512 MB
     bool m_structurize_arrays{false};
     bool m_ordered_decompression{false};
+    size_t m_num_threads{1};
+    size_t m_max_pending_archives{1};
+    size_t m_row_group_size{64 * 1024};
+    size_t m_max_buffered_table_size{0};
+    bool m_sort_by_timestamp{false};
 
     // Metadata db variables
     std::optional<clp::GlobalMetadataDBConfig> m_metadata_db_config;
@@ -184,6 +241,9 @@ private:
     std::string m_network_dest_host;
     int m_network_dest_port;
 
+    // Columnar output handler variables
+    std::string m_columnar_output_path;
+
     // Search variables
     std::string m_query;
     std::optional<epochtime_t> m_search_begin_ts;
@@ -192,6 +252,7 @@ private:
 
     // Decompression and search variables
     std::string m_archive_id;
+    std::vector<std::string> m_projection_columns;
 
     // Search aggregation variables
     std::string m_reducer_host;
@@ -200,8 +261,19 @@ private:
     bool m_do_count_results_aggregation{false};
     bool m_do_count_by_time_aggregation{false};
     int64_t m_count_by_time_bucket_size{0};  // Milliseconds
+    std::optional<reducer::AggregationType> m_aggregation_type;
+    std::string m_aggregation_field;
+    std::string m_group_by_field;
 
     OutputHandlerType m_output_handler_type{OutputHandlerType::Stdout};
+
+    // Server variables
+    std::string m_server_socket_path;
+    std::string m_server_host{"127.0.0.1"};
+    int m_server_port{-1};
+    size_t m_archive_cache_size{1024ULL * 1024 * 1024};  // 1 GiB
+    size_t m_max_cached_archives{128};
+    size_t m_max_concurrent_requests{4};
 };
 }  // namespace clp_s
 
@@ -3,14 +3,28 @@
 #ifndef CLP_S_DICTIONARYREADER_HPP
 #define CLP_S_DICTIONARYREADER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <string_view>
 #include <unordered_set>
+#include <vector>
 
+#include <absl/container/flat_hash_map.h>
 #include <boost/algorithm/string/case_conv.hpp>
 
 #include "DictionaryEntry.hpp"
 #include "Utils.hpp"
 
 namespace clp_s {
+/**
+ * A reader for a dictionary's entries. The const methods, including the searches which lazily
+ * build indices over the entries, can be called concurrently from multiple threads. The non-const
+ * methods, such as `read_new_entries`, must not run concurrently with any other method.
+ */
 template <typename DictionaryIdType, typename EntryType>
 class DictionaryReader {
 public:
@@ -60,7 +74,8 @@ public:
     std::string const& get_value(DictionaryIdType id) const;
 
     /**
-     * Gets the entry exactly matching the given search string
+     * Gets the entry exactly matching the given search string. Once the dictionary has been
+     * searched more than once, a hash index over its values is built to answer later searches.
      * @param search_string
      * @param ignore_case
      * @return nullptr if an exact match is not found, the entry otherwise
@@ -69,7 +84,10 @@ public:
     get_entry_matching_value(std::string const& search_string, bool ignore_case) const;
 
     /**
-     * Gets the entries that match a given wildcard string
+     * Gets the entries that match a given wildcard string. Once the dictionary has been searched
+     * more than once, a trigram index over its values is built (unless the dictionary is too large
+     * to index), and only the entries containing every trigram of the wildcard string's literal
+     * characters are compared against it.
      * @param wildcard_string
      * @param ignore_case
      * @param entries Set in which to store found entries
@@ -80,11 +98,80 @@ public:
             std::unordered_set<EntryType const*>& entries
     ) const;
 
+    /**
+     * @return an estimate of the memory used by the indices built so far by the search methods
+     */
+    size_t get_index_memory_usage() const {
+        std::lock_guard<std::mutex> const lock(m_index_mutex);
+        return m_index_memory_usage;
+    }
+
 protected:
+    // Indices are only built once a dictionary has been searched this many times, since building
+    // one costs more than a single scan over the entries
+    static constexpr size_t cMinSearchesBeforeIndexing = 2;
+    // The trigram index holds at most one posting per byte of the dictionary's values, so larger
+    // dictionaries are scanned instead to bound the index's memory usage
+    static constexpr size_t cMaxTrigramIndexedValuesSize = 64ULL * 1024 * 1024;  // 64 MiB
+
+    /**
+     * Builds the index used to find entries exactly matching a search string, if it hasn't been
+     * built yet. Once this returns, the index isn't modified until new entries are read.
+     * @param ignore_case
+     */
+    void build_value_index(bool ignore_case) const;
+
+    /**
+     * Builds the trigram index used to find candidate entries matching a wildcard string, if it
+     * hasn't been built yet. Once this returns, the index isn't modified until new entries are
+     * read.
+     * @return Whether the index was built, or false if the dictionary is too large to index
+     */
+    bool build_trigram_index() const;
+
+    /**
+     * Gets the case-folded trigrams which every value matching the given wildcard string must
+     * contain
+     * @param wildcard_string
+     * @param trigrams Returns the distinct trigrams
+     */
+    static void get_wildcard_string_trigrams(
+            std::string const& wildcard_string,
+            std::vector<uint32_t>& trigrams
+    );
+
+    /**
+     * @param c0
+     * @param c1
+     * @param c2
+     * @return the case-folded trigram of the given characters
+     */
+    static uint32_t get_trigram(char c0, char c1, char c2) {
+        return (static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(c0))) << 16)
+               | (static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(c1))) << 8)
+               | static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(c2)));
+    }
+
     bool m_is_open;
     FileReader m_dictionary_file_reader;
     ZstdDecompressor m_dictionary_decompressor;
     std::vector<EntryType> m_entries;
+
+    // Indices over m_entries, built lazily by the (logically const) search methods and discarded
+    // whenever new entries are read. Keys of m_value_to_id view the values in m_entries. The
+    // indices are only built while holding m_index_mutex, which also guards the flags below.
+    mutable std::atomic_size_t m_num_value_searches{0};
+    mutable std::atomic_size_t m_num_wildcard_searches{0};
+    mutable std::mutex m_index_mutex;
+    mutable bool m_has_value_index{false};
+    mutable bool m_has_uppercase_value_index{false};
+    mutable bool m_has_trigram_index{false};
+    mutable bool m_is_too_large_for_trigram_index{false};
+    mutable size_t m_index_memory_usage{0};
+    mutable absl::flat_hash_map<std::string_view, DictionaryIdType> m_value_to_id;
+    mutable absl::flat_hash_map<std::string, DictionaryIdType> m_uppercase_value_to_id;
+    // IDs of the entries containing each trigram, in ascending order
+    mutable absl::flat_hash_map<uint32_t, std::vector<uint32_t>> m_trigram_to_ids;
 };
 
 class VariableDictionaryReader : public DictionaryReader<uint64_t, VariableDictionaryEntry> {};
@@ -146,6 +233,16 @@ void DictionaryReader<DictionaryIdType, EntryType>::read_new_entries(bool lazy)
             auto& entry = m_entries[i];
             entry.read_from_file(m_dictionary_decompressor, i, lazy);
         }
+
+        // The entries may have moved, and the indices no longer cover every entry
+        m_has_value_index = false;
+        m_has_uppercase_value_index = false;
+        m_has_trigram_index = false;
+        m_is_too_large_for_trigram_index = false;
+        m_index_memory_usage = 0;
+        m_value_to_id.clear();
+        m_uppercase_value_to_id.clear();
+        m_trigram_to_ids.clear();
     }
 }
 
@@ -175,6 +272,17 @@ EntryType const* DictionaryReader<DictionaryIdType, EntryType>::get_entry_matchi
         std::string const& search_string,
         bool ignore_case
 ) const {
+    if (++m_num_value_searches >= cMinSearchesBeforeIndexing) {
+        build_value_index(ignore_case);
+        if (false == ignore_case) {
+            auto const it = m_value_to_id.find(search_string);
+            return m_value_to_id.end() != it ? &m_entries[it->second] : nullptr;
+        }
+        auto const it
+                = m_uppercase_value_to_id.find(boost::algorithm::to_upper_copy(search_string));
+        return m_uppercase_value_to_id.end() != it ? &m_entries[it->second] : nullptr;
+    }
+
     if (false == ignore_case) {
         for (auto const& entry : m_entries) {
             if (entry.get_value() == search_string) {
@@ -199,12 +307,172 @@ void DictionaryReader<DictionaryIdType, EntryType>::get_entries_matching_wildcar
         bool ignore_case,
         std::unordered_set<EntryType const*>& entries
 ) const {
-    for (auto const& entry : m_entries) {
+    std::vector<uint32_t> trigrams;
+    if (++m_num_wildcard_searches >= cMinSearchesBeforeIndexing) {
+        get_wildcard_string_trigrams(wildcard_string, trigrams);
+    }
+    if (trigrams.empty() || false == build_trigram_index()) {
+        for (auto const& entry : m_entries) {
+            if (StringUtils::wildcard_match_unsafe(
+                        entry.get_value(),
+                        wildcard_string,
+                        !ignore_case
+                ))
+            {
+                entries.insert(&entry);
+            }
+        }
+        return;
+    }
+
+    std::vector<std::vector<uint32_t> const*> postings;
+    postings.reserve(trigrams.size());
+    for (auto const trigram : trigrams) {
+        auto const it = m_trigram_to_ids.find(trigram);
+        if (m_trigram_to_ids.end() == it) {
+            return;
+        }
+        postings.push_back(&it->second);
+    }
+    // Intersect the shortest postings first to keep the candidate set small
+    std::sort(postings.begin(), postings.end(), [](auto const* lhs, auto const* rhs) {
+        return lhs->size() < rhs->size();
+    });
+
+    std::vector<uint32_t> candidates{*postings.front()};
+    std::vector<uint32_t> remaining_candidates;
+    for (size_t i = 1; i < postings.size() && false == candidates.empty(); ++i) {
+        remaining_candidates.clear();
+        std::set_intersection(
+                candidates.cbegin(),
+                candidates.cend(),
+                postings[i]->cbegin(),
+                postings[i]->cend(),
+                std::back_inserter(remaining_candidates)
+        );
+        std::swap(candidates, remaining_candidates);
+    }
+
+    for (auto const id : candidates) {
+        auto const& entry = m_entries[id];
         if (StringUtils::wildcard_match_unsafe(entry.get_value(), wildcard_string, !ignore_case)) {
             entries.insert(&entry);
         }
     }
 }
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryReader<DictionaryIdType, EntryType>::build_value_index(bool ignore_case) const {
+    std::lock_guard<std::mutex> const lock(m_index_mutex);
+    if (false == ignore_case) {
+        if (m_has_value_index) {
+            return;
+        }
+        m_value_to_id.reserve(m_entries.size());
+        for (size_t i = 0; i < m_entries.size(); ++i) {
+            m_value_to_id.emplace(m_entries[i].get_value(), i);
+        }
+        // Each slot of a flat_hash_map also has a byte of control metadata
+        m_index_memory_usage += m_value_to_id.capacity() * (sizeof(*m_value_to_id.begin()) + 1);
+        m_has_value_index = true;
+        return;
+    }
+
+    if (m_has_uppercase_value_index) {
+        return;
+    }
+    // Values which only differ in case map to the first such entry, as they would when scanning
+    m_uppercase_value_to_id.reserve(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto const [it, inserted] = m_uppercase_value_to_id.emplace(
+                boost::algorithm::to_upper_copy(m_entries[i].get_value()),
+                i
+        );
+        if (inserted) {
+            m_index_memory_usage += it->first.capacity();
+        }
+    }
+    m_index_memory_usage += m_uppercase_value_to_id.capacity()
+                            * (sizeof(*m_uppercase_value_to_id.begin()) + 1);
+    m_has_uppercase_value_index = true;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+bool DictionaryReader<DictionaryIdType, EntryType>::build_trigram_index() const {
+    std::lock_guard<std::mutex> const lock(m_index_mutex);
+    if (m_has_trigram_index || m_is_too_large_for_trigram_index) {
+        return m_has_trigram_index;
+    }
+
+    size_t values_size{0};
+    for (auto const& entry : m_entries) {
+        values_size += entry.get_value().size();
+    }
+    if (values_size > cMaxTrigramIndexedValuesSize || m_entries.size() > UINT32_MAX) {
+        m_is_too_large_for_trigram_index = true;
+        return false;
+    }
+
+    std::vector<uint32_t> value_trigrams;
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto const& value = m_entries[i].get_value();
+        if (value.size() < 3) {
+            continue;
+        }
+
+        value_trigrams.clear();
+        for (size_t j = 0; j + 2 < value.size(); ++j) {
+            value_trigrams.push_back(get_trigram(value[j], value[j + 1], value[j + 2]));
+        }
+        std::sort(value_trigrams.begin(), value_trigrams.end());
+        auto const end = std::unique(value_trigrams.begin(), value_trigrams.end());
+        // Entries are visited in order of ID, so every posting list stays sorted
+        for (auto it = value_trigrams.begin(); it != end; ++it) {
+            m_trigram_to_ids[*it].push_back(static_cast<uint32_t>(i));
+        }
+    }
+    m_index_memory_usage
+            += m_trigram_to_ids.capacity() * (sizeof(*m_trigram_to_ids.begin()) + 1);
+    for (auto& [trigram, ids] : m_trigram_to_ids) {
+        ids.shrink_to_fit();
+        m_index_memory_usage += ids.capacity() * sizeof(uint32_t);
+    }
+    m_has_trigram_index = true;
+    return true;
+}
+
+template <typename DictionaryIdType, typename EntryType>
+void DictionaryReader<DictionaryIdType, EntryType>::get_wildcard_string_trigrams(
+        std::string const& wildcard_string,
+        std::vector<uint32_t>& trigrams
+) {
+    // Each run of literal characters between wildcards must appear contiguously in any matching
+    // value
+    std::string literal;
+    auto add_literal_trigrams = [&]() {
+        for (size_t i = 0; i + 2 < literal.size(); ++i) {
+            trigrams.push_back(get_trigram(literal[i], literal[i + 1], literal[i + 2]));
+        }
+        literal.clear();
+    };
+    bool escape = false;
+    for (char const c : wildcard_string) {
+        if (escape) {
+            literal.push_back(c);
+            escape = false;
+        } else if ('\\' == c) {
+            escape = true;
+        } else if (StringUtils::is_wildcard(c)) {
+            add_literal_trigrams();
+        } else {
+            literal.push_back(c);
+        }
+    }
+    add_literal_trigrams();
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
 }  // namespace clp_s
 
 #endif  // CLP_S_DICTIONARYREADER_HPP
@@ -35,6 +35,19 @@ bool VariableDictionaryWriter::add_entry(std::string const& value, uint64_t& id)
     return new_entry;
 }
 
+size_t VariableDictionaryWriter::store_filter(std::string const& filter_path) const {
+    BloomFilter filter(m_value_to_id.size());
+    for (auto const& [value, id] : m_value_to_id) {
+        filter.add(value);
+    }
+
+    FileWriter filter_file_writer;
+    filter_file_writer.open(filter_path, FileWriter::OpenMode::CreateForWriting);
+    auto const filter_size = filter.write(filter_file_writer);
+    filter_file_writer.close();
+    return filter_size;
+}
+
 bool LogTypeDictionaryWriter::add_entry(
         LogTypeDictionaryEntry& logtype_entry,
         uint64_t& logtype_id
@@ -3,6 +3,7 @@
 #ifndef CLP_S_DICTIONARYWRITER_HPP
 #define CLP_S_DICTIONARYWRITER_HPP
 
+#include "BloomFilter.hpp"
 #include "DictionaryEntry.hpp"
 
 namespace clp_s {
@@ -82,6 +83,14 @@ public:
      * @param id ID of the variable matching the given entry
      */
     bool add_entry(std::string const& value, uint64_t& id);
+
+    /**
+     * Writes a bloom filter over every value in the dictionary to the given path. Must be called
+     * before the dictionary is closed.
+     * @param filter_path
+     * @return the size of the filter in bytes
+     */
+    [[nodiscard]] size_t store_filter(std::string const& filter_path) const;
 };
 
 class LogTypeDictionaryWriter : public DictionaryWriter<uint64_t, LogTypeDictionaryEntry> {
@@ -0,0 +1,324 @@
+#include "IntegerEncoder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace clp_s {
+namespace {
+// Dictionary encoding is abandoned for columns with more distinct values than this
+constexpr size_t cMaxDictionarySize = 1ULL << 16;
+constexpr size_t cNumBitsPerWord = 64;
+
+/**
+ * @param range
+ * @return the number of bits required to represent every value in [0, range]
+ */
+uint8_t get_bit_width(uint64_t range) {
+    return static_cast<uint8_t>(cNumBitsPerWord - std::countl_zero(range));
+}
+
+/**
+ * @param num_values
+ * @param bit_width
+ * @return the number of 64-bit words required to bit-pack the given number of values
+ */
+size_t get_num_packed_words(size_t num_values, uint8_t bit_width) {
+    return (num_values * bit_width + cNumBitsPerWord - 1) / cNumBitsPerWord;
+}
+
+/**
+ * @param num_values
+ * @param bit_width
+ * @return the number of bytes written by `write_bit_packed`
+ */
+size_t get_bit_packed_size(size_t num_values, uint8_t bit_width) {
+    return sizeof(uint8_t) + get_num_packed_words(num_values, bit_width) * sizeof(uint64_t);
+}
+
+/**
+ * Bit-packs values and writes them to the compressor
+ * @tparam ValueGetter a callable taking an index and returning a value which fits in `bit_width`
+ * bits
+ * @param num_values
+ * @param bit_width
+ * @param get_value
+ * @param compressor
+ * @return the number of bytes written
+ */
+template <typename ValueGetter>
+size_t write_bit_packed(
+        size_t num_values,
+        uint8_t bit_width,
+        ValueGetter get_value,
+        ZstdCompressor& compressor
+) {
+    std::vector<uint64_t> words(get_num_packed_words(num_values, bit_width), 0);
+    if (bit_width > 0) {
+        for (size_t i = 0; i < num_values; ++i) {
+            uint64_t value = get_value(i);
+            size_t bit_pos = i * bit_width;
+            size_t word = bit_pos / cNumBitsPerWord;
+            size_t offset = bit_pos % cNumBitsPerWord;
+            words[word] |= value << offset;
+            if (offset + bit_width > cNumBitsPerWord) {
+                words[word + 1] |= value >> (cNumBitsPerWord - offset);
+            }
+        }
+    }
+
+    compressor.write_numeric_value(bit_width);
+    compressor.write(reinterpret_cast<char const*>(words.data()), words.size() * sizeof(uint64_t));
+    return get_bit_packed_size(num_values, bit_width);
+}
+
+/**
+ * Reads values written by `write_bit_packed`
+ * @tparam ValueSetter a callable taking an index and the unpacked value at that index
+ * @param reader
+ * @param num_values
+ * @param set_value
+ */
+template <typename ValueSetter>
+void read_bit_packed(BufferViewReader& reader, size_t num_values, ValueSetter set_value) {
+    auto bit_width = reader.read_value<uint8_t>();
+    if (bit_width > cNumBitsPerWord) {
+        throw IntegerEncoder::OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+    auto words = reader.read_unaligned_span<uint64_t>(get_num_packed_words(num_values, bit_width));
+
+    if (0 == bit_width) {
+        for (size_t i = 0; i < num_values; ++i) {
+            set_value(i, 0);
+        }
+        return;
+    }
+
+    uint64_t mask = cNumBitsPerWord == bit_width ? std::numeric_limits<uint64_t>::max()
+                                                 : (1ULL << bit_width) - 1;
+    for (size_t i = 0; i < num_values; ++i) {
+        size_t bit_pos = i * bit_width;
+        size_t word = bit_pos / cNumBitsPerWord;
+        size_t offset = bit_pos % cNumBitsPerWord;
+        uint64_t value = words[word] >> offset;
+        if (offset + bit_width > cNumBitsPerWord) {
+            value |= words[word + 1] << (cNumBitsPerWord - offset);
+        }
+        set_value(i, value & mask);
+    }
+}
+}  // namespace
+
+size_t IntegerEncoder::encode(std::span<int64_t const> values, ZstdCompressor& compressor) {
+    size_t const num_values = values.size();
+    size_t const raw_size = num_values * sizeof(int64_t);
+    if (0 == num_values) {
+        compressor.write_numeric_value(Encoding::Raw);
+        return sizeof(Encoding);
+    }
+
+    // Gather the statistics needed to size every encoding in one pass. Arithmetic is done on
+    // unsigned values so that differences wrap instead of overflowing.
+    int64_t min_value = values[0];
+    int64_t max_value = values[0];
+    int64_t min_delta = std::numeric_limits<int64_t>::max();
+    int64_t max_delta = std::numeric_limits<int64_t>::min();
+    size_t num_runs = 1;
+    for (size_t i = 1; i < num_values; ++i) {
+        auto value = values[i];
+        min_value = std::min(min_value, value);
+        max_value = std::max(max_value, value);
+        auto delta = static_cast<int64_t>(
+                static_cast<uint64_t>(value) - static_cast<uint64_t>(values[i - 1])
+        );
+        min_delta = std::min(min_delta, delta);
+        max_delta = std::max(max_delta, delta);
+        if (value != values[i - 1]) {
+            ++num_runs;
+        }
+    }
+
+    auto for_bit_width
+            = get_bit_width(static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value));
+    size_t for_size = sizeof(int64_t) + get_bit_packed_size(num_values, for_bit_width);
+
+    uint8_t delta_bit_width{0};
+    if (num_values > 1) {
+        delta_bit_width = get_bit_width(
+                static_cast<uint64_t>(max_delta) - static_cast<uint64_t>(min_delta)
+        );
+    } else {
+        min_delta = 0;
+    }
+    size_t delta_size
+            = 2 * sizeof(int64_t) + get_bit_packed_size(num_values - 1, delta_bit_width);
+
+    size_t run_length_size = sizeof(uint64_t) + num_runs * (sizeof(int64_t) + sizeof(uint64_t));
+
+    Encoding encoding{Encoding::Raw};
+    size_t encoded_size{raw_size};
+    auto consider = [&](Encoding candidate, size_t candidate_size) {
+        if (candidate_size < encoded_size) {
+            encoding = candidate;
+            encoded_size = candidate_size;
+        }
+    };
+    consider(Encoding::FrameOfReference, for_size);
+    consider(Encoding::Delta, delta_size);
+    consider(Encoding::RunLength, run_length_size);
+
+    absl::flat_hash_map<int64_t, uint64_t> value_to_index;
+    std::vector<int64_t> dictionary;
+    for (auto value : values) {
+        if (value_to_index.try_emplace(value, dictionary.size()).second) {
+            dictionary.push_back(value);
+            if (dictionary.size() > cMaxDictionarySize) {
+                break;
+            }
+        }
+    }
+    if (dictionary.size() <= cMaxDictionarySize) {
+        auto index_bit_width = get_bit_width(dictionary.size() - 1);
+        consider(
+                Encoding::Dictionary,
+                sizeof(uint64_t) + dictionary.size() * sizeof(int64_t)
+                        + get_bit_packed_size(num_values, index_bit_width)
+        );
+    }
+
+    compressor.write_numeric_value(encoding);
+    switch (encoding) {
+        case Encoding::Raw:
+            compressor.write(reinterpret_cast<char const*>(values.data()), raw_size);
+            break;
+        case Encoding::FrameOfReference:
+            compressor.write_numeric_value(min_value);
+            write_bit_packed(
+                    num_values,
+                    for_bit_width,
+                    [&](size_t i) -> uint64_t {
+                        return static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(min_value);
+                    },
+                    compressor
+            );
+            break;
+        case Encoding::Delta:
+            compressor.write_numeric_value(values[0]);
+            compressor.write_numeric_value(min_delta);
+            write_bit_packed(
+                    num_values - 1,
+                    delta_bit_width,
+                    [&](size_t i) -> uint64_t {
+                        return static_cast<uint64_t>(values[i + 1])
+                               - static_cast<uint64_t>(values[i])
+                               - static_cast<uint64_t>(min_delta);
+                    },
+                    compressor
+            );
+            break;
+        case Encoding::RunLength: {
+            std::vector<int64_t> run_values;
+            std::vector<uint64_t> run_lengths;
+            run_values.reserve(num_runs);
+            run_lengths.reserve(num_runs);
+            for (auto value : values) {
+                if (false == run_values.empty() && run_values.back() == value) {
+                    ++run_lengths.back();
+                } else {
+                    run_values.push_back(value);
+                    run_lengths.push_back(1);
+                }
+            }
+            compressor.write_numeric_value(static_cast<uint64_t>(num_runs));
+            compressor.write(
+                    reinterpret_cast<char const*>(run_values.data()),
+                    num_runs * sizeof(int64_t)
+            );
+            compressor.write(
+                    reinterpret_cast<char const*>(run_lengths.data()),
+                    num_runs * sizeof(uint64_t)
+            );
+            break;
+        }
+        case Encoding::Dictionary:
+            compressor.write_numeric_value(static_cast<uint64_t>(dictionary.size()));
+            compressor.write(
+                    reinterpret_cast<char const*>(dictionary.data()),
+                    dictionary.size() * sizeof(int64_t)
+            );
+            write_bit_packed(
+                    num_values,
+                    get_bit_width(dictionary.size() - 1),
+                    [&](size_t i) -> uint64_t { return value_to_index.find(values[i])->second; },
+                    compressor
+            );
+            break;
+    }
+    return sizeof(Encoding) + encoded_size;
+}
+
+void IntegerEncoder::decode_into(
+        Encoding encoding,
+        BufferViewReader& reader,
+        size_t num_values,
+        std::vector<int64_t>& decoded_values
+) {
+    decoded_values.resize(num_values);
+    switch (encoding) {
+        case Encoding::FrameOfReference: {
+            auto base = static_cast<uint64_t>(reader.read_value<int64_t>());
+            read_bit_packed(reader, num_values, [&](size_t i, uint64_t value) {
+                decoded_values[i] = static_cast<int64_t>(base + value);
+            });
+            break;
+        }
+        case Encoding::Delta: {
+            auto first_value = reader.read_value<int64_t>();
+            auto min_delta = static_cast<uint64_t>(reader.read_value<int64_t>());
+            if (0 == num_values) {
+                throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+            }
+            decoded_values[0] = first_value;
+            read_bit_packed(reader, num_values - 1, [&](size_t i, uint64_t value) {
+                decoded_values[i + 1] = static_cast<int64_t>(
+                        static_cast<uint64_t>(decoded_values[i]) + min_delta + value
+                );
+            });
+            break;
+        }
+        case Encoding::RunLength: {
+            auto num_runs = reader.read_value<uint64_t>();
+            auto run_values = reader.read_unaligned_span<int64_t>(num_runs);
+            auto run_lengths = reader.read_unaligned_span<uint64_t>(num_runs);
+            size_t value_idx = 0;
+            for (size_t run = 0; run < num_runs; ++run) {
+                auto run_length = run_lengths[run];
+                if (run_length > num_values - value_idx) {
+                    throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+                }
+                std::fill_n(decoded_values.begin() + value_idx, run_length, run_values[run]);
+                value_idx += run_length;
+            }
+            if (value_idx != num_values) {
+                throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+            }
+            break;
+        }
+        case Encoding::Dictionary: {
+            auto dictionary_size = reader.read_value<uint64_t>();
+            auto dictionary = reader.read_unaligned_span<int64_t>(dictionary_size);
+            read_bit_packed(reader, num_values, [&](size_t i, uint64_t index) {
+                if (index >= dictionary_size) {
+                    throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+                }
+                decoded_values[i] = dictionary[index];
+            });
+            break;
+        }
+        default:
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+}
+}  // namespace clp_s
@@ -0,0 +1,98 @@
+#ifndef CLP_S_INTEGERENCODER_HPP
+#define CLP_S_INTEGERENCODER_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "BufferViewReader.hpp"
+#include "TraceableException.hpp"
+#include "Utils.hpp"
+#include "ZstdCompressor.hpp"
+
+namespace clp_s {
+/**
+ * Lightweight encodings for columns of 64-bit values. The encoding which produces the smallest
+ * output is chosen for each column when it's stored, and is recorded in a one byte header in front
+ * of the column's data.
+ *
+ * Encoded layouts (all multi-byte values are in native byte order):
+ * - Raw: the values as-is.
+ * - FrameOfReference: the minimum value followed by every value's offset from the minimum,
+ *   bit-packed.
+ * - Delta: the first value and the minimum difference between consecutive values, followed by
+ *   every difference's offset from that minimum, bit-packed.
+ * - RunLength: the number of runs followed by each run's value and each run's length.
+ * - Dictionary: the number of distinct values, the distinct values, and then every value's index
+ *   into the distinct values, bit-packed.
+ *
+ * Bit-packed sequences start with a one byte bit width followed by the packed 64-bit words.
+ */
+class IntegerEncoder {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    enum class Encoding : uint8_t {
+        Raw = 0,
+        FrameOfReference,
+        Delta,
+        RunLength,
+        Dictionary
+    };
+
+    /**
+     * Encodes the given values using the encoding with the smallest output and writes the result
+     * to the compressor
+     * @param values
+     * @param compressor
+     * @return the number of bytes written to the compressor
+     */
+    static size_t encode(std::span<int64_t const> values, ZstdCompressor& compressor);
+
+    /**
+     * Decodes values written by `encode`. Raw columns are returned as a view into the reader's
+     * buffer; all other encodings are decoded into `decoded_values`, which the returned span
+     * refers to.
+     * @tparam T a 64-bit type to reinterpret the encoded values as
+     * @param reader
+     * @param num_values
+     * @param decoded_values
+     * @return a span over the decoded values
+     * @throw OperationFailed if the encoding is unknown or the encoded data is corrupt
+     */
+    template <typename T>
+    static UnalignedMemSpan<T>
+    decode(BufferViewReader& reader, size_t num_values, std::vector<int64_t>& decoded_values) {
+        static_assert(sizeof(T) == sizeof(int64_t));
+        auto encoding = static_cast<Encoding>(reader.read_value<uint8_t>());
+        if (Encoding::Raw == encoding) {
+            return reader.read_unaligned_span<T>(num_values);
+        }
+        decode_into(encoding, reader, num_values, decoded_values);
+        return {reinterpret_cast<char*>(decoded_values.data()), num_values};
+    }
+
+private:
+    /**
+     * Decodes non-raw encoded values into `decoded_values`
+     * @param encoding
+     * @param reader
+     * @param num_values
+     * @param decoded_values
+     */
+    static void decode_into(
+            Encoding encoding,
+            BufferViewReader& reader,
+            size_t num_values,
+            std::vector<int64_t>& decoded_values
+    );
+};
+}  // namespace clp_s
+
+#endif  // CLP_S_INTEGERENCODER_HPP
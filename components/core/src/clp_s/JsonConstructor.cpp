@@ -1,7 +1,9 @@
 #include "JsonConstructor.hpp"
 
+#include <algorithm>
+#include <deque>
 #include <filesystem>
-#include <queue>
+#include <future>
 #include <system_error>
 
 #include <fmt/core.h>
@@ -16,6 +18,7 @@ JsonConstructor::JsonConstructor(JsonConstructorOption const& option)
         : m_output_dir(option.output_dir),
           m_archives_dir(option.archives_dir),
           m_ordered{option.ordered},
+          m_num_threads{std::max<size_t>(option.num_threads, 1)},
           m_archive_id(option.archive_id) {
     std::error_code error_code;
     if (false == std::filesystem::create_directory(option.output_dir, error_code) && error_code) {
@@ -51,10 +54,12 @@ void JsonConstructor::store() {
     m_archive_reader = std::make_unique<ArchiveReader>();
     m_archive_reader->open(m_archives_dir, m_archive_id);
     m_archive_reader->read_dictionaries_and_metadata();
-    if (false == m_ordered) {
-        m_archive_reader->store(writer);
-    } else {
+    if (m_ordered) {
         construct_in_order(writer);
+    } else if (m_num_threads > 1) {
+        construct_in_parallel(writer);
+    } else {
+        m_archive_reader->store(writer);
     }
     m_archive_reader->close();
 
@@ -62,25 +67,120 @@ void JsonConstructor::store() {
 }
 
 void JsonConstructor::construct_in_order(FileWriter& writer) {
-    std::string buffer;
-    auto tables = m_archive_reader->read_all_tables();
-    using ReaderPointer = std::shared_ptr<SchemaReader>;
-    auto cmp = [](ReaderPointer& left, ReaderPointer& right) {
-        return left->get_next_timestamp() > right->get_next_timestamp();
+    // The position of a table in the merge. Until its next row group is loaded, a table is ordered
+    // by the earliest timestamp in that row group.
+    struct TableCursor {
+        int32_t schema_id;
+        size_t num_row_groups;
+        size_t next_row_group;
+        std::unique_ptr<SchemaReader> reader;
+        epochtime_t next_timestamp;
+    };
+    auto get_row_group_begin_timestamp = [&](TableCursor const& cursor) {
+        auto const& table_metadata = m_archive_reader->get_table_metadata(cursor.schema_id);
+        return m_archive_reader
+                ->get_row_group_begin_timestamp(
+                        cursor.schema_id,
+                        table_metadata.row_groups[cursor.next_row_group]
+                )
+                .value_or(cEpochTimeMin);
     };
-    std::priority_queue record_queue(tables.begin(), tables.end(), cmp);
-    // Clear tables vector so that memory gets deallocated after we have marshalled all records for
-    // a given table
-    tables.clear();
+
+    std::vector<TableCursor> record_queue;
+    for (int32_t schema_id : m_archive_reader->get_schema_ids()) {
+        auto const& table_metadata = m_archive_reader->get_table_metadata(schema_id);
+        if (table_metadata.row_groups.empty()) {
+            continue;
+        }
+        TableCursor cursor{schema_id, table_metadata.row_groups.size(), 0, nullptr, 0};
+        cursor.next_timestamp = get_row_group_begin_timestamp(cursor);
+        record_queue.push_back(std::move(cursor));
+    }
+    auto cmp = [](TableCursor const& left, TableCursor const& right) {
+        return left.next_timestamp > right.next_timestamp;
+    };
+    std::make_heap(record_queue.begin(), record_queue.end(), cmp);
+
+    std::string buffer;
     while (false == record_queue.empty()) {
-        ReaderPointer next = record_queue.top();
-        record_queue.pop();
-        next->get_next_message(buffer);
-        if (false == next->done()) {
-            record_queue.emplace(std::move(next));
+        std::pop_heap(record_queue.begin(), record_queue.end(), cmp);
+        auto& cursor = record_queue.back();
+        if (nullptr == cursor.reader) {
+            cursor.reader = get_schema_reader();
+            m_archive_reader->read_row_group(
+                    *cursor.reader,
+                    cursor.schema_id,
+                    cursor.next_row_group++,
+                    true,
+                    true
+            );
+        } else {
+            cursor.reader->get_next_message(buffer);
+            writer.write(buffer.c_str(), buffer.length());
+        }
+
+        if (false == cursor.reader->done()) {
+            cursor.next_timestamp = cursor.reader->get_next_timestamp();
+        } else {
+            // Return the reader to the pool so that its buffers are reused by the next row group
+            m_schema_reader_pool.push_back(std::move(cursor.reader));
+            if (cursor.next_row_group == cursor.num_row_groups) {
+                record_queue.pop_back();
+                continue;
+            }
+            cursor.next_timestamp = get_row_group_begin_timestamp(cursor);
         }
-        writer.write(buffer.c_str(), buffer.length());
+        std::push_heap(record_queue.begin(), record_queue.end(), cmp);
     }
-    writer.close();
+}
+
+void JsonConstructor::construct_in_parallel(FileWriter& writer) {
+    struct MarshalledRowGroup {
+        std::unique_ptr<SchemaReader> reader;
+        std::string records;
+    };
+
+    std::vector<std::pair<int32_t, size_t>> row_groups;
+    for (int32_t schema_id : m_archive_reader->get_schema_ids()) {
+        auto const& table_metadata = m_archive_reader->get_table_metadata(schema_id);
+        for (size_t row_group = 0; row_group < table_metadata.row_groups.size(); ++row_group) {
+            row_groups.emplace_back(schema_id, row_group);
+        }
+    }
+
+    // Keep at most m_num_threads row groups in flight so that memory use doesn't grow with the
+    // size of the archive
+    std::deque<std::future<MarshalledRowGroup>> pending_row_groups;
+    size_t next_row_group = 0;
+    while (next_row_group < row_groups.size() || false == pending_row_groups.empty()) {
+        while (next_row_group < row_groups.size() && pending_row_groups.size() < m_num_threads) {
+            auto [schema_id, row_group] = row_groups[next_row_group++];
+            auto marshal = [=, this, reader = get_schema_reader()]() mutable {
+                m_archive_reader->read_row_group(*reader, schema_id, row_group, false, true);
+                MarshalledRowGroup marshalled_row_group{std::move(reader)};
+                std::string message;
+                while (marshalled_row_group.reader->get_next_message(message)) {
+                    marshalled_row_group.records += message;
+                }
+                return marshalled_row_group;
+            };
+            pending_row_groups.emplace_back(std::async(std::launch::async, std::move(marshal)));
+        }
+
+        auto marshalled_row_group = pending_row_groups.front().get();
+        pending_row_groups.pop_front();
+        auto const& records = marshalled_row_group.records;
+        writer.write(records.c_str(), records.length());
+        m_schema_reader_pool.push_back(std::move(marshalled_row_group.reader));
+    }
+}
+
+std::unique_ptr<SchemaReader> JsonConstructor::get_schema_reader() {
+    if (m_schema_reader_pool.empty()) {
+        return std::make_unique<SchemaReader>();
+    }
+    auto reader = std::move(m_schema_reader_pool.back());
+    m_schema_reader_pool.pop_back();
+    return reader;
 }
 }  // namespace clp_s
@@ -1,9 +1,11 @@
 #ifndef CLP_S_JSONCONSTRUCTOR_HPP
 #define CLP_S_JSONCONSTRUCTOR_HPP
 
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "ArchiveReader.hpp"
 #include "ColumnReader.hpp"
@@ -20,6 +22,7 @@ struct JsonConstructorOption {
     std::string archive_id;
     std::string output_dir;
     bool ordered;
+    size_t num_threads;
 };
 
 class JsonConstructor {
@@ -53,18 +56,35 @@ public:
 
 private:
     /**
-     * Reads all of the tables from m_archive_reader and writes all of the records
-     * they contain to writer in timestamp order.
+     * Writes all of the records in m_archive_reader to writer in timestamp order. The records of
+     * each table are merged with those of the others one row group at a time, and a table's next
+     * row group isn't loaded until the merge reaches the earliest timestamp it contains, so only
+     * the row groups which overlap in time are held in memory at once.
      * @param writer
      */
     void construct_in_order(FileWriter& writer);
 
+    /**
+     * Writes all of the records in m_archive_reader to writer in the order they're stored. Row
+     * groups are loaded and marshalled by m_num_threads threads at once, and are written out in
+     * order as they complete.
+     * @param writer
+     */
+    void construct_in_parallel(FileWriter& writer);
+
+    /**
+     * @return a schema reader from m_schema_reader_pool, or a new schema reader if it's empty
+     */
+    std::unique_ptr<SchemaReader> get_schema_reader();
+
     std::string m_archives_dir;
     std::string m_archive_id;
     std::string m_output_dir;
     bool m_ordered{false};
+    size_t m_num_threads{1};
 
     std::unique_ptr<ArchiveReader> m_archive_reader;
+    std::vector<std::unique_ptr<SchemaReader>> m_schema_reader_pool;
 };
 }  // namespace clp_s
 
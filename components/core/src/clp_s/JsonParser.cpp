@@ -1,5 +1,6 @@
 #include "JsonParser.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <stack>
 
@@ -17,11 +18,24 @@ JsonParser::JsonParser(JsonParserOption const& option)
           m_target_encoded_size(option.target_encoded_size),
           m_max_document_size(option.max_document_size),
           m_timestamp_key(option.timestamp_key),
-          m_structurize_arrays(option.structurize_arrays) {
+          m_metadata_db(option.metadata_db),
+          m_max_pending_archives(option.max_pending_archives),
+          m_row_group_size(option.row_group_size),
+          m_max_buffered_table_size(option.max_buffered_table_size),
+          m_print_archive_stats(option.print_archive_stats),
+          m_structurize_arrays(option.structurize_arrays),
+          m_sort_by_timestamp(option.sort_by_timestamp),
+          m_num_threads(std::max<size_t>(option.num_threads, 1)) {
     if (false == FileUtils::validate_path(option.file_paths)) {
         exit(1);
     }
 
+    // The threads are split equally between the archive being written and the archives being
+    // finalized in the background, so that together they never use more than the given number of
+    // threads. Since parsing takes a thread, finalizing in the background needs at least two.
+    m_max_pending_archives = std::min(m_max_pending_archives, m_num_threads - 1);
+    m_num_threads /= m_max_pending_archives + 1;
+
     if (false == m_timestamp_key.empty()) {
         clp_s::StringUtils::tokenize_column_descriptor(m_timestamp_key, m_timestamp_column);
     }
@@ -30,14 +44,7 @@ JsonParser::JsonParser(JsonParserOption const& option)
         FileUtils::find_all_files(file_path, m_file_paths);
     }
 
-    ArchiveWriterOption archive_writer_option;
-    archive_writer_option.archives_dir = m_archives_dir;
-    archive_writer_option.id = m_generator();
-    archive_writer_option.compression_level = option.compression_level;
-    archive_writer_option.print_archive_stats = option.print_archive_stats;
-
-    m_archive_writer = std::make_unique<ArchiveWriter>(option.metadata_db);
-    m_archive_writer->open(archive_writer_option);
+    open_archive_writer();
 }
 
 void JsonParser::parse_obj_in_array(ondemand::object line, int32_t parent_node_id) {
@@ -58,7 +65,7 @@ void JsonParser::parse_obj_in_array(ondemand::object line, int32_t parent_node_i
     size_t object_start = m_current_schema.start_unordered_object(NodeType::Object);
     ondemand::field cur_field;
     ondemand::value cur_value;
-    std::string cur_key;
+    std::string_view cur_key;
     int32_t node_id;
     while (true) {
         while (false == object_stack.empty() && object_it_stack.top() == object_stack.top().end()) {
@@ -126,10 +133,9 @@ void JsonParser::parse_obj_in_array(ondemand::object line, int32_t parent_node_i
                 break;
             }
             case ondemand::json_type::string: {
-                std::string value = std::string(
-                        cur_value.raw_json_token().substr(1, cur_value.raw_json_token().size() - 2)
-                );
-                if (value.find(' ') != std::string::npos) {
+                auto raw_json_token = cur_value.raw_json_token();
+                std::string_view value = raw_json_token.substr(1, raw_json_token.size() - 2);
+                if (value.find(' ') != std::string_view::npos) {
                     node_id = m_archive_writer
                                       ->add_node(node_id_stack.top(), NodeType::ClpString, cur_key);
                 } else {
@@ -204,10 +210,9 @@ void JsonParser::parse_array(ondemand::array array, int32_t parent_node_id) {
                 break;
             }
             case ondemand::json_type::string: {
-                std::string value = std::string(
-                        cur_value.raw_json_token().substr(1, cur_value.raw_json_token().size() - 2)
-                );
-                if (value.find(' ') != std::string::npos) {
+                auto raw_json_token = cur_value.raw_json_token();
+                std::string_view value = raw_json_token.substr(1, raw_json_token.size() - 2);
+                if (value.find(' ') != std::string_view::npos) {
                     node_id = m_archive_writer->add_node(parent_node_id, NodeType::ClpString, "");
                 } else {
                     node_id = m_archive_writer->add_node(parent_node_id, NodeType::VarString, "");
@@ -233,7 +238,7 @@ void JsonParser::parse_array(ondemand::array array, int32_t parent_node_id) {
     m_current_schema.end_unordered_object(array_start);
 }
 
-void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::string const& key) {
+void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::string_view key) {
     int32_t node_id;
     std::stack<ondemand::object> object_stack;
     std::stack<int32_t> node_id_stack;
@@ -241,7 +246,7 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
 
     ondemand::field cur_field;
 
-    std::string cur_key = key;
+    std::string_view cur_key = key;
     node_id_stack.push(parent_node_id);
 
     bool can_match_timestamp = !m_timestamp_column.empty();
@@ -252,7 +257,7 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
     do {
         if (false == object_stack.empty()) {
             cur_field = *object_it_stack.top();
-            cur_key = std::string(std::string_view(cur_field.unescaped_key(true)));
+            cur_key = std::string_view(cur_field.unescaped_key(true));
             line = cur_field.value();
             if (may_match_timestamp) {
                 if (object_stack.size() <= m_timestamp_column.size()
@@ -297,8 +302,7 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
                     );
                     parse_array(std::move(line.get_array()), node_id);
                 } else {
-                    std::string value
-                            = std::string(std::string_view(simdjson::to_json_string(line)));
+                    std::string_view value = std::string_view(simdjson::to_json_string(line));
                     node_id = m_archive_writer->add_node(
                             node_id_stack.top(),
                             NodeType::UnstructuredArray,
@@ -349,8 +353,7 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
             }
             case ondemand::json_type::string: {
                 auto raw_json_token = line.raw_json_token();
-                std::string value
-                        = std::string(raw_json_token.substr(1, raw_json_token.rfind('"') - 1));
+                std::string_view value = raw_json_token.substr(1, raw_json_token.rfind('"') - 1);
 
                 if (matches_timestamp) {
                     node_id = m_archive_writer->add_node(
@@ -362,12 +365,12 @@ void JsonParser::parse_line(ondemand::value line, int32_t parent_node_id, std::s
                     epochtime_t timestamp = m_archive_writer->ingest_timestamp_entry(
                             m_timestamp_key,
                             node_id,
-                            value,
+                            std::string{value},
                             encoding_id
                     );
                     m_current_parsed_message.add_value(node_id, encoding_id, timestamp);
                     matches_timestamp = may_match_timestamp = can_match_timestamp = false;
-                } else if (value.find(' ') != std::string::npos) {
+                } else if (value.find(' ') != std::string_view::npos) {
                     node_id = m_archive_writer
                                       ->add_node(node_id_stack.top(), NodeType::ClpString, cur_key);
                     m_current_parsed_message.add_value(node_id, value);
@@ -436,6 +439,7 @@ bool JsonParser::parse() {
                     file_path
             );
             m_archive_writer->close();
+            wait_for_pending_archives();
             return false;
         }
 
@@ -455,8 +459,10 @@ bool JsonParser::parse() {
             if (is_scalar_result.error() || true == is_scalar_result.value()) {
                 SPDLOG_ERROR("Encountered non-json-object while trying to parse {}", file_path);
                 m_archive_writer->close();
+                wait_for_pending_archives();
                 return false;
             }
+            m_archive_writer->start_record();
             parse_line(ref.value(), -1, "");
             m_num_messages++;
 
@@ -486,6 +492,7 @@ bool JsonParser::parse() {
                     file_path
             );
             m_archive_writer->close();
+            wait_for_pending_archives();
             return false;
         } else if (json_file_iterator.truncated_bytes() > 0) {
             // currently don't treat truncated bytes at the end of the file as an error
@@ -501,17 +508,51 @@ bool JsonParser::parse() {
 
 void JsonParser::store() {
     m_archive_writer->close();
+    wait_for_pending_archives();
 }
 
 void JsonParser::split_archive() {
-    m_archive_writer->close();
+    finalize_archive();
+    open_archive_writer();
+}
 
+void JsonParser::open_archive_writer() {
     ArchiveWriterOption archive_writer_option;
     archive_writer_option.archives_dir = m_archives_dir;
     archive_writer_option.id = m_generator();
     archive_writer_option.compression_level = m_compression_level;
+    archive_writer_option.print_archive_stats = m_print_archive_stats;
+    archive_writer_option.row_group_size = m_row_group_size;
+    archive_writer_option.max_buffered_table_size = m_max_buffered_table_size;
+    archive_writer_option.sort_by_timestamp = m_sort_by_timestamp;
+    archive_writer_option.num_threads = m_num_threads;
 
+    m_archive_writer = std::make_unique<ArchiveWriter>(m_metadata_db);
     m_archive_writer->open(archive_writer_option);
 }
 
+void JsonParser::finalize_archive() {
+    if (0 == m_max_pending_archives) {
+        m_archive_writer->close();
+        return;
+    }
+
+    // Bound the number of archives held in memory while they're being finalized
+    while (m_pending_archives.size() >= m_max_pending_archives) {
+        m_pending_archives.front().get();
+        m_pending_archives.pop_front();
+    }
+    m_pending_archives.emplace_back(std::async(
+            std::launch::async,
+            [archive_writer = std::move(m_archive_writer)]() { archive_writer->close(); }
+    ));
+}
+
+void JsonParser::wait_for_pending_archives() {
+    while (false == m_pending_archives.empty()) {
+        m_pending_archives.front().get();
+        m_pending_archives.pop_front();
+    }
+}
+
 }  // namespace clp_s
@@ -1,8 +1,11 @@
 #ifndef CLP_S_JSONPARSER_HPP
 #define CLP_S_JSONPARSER_HPP
 
+#include <deque>
+#include <future>
 #include <map>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -35,6 +38,11 @@ struct JsonParserOption {
     int compression_level;
     bool print_archive_stats;
     bool structurize_arrays;
+    size_t max_pending_archives;
+    size_t row_group_size;
+    size_t max_buffered_table_size;
+    bool sort_by_timestamp;
+    size_t num_threads;
     std::shared_ptr<clp::GlobalMySQLMetadataDB> metadata_db;
 };
 
@@ -71,7 +79,7 @@ private:
      * @param parent_node_id the parent node id
      * @param key the key of the node
      */
-    void parse_line(ondemand::value line, int32_t parent_node_id, std::string const& key);
+    void parse_line(ondemand::value line, int32_t parent_node_id, std::string_view key);
 
     /**
      * Parses an array within a JSON line
@@ -92,6 +100,23 @@ private:
      */
     void split_archive();
 
+    /**
+     * Opens m_archive_writer for a new archive
+     */
+    void open_archive_writer();
+
+    /**
+     * Closes the current archive. If background finalization is enabled, the archive is closed on
+     * a separate thread, using the threads it was given when it was opened, once fewer than
+     * m_max_pending_archives archives are being finalized.
+     */
+    void finalize_archive();
+
+    /**
+     * Waits for all archives being finalized in the background to be closed
+     */
+    void wait_for_pending_archives();
+
     int m_num_messages;
     int m_compression_level;
     std::vector<std::string> m_file_paths;
@@ -106,9 +131,18 @@ private:
 
     boost::uuids::random_generator m_generator;
     std::unique_ptr<ArchiveWriter> m_archive_writer;
+    std::shared_ptr<clp::GlobalMySQLMetadataDB> m_metadata_db;
+    std::deque<std::future<void>> m_pending_archives;
+    size_t m_max_pending_archives{0};
+    size_t m_row_group_size{0};
+    size_t m_max_buffered_table_size{0};
     size_t m_target_encoded_size;
     size_t m_max_document_size;
+    bool m_print_archive_stats{false};
     bool m_structurize_arrays{false};
+    bool m_sort_by_timestamp{false};
+    // The number of threads given to each archive writer
+    size_t m_num_threads{1};
 };
 }  // namespace clp_s
 
@@ -1,19 +1,27 @@
 #ifndef CLP_S_PARSEDMESSAGE_HPP
 #define CLP_S_PARSEDMESSAGE_HPP
 
-#include <map>
-#include <string>
+#include <algorithm>
+#include <string_view>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "Defs.hpp"
 
 namespace clp_s {
+/**
+ * The values of a parsed record, keyed by MST node ID. Messages are meant to be cleared and reused
+ * for every record so that their storage is only allocated once.
+ *
+ * String values are views into the buffer the record was parsed from, so they're only valid until
+ * the next record is parsed.
+ */
 class ParsedMessage {
 public:
     // Types
-    using variable_t
-            = std::variant<int64_t, double, std::string, bool, std::pair<uint64_t, epochtime_t>>;
+    using variable_t = std::
+            variant<int64_t, double, std::string_view, bool, std::pair<uint64_t, epochtime_t>>;
 
     // Constructor
     ParsedMessage() : m_schema_id(-1) {}
@@ -31,7 +39,10 @@ public:
      */
     template <typename T>
     inline void add_value(int32_t node_id, T const& value) {
-        m_message.emplace(node_id, value);
+        if (false == m_message.empty() && m_message.back().first >= node_id) {
+            m_is_sorted = false;
+        }
+        m_message.emplace_back(node_id, value);
     }
 
     /**
@@ -41,7 +52,7 @@ public:
      * @param value
      */
     inline void add_value(int32_t node_id, uint64_t encoding_id, epochtime_t value) {
-        m_message.emplace(node_id, std::make_pair(encoding_id, value));
+        add_value(node_id, std::make_pair(encoding_id, value));
     }
 
     /**
@@ -61,13 +72,29 @@ public:
     void clear() {
         m_schema_id = -1;
         m_message.clear();
+        m_is_sorted = true;
         m_unordered_message.clear();
     }
 
     /**
-     * @return The content of the message
+     * @return The content of the message, ordered by MST node ID. If a node was given several
+     * values, only the first is kept.
      */
-    std::map<int32_t, variable_t>& get_content() { return m_message; }
+    std::vector<std::pair<int32_t, variable_t>>& get_content() {
+        if (false == m_is_sorted) {
+            std::stable_sort(m_message.begin(), m_message.end(), [](auto const& a, auto const& b) {
+                return a.first < b.first;
+            });
+            auto const duplicates_begin = std::unique(
+                    m_message.begin(),
+                    m_message.end(),
+                    [](auto const& a, auto const& b) { return a.first == b.first; }
+            );
+            m_message.erase(duplicates_begin, m_message.end());
+            m_is_sorted = true;
+        }
+        return m_message;
+    }
 
     /**
      * @return the unordered content of the message
@@ -76,7 +103,10 @@ public:
 
 private:
     int32_t m_schema_id;
-    std::map<int32_t, variable_t> m_message;
+    std::vector<std::pair<int32_t, variable_t>> m_message;
+    // Whether m_message is ordered by node ID, which is usually the case since nodes are created
+    // in the order their keys are first seen
+    bool m_is_sorted{true};
     std::vector<variable_t> m_unordered_message;
 };
 }  // namespace clp_s
@@ -85,6 +85,37 @@ std::shared_ptr<TimestampDictionaryReader> ReaderUtils::get_timestamp_dictionary
     return reader;
 }
 
+std::shared_ptr<BloomFilter> ReaderUtils::read_variable_dictionary_filter(
+        std::string const& archive_path
+) {
+    FileReader filter_reader;
+    auto const error_code
+            = filter_reader.try_open(archive_path + constants::cArchiveVarDictFilterFile);
+    if (ErrorCodeFileNotFound == error_code) {
+        // Archives written before filters were added don't have one
+        return nullptr;
+    }
+    if (ErrorCodeSuccess != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+
+    auto filter = std::make_shared<BloomFilter>();
+    filter->read(filter_reader);
+    return filter;
+}
+
+uint64_t ReaderUtils::read_num_dictionary_entries(std::string const& dictionary_path) {
+    FileReader dictionary_reader;
+    dictionary_reader.open(dictionary_path);
+
+    uint64_t num_entries;
+    auto const error_code = dictionary_reader.try_read_numeric_value(num_entries);
+    if (ErrorCodeSuccess != error_code) {
+        throw OperationFailed(error_code, __FILENAME__, __LINE__);
+    }
+    return num_entries;
+}
+
 std::shared_ptr<ReaderUtils::SchemaMap> ReaderUtils::read_schemas(std::string const& archives_dir) {
     auto schemas_pointer = std::make_unique<SchemaMap>();
     SchemaMap& schemas = *schemas_pointer;
@@ -1,6 +1,7 @@
 #ifndef CLP_S_READERUTILS_HPP
 #define CLP_S_READERUTILS_HPP
 
+#include "BloomFilter.hpp"
 #include "DictionaryReader.hpp"
 #include "Schema.hpp"
 #include "SchemaReader.hpp"
@@ -66,6 +67,23 @@ public:
             std::string const& archive_path
     );
 
+    /**
+     * Reads the bloom filter over the variable dictionary's values for the given archive path
+     * @param archive_path
+     * @return the filter, or nullptr if the archive doesn't have one
+     */
+    static std::shared_ptr<BloomFilter> read_variable_dictionary_filter(
+            std::string const& archive_path
+    );
+
+    /**
+     * Reads the number of entries in the given dictionary from its header without reading any of
+     * the entries themselves
+     * @param dictionary_path
+     * @return the number of entries
+     */
+    static uint64_t read_num_dictionary_entries(std::string const& dictionary_path);
+
     /**
      * Gets the list of archives in the given archive directory
      * @param archives_dir
@@ -52,11 +52,12 @@ public:
     void clear() {
         m_schema.clear();
         m_num_ordered = 0;
+        m_hash = 0;
     }
 
     /**
      * Sets the number of ordered nodes present in the schema. This method is used during
-     * decompression to help initialize this object.
+     * decompression to help initialize this object, and doesn't update the schema's hash.
      * @param num_ordered
      */
     void set_num_ordered(size_t num_ordered) { m_num_ordered = num_ordered; }
@@ -126,7 +127,8 @@ public:
     }
 
     /**
-     * Resizes the internal schema vector to match the given length.
+     * Resizes the internal schema vector to match the given length. This method is used during
+     * decompression, and doesn't update the schema's hash.
      * @param size
      */
     void resize(size_t size) { m_schema.resize(size); }
@@ -143,7 +145,17 @@ public:
      * @return true if this schema is equal to the schema on the right hand side
      * @return false otherwise
      */
-    bool operator==(Schema const& rhs) const { return m_schema == rhs.m_schema; }
+    bool operator==(Schema const& rhs) const {
+        return m_hash == rhs.m_hash && m_num_ordered == rhs.m_num_ordered
+               && m_schema == rhs.m_schema;
+    }
+
+    /**
+     * The hash is maintained incrementally by the methods which insert nodes, so that looking up
+     * a schema doesn't require a pass over it.
+     * @return the hash of the schema
+     */
+    [[nodiscard]] size_t get_hash() const { return m_hash; }
 
     /**
      * Starts an unordered object of a given NodeType.
@@ -163,7 +175,11 @@ public:
      * @param start_position
      */
     void end_unordered_object(size_t start_position) {
-        m_schema[start_position - 1] |= static_cast<int32_t>(m_schema.size() - start_position);
+        auto& delimiter = m_schema[start_position - 1];
+        auto const unordered_position = start_position - 1 - m_num_ordered;
+        m_hash -= hash_unordered_entry(unordered_position, delimiter);
+        delimiter |= static_cast<int32_t>(m_schema.size() - start_position);
+        m_hash += hash_unordered_entry(unordered_position, delimiter);
     }
 
     /**
@@ -203,12 +219,45 @@ public:
     }
 
 private:
+    /**
+     * Mixes the bits of a value so that the sum of many mixed values is a good hash.
+     * @param value
+     * @return the mixed value
+     */
+    static uint64_t mix(uint64_t value) {
+        // The finalizer of splitmix64
+        value = (value ^ (value >> 30)) * 0xbf58'476d'1ce4'e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d0'49bb'1331'11ebULL;
+        return value ^ (value >> 31);
+    }
+
+    /**
+     * Ordered entries form a set, so they contribute to the hash regardless of their position.
+     * @param entry
+     * @return the contribution of an entry in the ordered region to the schema's hash
+     */
+    static uint64_t hash_ordered_entry(int32_t entry) {
+        return mix(static_cast<uint32_t>(entry));
+    }
+
+    /**
+     * @param unordered_position The position of the entry relative to the start of the unordered
+     * region
+     * @param entry
+     * @return the contribution of an entry in the unordered region to the schema's hash
+     */
+    static uint64_t hash_unordered_entry(size_t unordered_position, int32_t entry) {
+        return mix(((static_cast<uint64_t>(unordered_position) + 1) << 32)
+                   | static_cast<uint32_t>(entry));
+    }
+
     static constexpr size_t cEncodedTypeOffset = (sizeof(int32_t) - 1) * 8;
     static constexpr int32_t cEncodedTypeBitmask = 0xFF00'0000;
     static constexpr int32_t cEncodedTypeLengthBitmask = ~cEncodedTypeBitmask;
 
     std::vector<int32_t> m_schema;
     size_t m_num_ordered{0};
+    uint64_t m_hash{0};
 };
 }  // namespace clp_s
 
@@ -6,12 +6,17 @@
 
 namespace clp_s {
 int32_t SchemaMap::add_schema(Schema const& schema) {
-    auto const schema_it = m_schema_map.find(schema);
-    if (m_schema_map.end() != schema_it) {
-        return schema_it->second;
+    // Consecutive records usually share a schema, so check the previous one before probing
+    if (nullptr != m_last_schema_mapping && m_last_schema_mapping->first == schema) {
+        return m_last_schema_mapping->second;
     }
-    m_schema_map.emplace(schema, m_current_schema_id);
-    return m_current_schema_id++;
+
+    auto const [schema_it, inserted] = m_schema_map.try_emplace(schema, m_current_schema_id);
+    if (inserted) {
+        ++m_current_schema_id;
+    }
+    m_last_schema_mapping = &*schema_it;
+    return schema_it->second;
 }
 
 size_t SchemaMap::store(std::string const& archives_dir, int compression_level) {
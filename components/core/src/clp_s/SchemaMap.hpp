@@ -1,15 +1,20 @@
 #ifndef CLP_S_SCHEMAMAP_HPP
 #define CLP_S_SCHEMAMAP_HPP
 
-#include <map>
 #include <string>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "Schema.hpp"
 
 namespace clp_s {
 class SchemaMap {
 public:
-    using schema_map_t = std::map<Schema, int32_t>;
+    struct SchemaHash {
+        size_t operator()(Schema const& schema) const { return schema.get_hash(); }
+    };
+
+    using schema_map_t = absl::flat_hash_map<Schema, int32_t, SchemaHash>;
 
     // Constructor
     SchemaMap() : m_current_schema_id(0) {}
@@ -33,7 +38,10 @@ public:
     /**
      * Clear the schema map
      */
-    void clear() { m_schema_map.clear(); }
+    void clear() {
+        m_schema_map.clear();
+        m_last_schema_mapping = nullptr;
+    }
 
     /**
      * Get const iterators into the schema map
@@ -50,6 +58,8 @@ public:
 private:
     int32_t m_current_schema_id;
     schema_map_t m_schema_map;
+    // The mapping returned by the previous call to add_schema, which is invalidated by insertions
+    schema_map_t::value_type const* m_last_schema_mapping{nullptr};
 };
 }  // namespace clp_s
 
@@ -6,13 +6,15 @@
 #include "Schema.hpp"
 
 namespace clp_s {
-void SchemaReader::append_column(BaseColumnReader* column_reader) {
+void SchemaReader::append_column(BaseColumnReader* column_reader, bool should_load) {
     m_column_map[column_reader->get_id()] = column_reader;
     m_columns.push_back(column_reader);
+    m_should_load_column.push_back(should_load);
 }
 
-void SchemaReader::append_unordered_column(BaseColumnReader* column_reader) {
+void SchemaReader::append_unordered_column(BaseColumnReader* column_reader, bool should_load) {
     m_columns.push_back(column_reader);
+    m_should_load_column.push_back(should_load);
 }
 
 void SchemaReader::mark_column_as_timestamp(BaseColumnReader* column_reader) {
@@ -37,22 +39,53 @@ void SchemaReader::mark_column_as_timestamp(BaseColumnReader* column_reader) {
     }
 }
 
-void SchemaReader::load(ZstdDecompressor& decompressor, size_t uncompressed_size) {
+void SchemaReader::load(
+        std::span<char const> tables_file,
+        std::vector<ColumnChunkMetadata> const& column_chunks
+) {
+    if (column_chunks.size() != m_columns.size()) {
+        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    }
+
+    size_t uncompressed_size = 0;
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        if (m_should_load_column[i]) {
+            uncompressed_size += column_chunks[i].uncompressed_size;
+        }
+    }
     if (uncompressed_size > m_table_buffer_size) {
         m_table_buffer = std::make_unique<char[]>(uncompressed_size);
         m_table_buffer_size = uncompressed_size;
     }
-    auto error = decompressor.try_read_exact_length(m_table_buffer.get(), uncompressed_size);
-    if (ErrorCodeSuccess != error) {
-        throw OperationFailed(error, __FILENAME__, __LINE__);
-    }
 
-    BufferViewReader buffer_reader{m_table_buffer.get(), uncompressed_size};
-    for (auto& reader : m_columns) {
-        reader->load(buffer_reader, m_num_messages);
-    }
-    if (buffer_reader.get_remaining_size() > 0) {
-        throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+    char* column_buffer = m_table_buffer.get();
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        if (false == m_should_load_column[i]) {
+            continue;
+        }
+
+        auto const& column_chunk = column_chunks[i];
+        if (column_chunk.offset > tables_file.size()
+            || column_chunk.compressed_size > tables_file.size() - column_chunk.offset)
+        {
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+        }
+        m_decompressor.open(tables_file.data() + column_chunk.offset, column_chunk.compressed_size);
+        auto error = m_decompressor.try_read_exact_length(
+                column_buffer,
+                column_chunk.uncompressed_size
+        );
+        m_decompressor.close();
+        if (ErrorCodeSuccess != error) {
+            throw OperationFailed(error, __FILENAME__, __LINE__);
+        }
+
+        BufferViewReader buffer_reader{column_buffer, column_chunk.uncompressed_size};
+        m_columns[i]->load(buffer_reader, m_num_messages);
+        if (buffer_reader.get_remaining_size() > 0) {
+            throw OperationFailed(ErrorCodeCorrupt, __FILENAME__, __LINE__);
+        }
+        column_buffer += column_chunk.uncompressed_size;
     }
 }
 
@@ -194,12 +227,7 @@ bool SchemaReader::get_next_message(std::string& message) {
 }
 
 bool SchemaReader::get_next_message(std::string& message, FilterClass* filter) {
-    while (m_cur_message < m_num_messages) {
-        if (false == filter->filter(m_cur_message)) {
-            m_cur_message++;
-            continue;
-        }
-
+    if (advance_to_next_accepted_message(filter)) {
         if (m_should_marshal_records) {
             if (false == m_serializer_initialized) {
                 initialize_serializer();
@@ -222,12 +250,12 @@ bool SchemaReader::get_next_message(std::string& message, FilterClass* filter) {
 bool SchemaReader::get_next_message_with_timestamp(
         std::string& message,
         epochtime_t& timestamp,
-        FilterClass* filter
+        FilterClass* filter,
+        std::optional<epochtime_t> timestamp_threshold
 ) {
-    // TODO: If we already get max_num_results messages, we can skip messages
-    // with the timestamp less than the smallest timestamp in the priority queue
-    while (m_cur_message < m_num_messages) {
-        if (false == filter->filter(m_cur_message)) {
+    while (advance_to_next_accepted_message(filter)) {
+        timestamp = m_get_timestamp();
+        if (timestamp_threshold.has_value() && timestamp <= timestamp_threshold.value()) {
             m_cur_message++;
             continue;
         }
@@ -244,8 +272,6 @@ bool SchemaReader::get_next_message_with_timestamp(
             }
         }
 
-        timestamp = m_get_timestamp();
-
         m_cur_message++;
         return true;
     }
@@ -253,8 +279,34 @@ bool SchemaReader::get_next_message_with_timestamp(
     return false;
 }
 
+bool SchemaReader::get_next_message_index(uint64_t& cur_message, FilterClass* filter) {
+    if (advance_to_next_accepted_message(filter)) {
+        cur_message = m_cur_message++;
+        return true;
+    }
+    return false;
+}
+
+bool SchemaReader::advance_to_next_accepted_message(FilterClass* filter) {
+    if (m_has_selection) {
+        while (m_cur_message < m_num_messages && 0 == m_selection[m_cur_message]) {
+            m_cur_message++;
+        }
+        return m_cur_message < m_num_messages;
+    }
+
+    while (m_cur_message < m_num_messages) {
+        if (filter->filter(m_cur_message)) {
+            return true;
+        }
+        m_cur_message++;
+    }
+    return false;
+}
+
 void SchemaReader::initialize_filter(FilterClass* filter) {
     filter->init(this, m_schema_id, m_columns);
+    m_has_selection = filter->filter_batch(m_num_messages, m_selection);
 }
 
 void SchemaReader::generate_local_tree(int32_t global_id) {
@@ -547,8 +599,14 @@ void SchemaReader::initialize_serializer() {
 
     m_serializer_initialized = true;
 
-    for (int32_t global_column_id : m_ordered_schema) {
-        generate_local_tree(global_column_id);
+    if (m_has_projection) {
+        for (int32_t global_column_id : m_projected_schema) {
+            generate_local_tree(global_column_id);
+        }
+    } else {
+        for (int32_t global_column_id : m_ordered_schema) {
+            generate_local_tree(global_column_id);
+        }
     }
 
     for (auto it = m_global_id_to_unordered_object.begin();
@@ -558,6 +616,11 @@ void SchemaReader::initialize_serializer() {
         generate_local_tree(it->first);
     }
 
+    // Records which contain none of the projected columns are marshalled as empty objects
+    if (m_local_schema_tree.get_nodes().empty()) {
+        return;
+    }
+
     // TODO: this code will have to change once we allow mixing log lines parsed by different
     // parsers.
     generate_json_template(0);
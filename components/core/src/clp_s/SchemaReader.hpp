@@ -1,6 +1,7 @@
 #ifndef CLP_S_SCHEMAREADER_HPP
 #define CLP_S_SCHEMAREADER_HPP
 
+#include <optional>
 #include <span>
 #include <string>
 #include <type_traits>
@@ -8,6 +9,7 @@
 #include <utility>
 
 #include "ColumnReader.hpp"
+#include "ColumnStatistics.hpp"
 #include "FileReader.hpp"
 #include "JsonSerializer.hpp"
 #include "SchemaTree.hpp"
@@ -36,6 +38,17 @@ public:
      * @return true if the message is accepted
      */
     virtual bool filter(uint64_t cur_message) = 0;
+
+    /**
+     * Filters every message in the table at once
+     * @param num_messages
+     * @param selection Returns whether each message is accepted
+     * @return true if the selection was populated, or false if messages must instead be filtered
+     * one at a time using `filter`
+     */
+    virtual bool filter_batch(uint64_t num_messages, std::vector<uint8_t>& selection) {
+        return false;
+    }
 };
 
 class SchemaReader {
@@ -47,10 +60,23 @@ public:
                 : TraceableException(error_code, filename, line_number) {}
     };
 
-    struct TableMetadata {
+    struct ColumnChunkMetadata {
+        size_t offset;
+        size_t compressed_size;
+        size_t uncompressed_size;
+    };
+
+    struct RowGroupMetadata {
         uint64_t num_messages;
         size_t offset;
         size_t uncompressed_size;
+        std::vector<ColumnStatistics> statistics;
+        std::vector<ColumnChunkMetadata> column_chunks;
+    };
+
+    struct TableMetadata {
+        uint64_t num_messages;
+        std::vector<RowGroupMetadata> row_groups;
     };
 
     // Constructor
@@ -86,11 +112,15 @@ public:
         m_schema_id = schema_id;
         m_num_messages = num_messages;
         m_cur_message = 0;
+        m_has_selection = false;
         m_serializer_initialized = false;
         m_ordered_schema = ordered_schema;
+        m_projected_schema.clear();
+        m_has_projection = false;
         delete_columns();
         m_column_map.clear();
         m_columns.clear();
+        m_should_load_column.clear();
         m_reordered_columns.clear();
         m_timestamp_column = nullptr;
         m_get_timestamp = []() -> epochtime_t { return 0; };
@@ -106,17 +136,33 @@ public:
     /**
      * Appends a column to the schema reader
      * @param column_reader
+     * @param should_load Whether the column's data should be decompressed by `load`
      */
-    void append_column(BaseColumnReader* column_reader);
+    void append_column(BaseColumnReader* column_reader, bool should_load);
 
     /**
      * Appends an unordered column to the schema reader
      * @param column_reader
+     * @param should_load Whether the column's data should be decompressed by `load`
      */
-    void append_unordered_column(BaseColumnReader* column_reader);
+    void append_unordered_column(BaseColumnReader* column_reader, bool should_load);
+
+    /**
+     * Restricts marshalled records to the given columns of the ordered schema
+     * @param projected_schema
+     */
+    void set_projected_schema(std::vector<int32_t> projected_schema) {
+        m_projected_schema = std::move(projected_schema);
+        m_has_projection = true;
+    }
 
     size_t get_column_size() { return m_columns.size(); }
 
+    /**
+     * @return the readers for every column in the table
+     */
+    std::vector<BaseColumnReader*> const& get_column_readers() const { return m_columns; }
+
     /**
      * Marks an unordered object for the purpose of marshalling records.
      * @param column_reader_start,
@@ -130,11 +176,17 @@ public:
     );
 
     /**
-     * Loads the encoded messages
-     * @param decompressor
-     * @param uncompressed_size
+     * Loads the encoded messages of every column which should be loaded. Each column is stored in
+     * its own frame, so the remaining columns are never read or decompressed. Frames are
+     * decompressed directly from the given memory, and the buffer they're decompressed into is
+     * reused across calls.
+     * @param tables_file The contents of the archive's tables file
+     * @param column_chunks The location of each column's frame in the tables file
      */
-    void load(ZstdDecompressor& decompressor, size_t uncompressed_size);
+    void load(
+            std::span<char const> tables_file,
+            std::vector<ColumnChunkMetadata> const& column_chunks
+    );
 
     /**
      * Gets next message
@@ -156,14 +208,26 @@ public:
      * @param message
      * @param timestamp
      * @param filter
+     * @param timestamp_threshold If set, messages with timestamps at or before it are skipped
+     * without being marshalled
      * @return true if there is a next message
      */
     bool get_next_message_with_timestamp(
             std::string& message,
             epochtime_t& timestamp,
-            FilterClass* filter
+            FilterClass* filter,
+            std::optional<epochtime_t> timestamp_threshold = std::nullopt
     );
 
+    /**
+     * Gets the index of the next message matching a filter without marshalling it, so that its
+     * values can be read directly from the column readers
+     * @param cur_message
+     * @param filter
+     * @return true if there is a next message
+     */
+    bool get_next_message_index(uint64_t& cur_message, FilterClass* filter);
+
     /**
      * Initializes the filter
      * @param filter
@@ -259,6 +323,13 @@ private:
             std::vector<int32_t>& path_to_intersection
     );
 
+    /**
+     * Advances m_cur_message to the next message accepted by the filter
+     * @param filter
+     * @return true if there is such a message, false otherwise
+     */
+    bool advance_to_next_accepted_message(FilterClass* filter);
+
     /**
      * Generates a json string from the extracted values
      */
@@ -273,12 +344,20 @@ private:
     uint64_t m_num_messages;
     uint64_t m_cur_message;
     std::span<int32_t> m_ordered_schema;
+    std::vector<int32_t> m_projected_schema;
+    bool m_has_projection{false};
+
+    // Messages accepted by the filter when it was able to filter the whole table at once
+    std::vector<uint8_t> m_selection;
+    bool m_has_selection{false};
 
     std::unordered_map<int32_t, BaseColumnReader*> m_column_map;
     std::vector<BaseColumnReader*> m_columns;
+    std::vector<bool> m_should_load_column;
     std::vector<BaseColumnReader*> m_reordered_columns;
     std::unique_ptr<char[]> m_table_buffer;
     size_t m_table_buffer_size{0};
+    ZstdDecompressor m_decompressor;
 
     BaseColumnReader* m_timestamp_column;
     std::function<epochtime_t()> m_get_timestamp;
@@ -5,25 +5,44 @@
 #include "ZstdCompressor.hpp"
 
 namespace clp_s {
-int32_t SchemaTree::add_node(int32_t parent_node_id, NodeType type, std::string const& key) {
-    std::tuple<int32_t, std::string, NodeType> node_key = {parent_node_id, key, type};
-    auto node_it = m_node_map.find(node_key);
-    if (node_it != m_node_map.end()) {
-        auto node_id = node_it->second;
-        m_nodes[node_id].increase_count();
-        return node_id;
+int32_t SchemaTree::add_node(int32_t parent_node_id, NodeType type, std::string_view key) {
+    auto& parent_cache = m_child_caches[parent_node_id + 1];
+    int32_t node_id;
+    if (parent_cache.next_child < parent_cache.children.size()) {
+        node_id = parent_cache.children[parent_cache.next_child];
+        auto& node = m_nodes[node_id];
+        if (node.get_type() == type && node.get_key_name() == key) {
+            ++parent_cache.next_child;
+            node.increase_count();
+            m_child_caches[node_id + 1].next_child = 0;
+            return node_id;
+        }
+        // This record diverges from the cached children, so replace the rest of them
+        parent_cache.children.resize(parent_cache.next_child);
     }
 
-    int32_t node_id = m_nodes.size();
-    auto& node = m_nodes.emplace_back(parent_node_id, node_id, key, type, 0);
-    node.increase_count();
-    if (parent_node_id >= 0) {
-        auto& parent_node = m_nodes[parent_node_id];
-        node.set_depth(parent_node.get_depth() + 1);
-        parent_node.add_child(node_id);
+    auto node_it = m_node_map.find(node_key_view_t{parent_node_id, key, type});
+    if (node_it != m_node_map.end()) {
+        node_id = node_it->second;
+        m_nodes[node_id].increase_count();
+    } else {
+        node_id = m_nodes.size();
+        auto& node = m_nodes.emplace_back(parent_node_id, node_id, std::string{key}, type, 0);
+        node.increase_count();
+        if (parent_node_id >= 0) {
+            auto& parent_node = m_nodes[parent_node_id];
+            node.set_depth(parent_node.get_depth() + 1);
+            parent_node.add_child(node_id);
+        }
+        m_node_map.emplace(node_key_t{parent_node_id, node.get_key_name(), type}, node_id);
+        m_child_caches.emplace_back();
     }
-    m_node_map[node_key] = node_id;
 
+    // The parent's cache may have been invalidated by adding a new node
+    auto& cache = m_child_caches[parent_node_id + 1];
+    cache.children.push_back(node_id);
+    ++cache.next_child;
+    m_child_caches[node_id + 1].next_child = 0;
     return node_id;
 }
 
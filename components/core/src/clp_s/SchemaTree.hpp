@@ -5,6 +5,8 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
@@ -81,7 +83,22 @@ class SchemaTree {
 public:
     SchemaTree() = default;
 
-    int32_t add_node(int parent_node_id, NodeType type, std::string const& key);
+    /**
+     * Adds a node to the schema tree, or finds it if it already exists. Nodes are usually added in
+     * the same order for every record, so the children found under each parent are cached, and a
+     * node matching the next cached child is resolved without a hash lookup.
+     * @param parent_node_id
+     * @param type
+     * @param key
+     * @return the node id
+     */
+    int32_t add_node(int parent_node_id, NodeType type, std::string_view key);
+
+    /**
+     * Marks the start of a new record, so that its top-level nodes are matched against those of
+     * the previous record
+     */
+    void start_record() { m_child_caches[0].next_child = 0; }
 
     bool has_node(int32_t id) { return id < m_nodes.size() && id >= 0; }
 
@@ -111,6 +128,9 @@ public:
     void clear() {
         m_nodes.clear();
         m_node_map.clear();
+        m_child_caches.resize(1);
+        m_child_caches[0].children.clear();
+        m_child_caches[0].next_child = 0;
     }
 
     /**
@@ -128,8 +148,43 @@ public:
     ) const;
 
 private:
+    using node_key_t = std::tuple<int32_t, std::string, NodeType>;
+    using node_key_view_t = std::tuple<int32_t, std::string_view, NodeType>;
+
+    // Allows nodes to be looked up without copying their key into a std::string
+    struct NodeKeyHash {
+        using is_transparent = void;
+
+        size_t operator()(node_key_view_t const& key) const {
+            return absl::Hash<node_key_view_t>{}(key);
+        }
+
+        size_t operator()(node_key_t const& key) const {
+            return (*this)(node_key_view_t{std::get<0>(key), std::get<1>(key), std::get<2>(key)});
+        }
+    };
+
+    struct NodeKeyEqual {
+        using is_transparent = void;
+
+        template <typename LhsKey, typename RhsKey>
+        bool operator()(LhsKey const& lhs, RhsKey const& rhs) const {
+            return std::get<0>(lhs) == std::get<0>(rhs) && std::get<2>(lhs) == std::get<2>(rhs)
+                   && std::string_view{std::get<1>(lhs)} == std::string_view{std::get<1>(rhs)};
+        }
+    };
+
+    // The children added under a node the last time it appeared, and the position of the next
+    // child expected under it
+    struct ChildCache {
+        std::vector<int32_t> children;
+        size_t next_child{0};
+    };
+
     std::vector<SchemaNode> m_nodes;
-    absl::flat_hash_map<std::tuple<int32_t, std::string, NodeType>, int32_t> m_node_map;
+    absl::flat_hash_map<node_key_t, int32_t, NodeKeyHash, NodeKeyEqual> m_node_map;
+    // Indexed by node id + 1, so that the first entry caches the children of the root
+    std::vector<ChildCache> m_child_caches = std::vector<ChildCache>(1);
 };
 }  // namespace clp_s
 
@@ -1,5 +1,6 @@
 #include "SchemaWriter.hpp"
 
+#include <algorithm>
 #include <utility>
 
 namespace clp_s {
@@ -27,14 +28,97 @@ size_t SchemaWriter::append_message(ParsedMessage& message) {
     return total_size;
 }
 
-size_t SchemaWriter::store(ZstdCompressor& compressor) {
-    size_t total_size = 0;
-    for (auto& writer : m_columns) {
-        total_size += writer->store(compressor);
+void SchemaWriter::set_sort_column(int32_t column_id) {
+    auto it = std::find_if(m_columns.begin(), m_columns.end(), [&](auto const* writer) {
+        return writer->get_id() == column_id;
+    });
+    m_sort_column = m_columns.end() == it ? nullptr : *it;
+}
+
+void SchemaWriter::sort_messages() {
+    if (nullptr == m_sort_column) {
+        return;
+    }
+    // Messages usually arrive in order (and merged tables are always in order), in which case
+    // there's nothing to move
+    bool is_sorted{true};
+    for (size_t i = 1; i < m_num_messages && is_sorted; ++i) {
+        is_sorted = false == m_sort_column->is_value_less(i, *m_sort_column, i - 1);
+    }
+    if (is_sorted) {
+        return;
+    }
+    auto order = m_sort_column->get_sorted_order();
+    for (auto* writer : m_columns) {
+        writer->reorder(order);
+    }
+}
+
+bool SchemaWriter::is_message_less(size_t index, SchemaWriter const& other, size_t other_index)
+        const {
+    if (nullptr == m_sort_column) {
+        return false;
+    }
+    return m_sort_column->is_value_less(index, *other.m_sort_column, other_index);
+}
+
+void SchemaWriter::write_messages(ZstdCompressor& compressor, size_t begin, size_t end) const {
+    for (auto const* writer : m_columns) {
+        writer->write_values(compressor, begin, end);
+    }
+}
+
+void SchemaWriter::read_messages(ZstdDecompressor& decompressor, size_t num_messages) {
+    for (auto* writer : m_columns) {
+        writer->read_values(decompressor, num_messages);
     }
+    m_num_messages += num_messages;
+}
+
+size_t SchemaWriter::append_message_from(SchemaWriter const& other, size_t index) {
+    size_t total_size{0};
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        total_size += m_columns[i]->append_value_from(*other.m_columns[i], index);
+    }
+    m_num_messages++;
     return total_size;
 }
 
+std::vector<SchemaWriter::ColumnChunk> SchemaWriter::store(
+        ZstdCompressor& compressor,
+        std::vector<char>& buffer,
+        int compression_level,
+        size_t begin,
+        size_t end
+) {
+    std::vector<ColumnChunk> column_chunks;
+    column_chunks.reserve(m_columns.size());
+    for (auto& writer : m_columns) {
+        size_t frame_begin = buffer.size();
+        compressor.open(buffer, compression_level);
+        size_t uncompressed_size = writer->store(compressor, begin, end);
+        compressor.close();
+        column_chunks.push_back({buffer.size() - frame_begin, uncompressed_size});
+    }
+    return column_chunks;
+}
+
+std::vector<ColumnStatistics> SchemaWriter::get_statistics(size_t begin, size_t end) const {
+    std::vector<ColumnStatistics> statistics;
+    statistics.reserve(m_columns.size());
+    for (auto const* writer : m_columns) {
+        statistics.push_back(writer->get_statistics(begin, end));
+    }
+    return statistics;
+}
+
+void SchemaWriter::clear() {
+    for (auto* writer : m_columns) {
+        writer->clear();
+    }
+    m_num_messages = 0;
+}
+
 SchemaWriter::~SchemaWriter() {
     for (auto i : m_columns) {
         delete i;
@@ -11,6 +11,12 @@
 namespace clp_s {
 class SchemaWriter {
 public:
+    // Types
+    struct ColumnChunk {
+        size_t compressed_size;
+        size_t uncompressed_size;
+    };
+
     // Constructor
     SchemaWriter() : m_num_messages(0) {}
 
@@ -38,11 +44,81 @@ public:
     size_t append_message(ParsedMessage& message);
 
     /**
-     * Stores the columns to disk.
+     * Sets the column whose values the messages are sorted by when sort_messages is called.
+     * @param column_id
+     */
+    void set_sort_column(int32_t column_id);
+
+    /**
+     * Sorts the buffered messages by their values in the sort column, if one was set. Messages
+     * with equal values keep their relative order.
+     */
+    void sort_messages();
+
+    /**
+     * @param index
+     * @param other A schema writer with the same columns and sort column
+     * @param other_index
+     * @return whether the message at `index` orders before the message at `other_index` in
+     * `other` by their values in the sort column, or false if no sort column was set
+     */
+    bool is_message_less(size_t index, SchemaWriter const& other, size_t other_index) const;
+
+    /**
+     * Writes the messages in [begin, end) in their in-memory form, so that they can be appended to
+     * a schema writer with the same columns by `read_messages`
+     * @param compressor
+     * @param begin
+     * @param end
+     */
+    void write_messages(ZstdCompressor& compressor, size_t begin, size_t end) const;
+
+    /**
+     * Appends messages previously written by `write_messages`
+     * @param decompressor
+     * @param num_messages
+     * @throw BaseColumnWriter::OperationFailed if the messages couldn't be read
+     */
+    void read_messages(ZstdDecompressor& decompressor, size_t num_messages);
+
+    /**
+     * Appends a message from another schema writer
+     * @param other A schema writer with the same columns
+     * @param index
+     * @return The size of the message in bytes.
+     */
+    size_t append_message_from(SchemaWriter const& other, size_t index);
+
+    /**
+     * Stores the messages in [begin, end), compressing each column into its own zstd frame so
+     * that columns can be decompressed independently of one another.
      * @param compressor
-     * @return the uncompressed in-memory size of the table
+     * @param buffer The buffer to append the compressed frames to
+     * @param compression_level
+     * @param begin
+     * @param end
+     * @return the size of each column's frame, in the order the columns were appended
+     */
+    [[nodiscard]] std::vector<ColumnChunk> store(
+            ZstdCompressor& compressor,
+            std::vector<char>& buffer,
+            int compression_level,
+            size_t begin,
+            size_t end
+    );
+
+    /**
+     * @param begin
+     * @param end
+     * @return statistics for every column summarizing the values of the messages in [begin, end)
+     */
+    std::vector<ColumnStatistics> get_statistics(size_t begin, size_t end) const;
+
+    /**
+     * Removes every message from the schema writer and releases the memory they used. The columns
+     * are kept so that new messages can be appended.
      */
-    [[nodiscard]] size_t store(ZstdCompressor& compressor);
+    void clear();
 
     /**
      * Closes the schema writer.
@@ -57,6 +133,7 @@ private:
 
     std::vector<BaseColumnWriter*> m_columns;
     std::vector<BaseColumnWriter*> m_unordered_columns;
+    BaseColumnWriter* m_sort_column{nullptr};
 };
 }  // namespace clp_s
 
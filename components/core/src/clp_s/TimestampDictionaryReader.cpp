@@ -31,6 +31,11 @@ void TimestampDictionaryReader::read_new_entries() {
     if (false == m_is_open) {
         throw OperationFailed(ErrorCodeNotInit, __FILENAME__, __LINE__);
     }
+    // The dictionary is written all at once, so there are never new entries after the first read
+    if (m_has_read_entries) {
+        return;
+    }
+    m_has_read_entries = true;
 
     ErrorCode error;
 
@@ -91,4 +96,13 @@ TimestampDictionaryReader::get_string_encoding(epochtime_t epoch, uint64_t forma
     return ret;
 }
 
+epochtime_t TimestampDictionaryReader::get_end_timestamp() const {
+    if (m_entries.empty()) {
+        // replicate behaviour of TimestampDictionaryWriter
+        return 0;
+    }
+
+    return m_entries.front().get_end_timestamp();
+}
+
 }  // namespace clp_s
@@ -72,6 +72,12 @@ public:
         return m_authoritative_timestamp_column_ids;
     }
 
+    /**
+     * @return the end of the authoritative timestamp column's range as milliseconds since the UNIX
+     * epoch, or 0 if the archive has no timestamp column
+     */
+    epochtime_t get_end_timestamp() const;
+
 private:
     typedef std::map<uint64_t, TimestampPattern> id_to_pattern_t;
     typedef std::vector<std::pair<std::vector<std::string>, TimestampEntry*>>
@@ -79,6 +85,7 @@ private:
 
     // Variables
     bool m_is_open;
+    bool m_has_read_entries{false};
     FileReader m_dictionary_file_reader;
     ZstdDecompressor m_dictionary_decompressor;
 
@@ -91,6 +91,14 @@ public:
      */
     epochtime_t get_end_timestamp() const;
 
+    /**
+     * @param node_id
+     * @return whether timestamps have been ingested from the given column
+     */
+    bool is_timestamp_column(int32_t node_id) const {
+        return m_column_id_to_range.contains(node_id);
+    }
+
 private:
     /**
      * Merges timestamp ranges with the same key name
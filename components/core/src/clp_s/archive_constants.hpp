@@ -9,11 +9,15 @@ constexpr char cArchiveSchemaTreeFile[] = "/schema_tree";
 // Encoded record table files
 constexpr char cArchiveTableMetadataFile[] = "/table_metadata";
 constexpr char cArchiveTablesFile[] = "/tables";
+// Temporary file holding row groups spilled while the archive is being written
+constexpr char cArchiveSpillFile[] = "/tables.spill";
 
 // Dictionary files
 constexpr char cArchiveArrayDictFile[] = "/array.dict";
 constexpr char cArchiveLogDictFile[] = "/log.dict";
 constexpr char cArchiveTimestampDictFile[] = "/timestamp.dict";
 constexpr char cArchiveVarDictFile[] = "/var.dict";
+// Bloom filter over the values in the variable dictionary
+constexpr char cArchiveVarDictFilterFile[] = "/var.dict.filter";
 }  // namespace clp_s::constants
 #endif  // CLP_S_ARCHIVE_CONSTANTS_HPP
@@ -1,10 +1,34 @@
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
 #include <exception>
 #include <filesystem>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include <json/single_include/nlohmann/json.hpp>
 #include <mongocxx/instance.hpp>
@@ -12,8 +36,11 @@
 #include <spdlog/spdlog.h>
 
 #include "../clp/GlobalMySQLMetadataDB.hpp"
+#include "../clp/networking/socket_utils.hpp"
 #include "../clp/streaming_archive/ArchiveMetadata.hpp"
 #include "../reducer/network_utils.hpp"
+#include "archive_constants.hpp"
+#include "ArchiveReaderCache.hpp"
 #include "CommandLineArguments.hpp"
 #include "Defs.hpp"
 #include "JsonConstructor.hpp"
@@ -23,12 +50,14 @@
 #include "search/ConvertToExists.hpp"
 #include "search/EmptyExpr.hpp"
 #include "search/EvaluateTimestampIndex.hpp"
+#include "search/EvaluateVariableDictionaryFilter.hpp"
 #include "search/Expression.hpp"
 #include "search/kql/kql.hpp"
 #include "search/NarrowTypes.hpp"
 #include "search/OrOfAndForm.hpp"
 #include "search/Output.hpp"
 #include "search/OutputHandler.hpp"
+#include "search/Projection.hpp"
 #include "search/SchemaMatch.hpp"
 #include "TimestampPattern.hpp"
 #include "TraceableException.hpp"
@@ -41,6 +70,41 @@ using clp_s::cEpochTimeMin;
 using clp_s::CommandLineArguments;
 
 namespace {
+/**
+ * Creates a connection to the global metadata DB if one was configured on the command line.
+ * @param command_line_arguments
+ * @return The metadata DB, or nullptr if none was configured
+ */
+std::shared_ptr<clp::GlobalMySQLMetadataDB>
+create_metadata_db(CommandLineArguments const& command_line_arguments);
+
+/**
+ * Distributes the given files into at most `num_partitions` partitions so that each partition
+ * contains a roughly equal number of bytes. Files are assigned largest-first to the partition with
+ * the fewest bytes so far.
+ * @param file_paths
+ * @param num_partitions
+ * @return The non-empty partitions
+ */
+std::vector<std::vector<std::string>>
+partition_files_by_size(std::vector<std::string> const& file_paths, size_t num_partitions);
+
+/**
+ * Compresses the given files using one JsonParser per thread. Each thread writes its own archives.
+ * Input is only split between threads at file boundaries (a single file may contain JSON documents
+ * spanning several lines, so it can't be split at arbitrary newlines), so at most one thread is
+ * used per file.
+ * @param option The options shared by all threads
+ * @param file_paths
+ * @param command_line_arguments
+ * @return Whether compression was successful
+ */
+bool compress_in_parallel(
+        clp_s::JsonParserOption const& option,
+        std::vector<std::string> const& file_paths,
+        CommandLineArguments const& command_line_arguments
+);
+
 /**
  * Compresses the input files specified by the command line arguments into an archive.
  * @param command_line_arguments
@@ -60,15 +124,238 @@ void decompress_archive(clp_s::JsonConstructorOption const& json_constructor_opt
  * @param archive_reader
  * @param expr A copy of the search AST which may be modified
  * @param reducer_socket_fd
+ * @param num_threads The number of threads to use to load the archive's tables
+ * @param latest_results_threshold The timestamp threshold shared by the results cache output
+ * handlers of every archive in the search
+ * @param output_fd The file descriptor results are written to by the stdout and columnar output
+ * handlers, or -1 for standard output
+ * @param num_results_remaining The number of results the stdout output handlers of every archive
+ * in the search can still write, or nullptr if the number of results is unlimited
  * @return Whether the search succeeded
  */
 bool search_archive(
         CommandLineArguments const& command_line_arguments,
         std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
         std::shared_ptr<Expression> expr,
-        int reducer_socket_fd
+        int reducer_socket_fd,
+        size_t num_threads,
+        std::shared_ptr<std::atomic<clp_s::epochtime_t>> const& latest_results_threshold,
+        int output_fd,
+        std::shared_ptr<std::atomic<uint64_t>> const& num_results_remaining
+);
+
+/**
+ * Checks whether the given archive can be skipped without opening it, using the bloom filter over
+ * its variable dictionary.
+ * @param archive_path
+ * @param narrowed_expr A copy of the search AST which has already been through type narrowing
+ * @param ignore_case
+ * @return true if no record in the archive can match the query, false otherwise
+ */
+bool can_skip_archive(
+        std::string const& archive_path,
+        std::shared_ptr<Expression> const& narrowed_expr,
+        bool ignore_case
+);
+
+/**
+ * Orders archives from the latest to the earliest end timestamp, so that searches which only keep
+ * the latest results can skip more of the archives searched later.
+ * @param archives_dir
+ * @param archive_ids
+ */
+void sort_archives_by_end_timestamp(
+        std::string const& archives_dir,
+        std::vector<std::string>& archive_ids
+);
+
+/**
+ * Searches the given archives. Archives are distributed dynamically across up to as many threads
+ * as were specified on the command line, and any threads left over are used to load the tables of
+ * each archive in parallel.
+ * @param command_line_arguments
+ * @param archive_ids
+ * @param expr The search AST, which is copied for each archive
+ * @param reducer_socket_fd
+ * @param archive_reader_cache The cache to get archive readers from, or nullptr to open and close
+ * each archive
+ * @param output_fd
+ * @param max_num_results The maximum number of results written by the stdout output handler, or 0
+ * if the number of results is unlimited
+ * @return Whether the search succeeded
+ */
+bool search_archives(
+        CommandLineArguments const& command_line_arguments,
+        std::vector<std::string> const& archive_ids,
+        std::shared_ptr<Expression> const& expr,
+        int reducer_socket_fd,
+        clp_s::ArchiveReaderCache* archive_reader_cache,
+        int output_fd,
+        uint64_t max_num_results
+);
+
+/**
+ * Searches the archives specified by the given search command arguments.
+ * @param command_line_arguments
+ * @param archive_reader_cache The cache to get archive readers from, or nullptr to open and close
+ * each archive
+ * @param output_fd The file descriptor results are written to by the stdout and columnar output
+ * handlers, or -1 for standard output
+ * @param max_num_results The maximum number of results written by the stdout output handler, or 0
+ * if the number of results is unlimited
+ * @return Whether the search succeeded
+ */
+bool search(
+        CommandLineArguments const& command_line_arguments,
+        clp_s::ArchiveReaderCache* archive_reader_cache,
+        int output_fd,
+        uint64_t max_num_results
+);
+
+/**
+ * Creates a socket listening on the Unix domain socket path or TCP port specified by the given
+ * server command arguments.
+ * @param command_line_arguments
+ * @return The socket's file descriptor on success, or -1 on failure
+ */
+int create_server_socket(CommandLineArguments const& command_line_arguments);
+
+/**
+ * Checks that the arguments of a search request only contain a query and options which filter its
+ * results, so that clients can't choose which files are read or where results are written. The
+ * `--max-num-results` option is handled by the server, so it's removed from the arguments.
+ * @param request_arguments
+ * @param max_num_results Returns the maximum number of results to return, or 0 if unlimited
+ * @return Whether the arguments are valid
+ */
+bool validate_search_request_arguments(
+        std::vector<std::string>& request_arguments,
+        uint64_t& max_num_results
 );
 
+/**
+ * @param archive_id
+ * @return Whether the given archive ID names an entry directly within the archives directory
+ */
+bool is_plain_archive_id(std::string const& archive_id);
+
+/**
+ * Reads a search request from the given connection and writes its results back to it. The request
+ * is a JSON array containing a query and options which filter its results, terminated by a newline.
+ * @param connection_fd
+ * @param program_name
+ * @param archives_dir
+ * @param archive_reader_cache
+ * @param num_threads The number of threads to search with
+ * @return Whether the search succeeded
+ */
+bool handle_search_request(
+        int connection_fd,
+        std::string const& program_name,
+        std::string const& archives_dir,
+        clp_s::ArchiveReaderCache& archive_reader_cache,
+        size_t num_threads
+);
+
+/**
+ * Runs a resident search server which serves up to the configured number of requests concurrently,
+ * keeping the dictionaries and metadata of recently searched archives cached between requests.
+ * Requests share the cache, which gives each cached archive reader to one search at a time, so
+ * concurrent requests only wait for each other when they search the same archive.
+ * @param command_line_arguments
+ * @return Whether the server started successfully
+ */
+bool serve(CommandLineArguments const& command_line_arguments);
+
+std::shared_ptr<clp::GlobalMySQLMetadataDB>
+create_metadata_db(CommandLineArguments const& command_line_arguments) {
+    auto const& db_config_container = command_line_arguments.get_metadata_db_config();
+    if (false == db_config_container.has_value()) {
+        return nullptr;
+    }
+
+    auto const& db_config = db_config_container.value();
+    return std::make_shared<clp::GlobalMySQLMetadataDB>(
+            db_config.get_metadata_db_host(),
+            db_config.get_metadata_db_port(),
+            db_config.get_metadata_db_username(),
+            db_config.get_metadata_db_password(),
+            db_config.get_metadata_db_name(),
+            db_config.get_metadata_table_prefix()
+    );
+}
+
+std::vector<std::vector<std::string>>
+partition_files_by_size(std::vector<std::string> const& file_paths, size_t num_partitions) {
+    std::vector<std::pair<uintmax_t, std::string>> files_by_size;
+    files_by_size.reserve(file_paths.size());
+    for (auto const& file_path : file_paths) {
+        std::error_code error_code;
+        auto file_size = std::filesystem::file_size(file_path, error_code);
+        if (error_code) {
+            // Let the parser report the failure; treat the file as empty for balancing purposes
+            file_size = 0;
+        }
+        files_by_size.emplace_back(file_size, file_path);
+    }
+    std::sort(files_by_size.begin(), files_by_size.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    num_partitions = std::min(num_partitions, file_paths.size());
+    std::vector<std::vector<std::string>> partitions(num_partitions);
+    std::vector<uintmax_t> partition_sizes(num_partitions, 0);
+    for (auto& [file_size, file_path] : files_by_size) {
+        auto smallest_partition = std::distance(
+                partition_sizes.begin(),
+                std::min_element(partition_sizes.begin(), partition_sizes.end())
+        );
+        partition_sizes[smallest_partition] += file_size;
+        partitions[smallest_partition].emplace_back(std::move(file_path));
+    }
+    return partitions;
+}
+
+bool compress_in_parallel(
+        clp_s::JsonParserOption const& option,
+        std::vector<std::string> const& file_paths,
+        CommandLineArguments const& command_line_arguments
+) {
+    auto partitions = partition_files_by_size(file_paths, command_line_arguments.get_num_threads());
+
+    std::atomic_bool succeeded{true};
+    std::vector<std::thread> workers;
+    workers.reserve(partitions.size());
+    for (auto& partition : partitions) {
+        auto worker_option = option;
+        worker_option.file_paths = std::move(partition);
+        // Split the threads between the workers for compressing their archives' tables
+        worker_option.num_threads = std::max<size_t>(1, option.num_threads / partitions.size());
+        // Each worker needs its own connection to the metadata DB
+        worker_option.metadata_db = create_metadata_db(command_line_arguments);
+        workers.emplace_back([worker_option = std::move(worker_option), &succeeded]() {
+            try {
+                clp_s::JsonParser parser(worker_option);
+                if (false == parser.parse()) {
+                    SPDLOG_ERROR("Encountered error while parsing input");
+                    succeeded = false;
+                    return;
+                }
+                parser.store();
+            } catch (std::exception const& e) {
+                // Exceptions can't be allowed to escape the thread, so report them as failures
+                SPDLOG_ERROR("Failed to compress input - {}", e.what());
+                succeeded = false;
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return succeeded;
+}
+
 bool compress(CommandLineArguments const& command_line_arguments) {
     auto archives_dir = std::filesystem::path(command_line_arguments.get_archives_dir());
 
@@ -93,26 +380,44 @@ bool compress(CommandLineArguments const& command_line_arguments) {
     option.timestamp_key = command_line_arguments.get_timestamp_key();
     option.print_archive_stats = command_line_arguments.print_archive_stats();
     option.structurize_arrays = command_line_arguments.get_structurize_arrays();
+    option.max_pending_archives = command_line_arguments.get_max_pending_archives();
+    option.row_group_size = command_line_arguments.get_row_group_size();
+    option.max_buffered_table_size = command_line_arguments.get_max_buffered_table_size();
+    option.sort_by_timestamp = command_line_arguments.get_sort_by_timestamp();
+    option.num_threads = command_line_arguments.get_num_threads();
 
-    auto const& db_config_container = command_line_arguments.get_metadata_db_config();
-    if (db_config_container.has_value()) {
-        auto const& db_config = db_config_container.value();
-        option.metadata_db = std::make_shared<clp::GlobalMySQLMetadataDB>(
-                db_config.get_metadata_db_host(),
-                db_config.get_metadata_db_port(),
-                db_config.get_metadata_db_username(),
-                db_config.get_metadata_db_password(),
-                db_config.get_metadata_db_name(),
-                db_config.get_metadata_table_prefix()
+    if (command_line_arguments.get_num_threads() > 1) {
+        if (false == clp_s::FileUtils::validate_path(option.file_paths)) {
+            return false;
+        }
+
+        std::vector<std::string> file_paths;
+        for (auto const& file_path : option.file_paths) {
+            clp_s::FileUtils::find_all_files(file_path, file_paths);
+        }
+
+        if (file_paths.size() > 1) {
+            return compress_in_parallel(option, file_paths, command_line_arguments);
+        }
+        SPDLOG_INFO(
+                "Parsing a single input file on one thread; the other threads will only be used to"
+                " compress tables."
         );
     }
 
-    clp_s::JsonParser parser(option);
-    if (false == parser.parse()) {
-        SPDLOG_ERROR("Encountered error while parsing input");
+    option.metadata_db = create_metadata_db(command_line_arguments);
+
+    try {
+        clp_s::JsonParser parser(option);
+        if (false == parser.parse()) {
+            SPDLOG_ERROR("Encountered error while parsing input");
+            return false;
+        }
+        parser.store();
+    } catch (std::exception const& e) {
+        SPDLOG_ERROR("Failed to compress input - {}", e.what());
         return false;
     }
-    parser.store();
     return true;
 }
 
@@ -125,7 +430,11 @@ bool search_archive(
         CommandLineArguments const& command_line_arguments,
         std::shared_ptr<clp_s::ArchiveReader> const& archive_reader,
         std::shared_ptr<Expression> expr,
-        int reducer_socket_fd
+        int reducer_socket_fd,
+        size_t num_threads,
+        std::shared_ptr<std::atomic<clp_s::epochtime_t>> const& latest_results_threshold,
+        int output_fd,
+        std::shared_ptr<std::atomic<uint64_t>> const& num_results_remaining
 ) {
     auto const& query = command_line_arguments.get_query();
 
@@ -172,6 +481,16 @@ bool search_archive(
         return true;
     }
 
+    // Cached archive readers may still have the projection of a previous search
+    std::shared_ptr<Projection> projection;
+    if (auto const& projection_columns = command_line_arguments.get_projection_columns();
+        false == projection_columns.empty())
+    {
+        projection = std::make_shared<Projection>(projection_columns);
+        projection->resolve_columns(archive_reader->get_schema_tree());
+    }
+    archive_reader->set_projection(projection);
+
     // Narrow against schemas
     SchemaMatch match_pass(archive_reader->get_schema_tree(), archive_reader->get_schema_map());
     if (expr = match_pass.run(expr); std::dynamic_pointer_cast<EmptyExpr>(expr)) {
@@ -189,7 +508,17 @@ bool search_archive(
                 );
                 break;
             case CommandLineArguments::OutputHandlerType::Reducer:
-                if (command_line_arguments.do_count_results_aggregation()) {
+                if (auto const aggregation_type = command_line_arguments.get_aggregation_type();
+                    aggregation_type.has_value())
+                {
+                    output_handler = std::make_unique<AggregationOutputHandler>(
+                            reducer_socket_fd,
+                            aggregation_type.value(),
+                            command_line_arguments.get_aggregation_field(),
+                            command_line_arguments.get_group_by_field(),
+                            *archive_reader->get_schema_tree()
+                    );
+                } else if (command_line_arguments.do_count_results_aggregation()) {
                     output_handler = std::make_unique<CountOutputHandler>(reducer_socket_fd);
                 } else if (command_line_arguments.do_count_by_time_aggregation()) {
                     output_handler = std::make_unique<CountByTimeOutputHandler>(
@@ -206,11 +535,24 @@ bool search_archive(
                         command_line_arguments.get_mongodb_uri(),
                         command_line_arguments.get_mongodb_collection(),
                         command_line_arguments.get_batch_size(),
-                        command_line_arguments.get_max_num_results()
+                        command_line_arguments.get_max_num_results(),
+                        latest_results_threshold
                 );
                 break;
             case CommandLineArguments::OutputHandlerType::Stdout:
-                output_handler = std::make_unique<StandardOutputHandler>();
+                output_handler = std::make_unique<StandardOutputHandler>(
+                        false,
+                        output_fd,
+                        num_results_remaining
+                );
+                break;
+            case CommandLineArguments::OutputHandlerType::Columnar:
+                output_handler = std::make_unique<ColumnarOutputHandler>(
+                        -1 == output_fd ? STDOUT_FILENO : output_fd,
+                        std::string{archive_reader->get_archive_id()},
+                        archive_reader->get_schema_tree(),
+                        projection
+                );
                 break;
             default:
                 SPDLOG_ERROR("Unhandled OutputHandlerType.");
@@ -228,15 +570,646 @@ bool search_archive(
             archive_reader,
             timestamp_dict,
             std::move(output_handler),
-            command_line_arguments.get_ignore_case()
+            command_line_arguments.get_ignore_case(),
+            num_threads
     );
     return output.filter();
 }
+
+bool can_skip_archive(
+        std::string const& archive_path,
+        std::shared_ptr<Expression> const& narrowed_expr,
+        bool ignore_case
+) {
+    auto filter = clp_s::ReaderUtils::read_variable_dictionary_filter(archive_path);
+    if (nullptr == filter) {
+        return false;
+    }
+
+    auto const has_arrays = 0
+                            != clp_s::ReaderUtils::read_num_dictionary_entries(
+                                    archive_path + clp_s::constants::cArchiveArrayDictFile
+                            );
+    EvaluateVariableDictionaryFilter variable_dictionary_filter(filter, has_arrays, ignore_case);
+    return clp_s::EvaluatedValue::False == variable_dictionary_filter.run(narrowed_expr);
+}
+
+void sort_archives_by_end_timestamp(
+        std::string const& archives_dir,
+        std::vector<std::string>& archive_ids
+) {
+    std::vector<std::pair<clp_s::epochtime_t, std::string>> end_timestamps_and_ids;
+    end_timestamps_and_ids.reserve(archive_ids.size());
+    for (auto& archive_id : archive_ids) {
+        auto const archive_path = (std::filesystem::path(archives_dir) / archive_id).string();
+        auto timestamp_dict = clp_s::ReaderUtils::get_timestamp_dictionary_reader(archive_path);
+        timestamp_dict->read_new_entries();
+        end_timestamps_and_ids.emplace_back(timestamp_dict->get_end_timestamp(), archive_id);
+        timestamp_dict->close();
+    }
+    std::stable_sort(
+            end_timestamps_and_ids.begin(),
+            end_timestamps_and_ids.end(),
+            [](auto const& lhs, auto const& rhs) { return lhs.first > rhs.first; }
+    );
+    for (size_t i = 0; i < archive_ids.size(); ++i) {
+        archive_ids[i] = std::move(end_timestamps_and_ids[i].second);
+    }
+}
+
+bool search_archives(
+        CommandLineArguments const& command_line_arguments,
+        std::vector<std::string> const& archive_ids,
+        std::shared_ptr<Expression> const& expr,
+        int reducer_socket_fd,
+        clp_s::ArchiveReaderCache* archive_reader_cache,
+        int output_fd,
+        uint64_t max_num_results
+) {
+    if (archive_ids.empty()) {
+        return true;
+    }
+
+    auto const& archives_dir = command_line_arguments.get_archives_dir();
+    auto const num_threads = command_line_arguments.get_num_threads();
+    auto const num_workers = std::min(num_threads, archive_ids.size());
+    auto const num_threads_per_archive = std::max<size_t>(1, num_threads / num_workers);
+    auto const latest_results_threshold
+            = std::make_shared<std::atomic<clp_s::epochtime_t>>(cEpochTimeMin);
+    std::shared_ptr<std::atomic<uint64_t>> num_results_remaining;
+    if (0 != max_num_results) {
+        num_results_remaining = std::make_shared<std::atomic<uint64_t>>(max_num_results);
+    }
+
+    // The archive-independent passes are run once so that archives which can't contain the values
+    // the query needs can be skipped before they're opened. Archives are still searched with their
+    // own copy of the original AST.
+    std::shared_ptr<Expression> narrowed_expr = expr->copy();
+    narrowed_expr = OrOfAndForm().run(narrowed_expr);
+    narrowed_expr = NarrowTypes().run(narrowed_expr);
+    narrowed_expr = ConvertToExists().run(narrowed_expr);
+    auto const& query = command_line_arguments.get_query();
+    auto const ignore_case = command_line_arguments.get_ignore_case();
+
+    std::atomic_size_t next_archive{0};
+    std::atomic_bool succeeded{true};
+    auto search_remaining_archives = [&]() {
+        std::shared_ptr<clp_s::ArchiveReader> archive_reader;
+        if (nullptr == archive_reader_cache) {
+            archive_reader = std::make_shared<clp_s::ArchiveReader>();
+        }
+        for (size_t i = next_archive++; i < archive_ids.size() && succeeded; i = next_archive++) {
+            auto const& archive_id = archive_ids[i];
+            try {
+                auto const archive_path
+                        = (std::filesystem::path(archives_dir) / archive_id).string();
+                if (can_skip_archive(archive_path, narrowed_expr, ignore_case)) {
+                    SPDLOG_INFO(
+                            "No matching variables in archive {} for query '{}'",
+                            archive_id,
+                            query
+                    );
+                    continue;
+                }
+
+                if (nullptr != archive_reader_cache) {
+                    archive_reader = archive_reader_cache->get(archive_id);
+                } else {
+                    archive_reader->open(archives_dir, archive_id);
+                }
+                if (false
+                    == search_archive(
+                            command_line_arguments,
+                            archive_reader,
+                            expr->copy(),
+                            reducer_socket_fd,
+                            num_threads_per_archive,
+                            latest_results_threshold,
+                            output_fd,
+                            num_results_remaining
+                    ))
+                {
+                    succeeded = false;
+                    return;
+                }
+                if (nullptr == archive_reader_cache) {
+                    archive_reader->close();
+                } else {
+                    // Other searches may be waiting for the cached reader, and waiting for the
+                    // next archive's reader while holding this one could deadlock
+                    archive_reader.reset();
+                }
+            } catch (std::exception const& e) {
+                // Exceptions can't propagate out of worker threads, so they're all handled here
+                SPDLOG_ERROR("Failed to search archive {} - {}", archive_id, e.what());
+                succeeded = false;
+                return;
+            }
+        }
+    };
+
+    if (1 == num_workers) {
+        search_remaining_archives();
+        return succeeded;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(search_remaining_archives);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return succeeded;
+}
+
+bool search(
+        CommandLineArguments const& command_line_arguments,
+        clp_s::ArchiveReaderCache* archive_reader_cache,
+        int output_fd,
+        uint64_t max_num_results
+) {
+    auto const& query = command_line_arguments.get_query();
+    auto query_stream = std::istringstream(query);
+    auto expr = kql::parse_kql_expression(query_stream);
+    if (nullptr == expr) {
+        return false;
+    }
+
+    if (std::dynamic_pointer_cast<EmptyExpr>(expr)) {
+        SPDLOG_ERROR("Query '{}' is logically false", query);
+        return false;
+    }
+
+    auto const& archives_dir = command_line_arguments.get_archives_dir();
+    if (false == std::filesystem::is_directory(archives_dir)) {
+        SPDLOG_ERROR("'{}' is not a directory.", archives_dir);
+        return false;
+    }
+
+    int reducer_socket_fd{-1};
+    if (command_line_arguments.get_output_handler_type()
+        == CommandLineArguments::OutputHandlerType::Reducer)
+    {
+        reducer_socket_fd = reducer::connect_to_reducer(
+                command_line_arguments.get_reducer_host(),
+                command_line_arguments.get_reducer_port(),
+                command_line_arguments.get_job_id()
+        );
+        if (-1 == reducer_socket_fd) {
+            SPDLOG_ERROR("Failed to connect to reducer");
+            return false;
+        }
+    }
+
+    // Column batches from every archive are written to the same file or connection
+    int columnar_output_fd{-1};
+    if (command_line_arguments.get_output_handler_type()
+        == CommandLineArguments::OutputHandlerType::Columnar)
+    {
+        if (auto const& output_path = command_line_arguments.get_columnar_output_path();
+            false == output_path.empty())
+        {
+            columnar_output_fd = open(output_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (-1 == columnar_output_fd) {
+                SPDLOG_ERROR("Failed to open '{}', errno={}", output_path, errno);
+                return false;
+            }
+        } else if (false == command_line_arguments.get_network_dest_host().empty()) {
+            columnar_output_fd = clp::networking::connect_to_server(
+                    command_line_arguments.get_network_dest_host(),
+                    std::to_string(command_line_arguments.get_network_dest_port())
+            );
+            if (-1 == columnar_output_fd) {
+                SPDLOG_ERROR("Failed to connect to the server, errno={}", errno);
+                return false;
+            }
+        }
+        if (-1 != columnar_output_fd) {
+            output_fd = columnar_output_fd;
+        }
+    }
+
+    std::vector<std::string> archive_ids;
+    auto const& archive_id = command_line_arguments.get_archive_id();
+    if (false == archive_id.empty()) {
+        archive_ids.push_back(archive_id);
+    } else {
+        for (auto const& entry : std::filesystem::directory_iterator(archives_dir)) {
+            if (false == entry.is_directory()) {
+                // Skip non-directories
+                continue;
+            }
+            archive_ids.push_back(entry.path().filename().string());
+        }
+    }
+
+    if (command_line_arguments.get_output_handler_type()
+        == CommandLineArguments::OutputHandlerType::ResultsCache)
+    {
+        sort_archives_by_end_timestamp(archives_dir, archive_ids);
+    }
+
+    auto const succeeded = search_archives(
+            command_line_arguments,
+            archive_ids,
+            expr,
+            reducer_socket_fd,
+            archive_reader_cache,
+            output_fd,
+            max_num_results
+    );
+    if (-1 != reducer_socket_fd) {
+        close(reducer_socket_fd);
+    }
+    if (-1 != columnar_output_fd) {
+        close(columnar_output_fd);
+    }
+    return succeeded;
+}
+
+int create_server_socket(CommandLineArguments const& command_line_arguments) {
+    constexpr int cListenBacklog = 128;
+
+    auto const& socket_path = command_line_arguments.get_server_socket_path();
+    if (false == socket_path.empty()) {
+        sockaddr_un address{};
+        if (socket_path.size() >= sizeof(address.sun_path)) {
+            SPDLOG_ERROR("Socket path '{}' is too long.", socket_path);
+            return -1;
+        }
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+        int const socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (-1 == socket_fd) {
+            SPDLOG_ERROR("Failed to create socket, errno={}", errno);
+            return -1;
+        }
+        // Remove any socket left behind by a previous server
+        unlink(socket_path.c_str());
+        if (-1 == bind(socket_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address))
+            || -1 == listen(socket_fd, cListenBacklog))
+        {
+            SPDLOG_ERROR("Failed to listen on '{}', errno={}", socket_path, errno);
+            close(socket_fd);
+            return -1;
+        }
+        return socket_fd;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* addresses{nullptr};
+    auto const& host = command_line_arguments.get_server_host();
+    auto const port = std::to_string(command_line_arguments.get_server_port());
+    if (auto const error = getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses); 0 != error)
+    {
+        SPDLOG_ERROR("Failed to resolve {}:{} - {}", host, port, gai_strerror(error));
+        return -1;
+    }
+
+    int socket_fd{-1};
+    for (auto const* address = addresses; nullptr != address; address = address->ai_next) {
+        socket_fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (-1 == socket_fd) {
+            continue;
+        }
+        int const enable_reuse_address{1};
+        setsockopt(
+                socket_fd,
+                SOL_SOCKET,
+                SO_REUSEADDR,
+                &enable_reuse_address,
+                sizeof(enable_reuse_address)
+        );
+        if (0 == bind(socket_fd, address->ai_addr, address->ai_addrlen)
+            && 0 == listen(socket_fd, cListenBacklog))
+        {
+            break;
+        }
+        close(socket_fd);
+        socket_fd = -1;
+    }
+    freeaddrinfo(addresses);
+    if (-1 == socket_fd) {
+        SPDLOG_ERROR("Failed to listen on {}:{}, errno={}", host, port, errno);
+    }
+    return socket_fd;
+}
+
+bool validate_search_request_arguments(
+        std::vector<std::string>& request_arguments,
+        uint64_t& max_num_results
+) {
+    constexpr std::string_view cMaxNumResultsOption{"--max-num-results"};
+    std::unordered_set<std::string_view> const switch_options{"--ignore-case", "-i"};
+    std::unordered_set<std::string_view> const value_options{
+            "--query",
+            "--tge",
+            "--tle",
+            "--projection",
+            "--archive-id",
+            cMaxNumResultsOption
+    };
+
+    max_num_results = 0;
+    std::vector<std::string> validated_arguments;
+    size_t num_queries{0};
+    for (size_t i = 0; i < request_arguments.size(); ++i) {
+        auto const& argument = request_arguments[i];
+        if (false == argument.starts_with('-')) {
+            // The only positional argument is the query
+            validated_arguments.push_back(argument);
+            ++num_queries;
+            continue;
+        }
+        if (switch_options.contains(argument)) {
+            validated_arguments.push_back(argument);
+            continue;
+        }
+
+        std::string option{"-q" == argument ? "--query" : argument};
+        std::optional<std::string> value;
+        if (auto const equals_pos = option.find('='); std::string::npos != equals_pos) {
+            value = option.substr(equals_pos + 1);
+            option.resize(equals_pos);
+        }
+        if (false == value_options.contains(option)) {
+            SPDLOG_ERROR("Unsupported request argument '{}'", argument);
+            return false;
+        }
+        if (false == value.has_value()) {
+            if (request_arguments.size() == i + 1) {
+                SPDLOG_ERROR("Missing value for request argument '{}'", argument);
+                return false;
+            }
+            value = request_arguments[++i];
+        }
+
+        if (cMaxNumResultsOption == option) {
+            auto const& raw = value.value();
+            auto const* raw_end = raw.data() + raw.size();
+            auto const result = std::from_chars(raw.data(), raw_end, max_num_results);
+            if (std::errc{} != result.ec || raw_end != result.ptr || 0 == max_num_results) {
+                SPDLOG_ERROR("Invalid value for {}: '{}'", cMaxNumResultsOption, raw);
+                return false;
+            }
+            continue;
+        }
+        if ("--query" == option) {
+            ++num_queries;
+        }
+        // Attach the value to its option so that values starting with '-' aren't parsed as options
+        validated_arguments.push_back(option + "=" + value.value());
+    }
+    if (1 != num_queries) {
+        SPDLOG_ERROR("Requests must contain exactly one query.");
+        return false;
+    }
+
+    request_arguments = std::move(validated_arguments);
+    return true;
+}
+
+bool is_plain_archive_id(std::string const& archive_id) {
+    std::filesystem::path const archive_path{archive_id};
+    return "." != archive_id && ".." != archive_id && archive_path == archive_path.filename();
+}
+
+bool handle_search_request(
+        int connection_fd,
+        std::string const& program_name,
+        std::string const& archives_dir,
+        clp_s::ArchiveReaderCache& archive_reader_cache,
+        size_t num_threads
+) {
+    constexpr size_t cMaxRequestSize = 1024 * 1024;  // 1 MiB
+    constexpr std::chrono::seconds cRequestTimeout{10};
+
+    // Each request occupies one of the server's workers, so a client which doesn't send a complete
+    // request in time is dropped rather than holding the worker
+    auto const deadline = std::chrono::steady_clock::now() + cRequestTimeout;
+    std::string request;
+    char buffer[4096];
+    while (request.empty() || '\n' != request.back()) {
+        auto const remaining_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()
+        );
+        pollfd poll_fd{connection_fd, POLLIN, 0};
+        int poll_result{0};
+        if (remaining_time.count() > 0) {
+            poll_result = poll(&poll_fd, 1, static_cast<int>(remaining_time.count()));
+        }
+        if (0 == poll_result) {
+            SPDLOG_ERROR("Timed out waiting for request.");
+            return false;
+        }
+        if (poll_result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            SPDLOG_ERROR("Failed to wait for request, errno={}", errno);
+            return false;
+        }
+
+        auto const num_bytes_read = read(connection_fd, buffer, sizeof(buffer));
+        if (num_bytes_read < 0 && EINTR == errno) {
+            continue;
+        }
+        if (num_bytes_read <= 0) {
+            break;
+        }
+        request.append(buffer, num_bytes_read);
+        if (request.size() > cMaxRequestSize) {
+            SPDLOG_ERROR("Request exceeds {} bytes.", cMaxRequestSize);
+            return false;
+        }
+    }
+
+    std::vector<std::string> request_arguments;
+    try {
+        request_arguments = nlohmann::json::parse(request).get<std::vector<std::string>>();
+    } catch (nlohmann::json::exception const& e) {
+        SPDLOG_ERROR("Invalid request - {}", e.what());
+        return false;
+    }
+
+    uint64_t max_num_results{0};
+    if (false == validate_search_request_arguments(request_arguments, max_num_results)) {
+        return false;
+    }
+
+    // Parse the request as if it were the arguments of a search command which writes its results
+    // to standard output, using the server's number of threads
+    auto const num_threads_str = std::to_string(num_threads);
+    std::vector<char const*> argv{
+            program_name.c_str(),
+            "s",
+            archives_dir.c_str(),
+            "--num-threads",
+            num_threads_str.c_str()
+    };
+    for (auto const& argument : request_arguments) {
+        argv.push_back(argument.c_str());
+    }
+    CommandLineArguments command_line_arguments(program_name);
+    if (CommandLineArguments::ParsingResult::Success
+        != command_line_arguments.parse_arguments(static_cast<int>(argv.size()), argv.data()))
+    {
+        return false;
+    }
+    if (CommandLineArguments::OutputHandlerType::Stdout
+        != command_line_arguments.get_output_handler_type())
+    {
+        SPDLOG_ERROR("Requests can't specify an output handler.");
+        return false;
+    }
+    if (auto const& archive_id = command_line_arguments.get_archive_id();
+        false == archive_id.empty() && false == is_plain_archive_id(archive_id))
+    {
+        SPDLOG_ERROR("Invalid archive ID '{}'", archive_id);
+        return false;
+    }
+
+    SPDLOG_INFO("Searching for '{}'", command_line_arguments.get_query());
+    return search(command_line_arguments, &archive_reader_cache, connection_fd, max_num_results);
+}
+
+bool serve(CommandLineArguments const& command_line_arguments) {
+    auto const& archives_dir = command_line_arguments.get_archives_dir();
+    if (false == std::filesystem::is_directory(archives_dir)) {
+        SPDLOG_ERROR("'{}' is not a directory.", archives_dir);
+        return false;
+    }
+
+    int const server_socket_fd = create_server_socket(command_line_arguments);
+    if (-1 == server_socket_fd) {
+        return false;
+    }
+
+    // Clients which disconnect before reading all of their results shouldn't stop the server
+    std::signal(SIGPIPE, SIG_IGN);
+
+    clp_s::ArchiveReaderCache archive_reader_cache(
+            archives_dir,
+            command_line_arguments.get_archive_cache_size(),
+            command_line_arguments.get_max_cached_archives()
+    );
+    constexpr std::chrono::milliseconds cMinAcceptRetryDelay{10};
+    constexpr std::chrono::milliseconds cMaxAcceptRetryDelay{1000};
+    constexpr timeval cSendTimeout{.tv_sec = 30, .tv_usec = 0};
+
+    // Accepted connections are handed to a fixed number of workers. Once every worker is busy,
+    // connections aren't accepted until one finishes, so new clients wait in the socket's backlog.
+    auto const max_num_concurrent_requests = command_line_arguments.get_max_concurrent_requests();
+    std::mutex connections_mutex;
+    std::condition_variable connections_changed;
+    std::deque<int> pending_connection_fds;
+    size_t num_open_connections{0};
+    auto serve_connections = [&]() {
+        while (true) {
+            int connection_fd{-1};
+            {
+                std::unique_lock<std::mutex> lock(connections_mutex);
+                connections_changed.wait(lock, [&]() {
+                    return false == pending_connection_fds.empty();
+                });
+                connection_fd = pending_connection_fds.front();
+                pending_connection_fds.pop_front();
+            }
+
+            // A request which fails for any reason shouldn't stop the server
+            try {
+                if (false
+                    == handle_search_request(
+                            connection_fd,
+                            command_line_arguments.get_program_name(),
+                            archives_dir,
+                            archive_reader_cache,
+                            command_line_arguments.get_num_threads()
+                    ))
+                {
+                    SPDLOG_ERROR("Failed to serve search request.");
+                }
+            } catch (std::exception const& e) {
+                SPDLOG_ERROR("Failed to serve search request - {}", e.what());
+            }
+            close(connection_fd);
+            SPDLOG_DEBUG(
+                    "Archive cache is using {} of {} B",
+                    archive_reader_cache.get_memory_usage(),
+                    command_line_arguments.get_archive_cache_size()
+            );
+
+            {
+                std::lock_guard<std::mutex> const lock(connections_mutex);
+                --num_open_connections;
+            }
+            connections_changed.notify_all();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(max_num_concurrent_requests);
+    for (size_t i = 0; i < max_num_concurrent_requests; ++i) {
+        workers.emplace_back(serve_connections);
+    }
+
+    SPDLOG_INFO("Serving searches of '{}'", archives_dir);
+    auto accept_retry_delay = cMinAcceptRetryDelay;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(connections_mutex);
+            connections_changed.wait(lock, [&]() {
+                return num_open_connections < max_num_concurrent_requests;
+            });
+        }
+
+        int const connection_fd = accept(server_socket_fd, nullptr, nullptr);
+        if (-1 == connection_fd) {
+            if (EINTR == errno) {
+                continue;
+            }
+            // Back off while accepting keeps failing (e.g., because the server is out of file
+            // descriptors) rather than spinning
+            SPDLOG_ERROR("Failed to accept connection, errno={}", errno);
+            std::this_thread::sleep_for(accept_retry_delay);
+            accept_retry_delay = std::min(accept_retry_delay * 2, cMaxAcceptRetryDelay);
+            continue;
+        }
+        accept_retry_delay = cMinAcceptRetryDelay;
+
+        // Clients which stop reading their results are dropped once a write times out
+        if (0
+            != setsockopt(
+                    connection_fd,
+                    SOL_SOCKET,
+                    SO_SNDTIMEO,
+                    &cSendTimeout,
+                    sizeof(cSendTimeout)
+            ))
+        {
+            SPDLOG_ERROR("Failed to set connection's send timeout, errno={}", errno);
+            close(connection_fd);
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> const lock(connections_mutex);
+            ++num_open_connections;
+            pending_connection_fds.push_back(connection_fd);
+        }
+        connections_changed.notify_all();
+    }
+}
 }  // namespace
 
 int main(int argc, char const* argv[]) {
     try {
-        auto stderr_logger = spdlog::stderr_logger_st("stderr");
+        auto stderr_logger = spdlog::stderr_logger_mt("stderr");
         spdlog::set_default_logger(stderr_logger);
         spdlog::set_pattern("%Y-%m-%dT%H:%M:%S.%e%z [%l] %v");
     } catch (std::exception& e) {
@@ -272,6 +1245,7 @@ int main(int argc, char const* argv[]) {
         clp_s::JsonConstructorOption option;
         option.output_dir = command_line_arguments.get_output_dir();
         option.ordered = command_line_arguments.get_ordered_decompression();
+        option.num_threads = command_line_arguments.get_num_threads();
         option.archives_dir = archives_dir;
         try {
             auto const& archive_id = command_line_arguments.get_archive_id();
@@ -289,78 +1263,20 @@ int main(int argc, char const* argv[]) {
                     decompress_archive(option);
                 }
             }
-        } catch (clp_s::TraceableException& e) {
+        } catch (std::exception const& e) {
             SPDLOG_ERROR("{}", e.what());
             return 1;
         }
-    } else {
+    } else if (CommandLineArguments::Command::Serve == command_line_arguments.get_command()) {
         mongocxx::instance const mongocxx_instance{};
-
-        auto const& query = command_line_arguments.get_query();
-        auto query_stream = std::istringstream(query);
-        auto expr = kql::parse_kql_expression(query_stream);
-        if (nullptr == expr) {
+        if (false == serve(command_line_arguments)) {
             return 1;
         }
-
-        if (std::dynamic_pointer_cast<EmptyExpr>(expr)) {
-            SPDLOG_ERROR("Query '{}' is logically false", query);
-            return 1;
-        }
-
-        auto const& archives_dir = command_line_arguments.get_archives_dir();
-        if (false == std::filesystem::is_directory(archives_dir)) {
-            SPDLOG_ERROR("'{}' is not a directory.", archives_dir);
+    } else {
+        mongocxx::instance const mongocxx_instance{};
+        if (false == search(command_line_arguments, nullptr, -1, 0)) {
             return 1;
         }
-
-        int reducer_socket_fd{-1};
-        if (command_line_arguments.get_output_handler_type()
-            == CommandLineArguments::OutputHandlerType::Reducer)
-        {
-            reducer_socket_fd = reducer::connect_to_reducer(
-                    command_line_arguments.get_reducer_host(),
-                    command_line_arguments.get_reducer_port(),
-                    command_line_arguments.get_job_id()
-            );
-            if (-1 == reducer_socket_fd) {
-                SPDLOG_ERROR("Failed to connect to reducer");
-                return 1;
-            }
-        }
-
-        auto const& archive_id = command_line_arguments.get_archive_id();
-        auto archive_reader = std::make_shared<clp_s::ArchiveReader>();
-        if (false == archive_id.empty()) {
-            archive_reader->open(archives_dir, archive_id);
-            if (false
-                == search_archive(command_line_arguments, archive_reader, expr, reducer_socket_fd))
-            {
-                return 1;
-            }
-            archive_reader->close();
-        } else {
-            for (auto const& entry : std::filesystem::directory_iterator(archives_dir)) {
-                if (false == entry.is_directory()) {
-                    // Skip non-directories
-                    continue;
-                }
-
-                auto const archive_id = entry.path().filename().string();
-                archive_reader->open(archives_dir, archive_id);
-                if (false
-                    == search_archive(
-                            command_line_arguments,
-                            archive_reader,
-                            expr->copy(),
-                            reducer_socket_fd
-                    ))
-                {
-                    return 1;
-                }
-                archive_reader->close();
-            }
-        }
     }
 
     return 0;
@@ -0,0 +1,82 @@
+#include "EvaluateVariableDictionaryFilter.hpp"
+
+#include "AndExpr.hpp"
+#include "FilterExpr.hpp"
+#include "OrExpr.hpp"
+
+namespace clp_s::search {
+EvaluatedValue EvaluateVariableDictionaryFilter::run(std::shared_ptr<Expression> const& expr) {
+    if (std::dynamic_pointer_cast<OrExpr>(expr)) {
+        if (expr->is_inverted()) {
+            return EvaluatedValue::Unknown;
+        }
+
+        for (auto it = expr->op_begin(); it != expr->op_end(); it++) {
+            auto sub_expr = std::static_pointer_cast<Expression>(*it);
+            if (EvaluatedValue::False != run(sub_expr)) {
+                return EvaluatedValue::Unknown;
+            }
+        }
+        // must have been all false
+        return EvaluatedValue::False;
+    } else if (std::dynamic_pointer_cast<AndExpr>(expr)) {
+        if (expr->is_inverted()) {
+            return EvaluatedValue::Unknown;
+        }
+
+        for (auto it = expr->op_begin(); it != expr->op_end(); it++) {
+            auto sub_expr = std::static_pointer_cast<Expression>(*it);
+            if (EvaluatedValue::False == run(sub_expr)) {
+                return EvaluatedValue::False;
+            }
+        }
+        return EvaluatedValue::Unknown;
+    } else if (auto filter = std::dynamic_pointer_cast<FilterExpr>(expr)) {
+        if (filter->is_inverted() || FilterOperation::EQ != filter->get_operation()
+            || m_ignore_case)
+        {
+            return EvaluatedValue::Unknown;
+        }
+
+        // Values of any other type (e.g., clp strings or arrays) aren't in the filter
+        auto column = filter->get_column();
+        auto operand = filter->get_operand();
+        bool const matches_only_var_strings
+                = column->matches_exactly(LiteralType::VarStringT)
+                  || (false == m_has_arrays
+                      && column->matches_exactly(LiteralType::VarStringT | LiteralType::ArrayT));
+        if (false == matches_only_var_strings
+            || false == operand->matches_exactly(LiteralType::VarStringT))
+        {
+            return EvaluatedValue::Unknown;
+        }
+
+        std::string query_string;
+        if (false == operand->as_var_string(query_string, filter->get_operation())
+            || StringUtils::has_unescaped_wildcards(query_string))
+        {
+            return EvaluatedValue::Unknown;
+        }
+
+        std::string unescaped_query_string;
+        bool escape = false;
+        for (char const c : query_string) {
+            if (escape) {
+                unescaped_query_string.push_back(c);
+                escape = false;
+            } else if ('\\' == c) {
+                escape = true;
+            } else {
+                unescaped_query_string.push_back(c);
+            }
+        }
+
+        if (false == m_filter->possibly_contains(unescaped_query_string)) {
+            return EvaluatedValue::False;
+        }
+        return EvaluatedValue::Unknown;
+    } else {
+        return EvaluatedValue::Unknown;
+    }
+}
+}  // namespace clp_s::search
@@ -0,0 +1,42 @@
+#ifndef CLP_S_SEARCH_EVALUATEVARIABLEDICTIONARYFILTER_HPP
+#define CLP_S_SEARCH_EVALUATEVARIABLEDICTIONARYFILTER_HPP
+
+#include "../BloomFilter.hpp"
+#include "../Utils.hpp"
+#include "Expression.hpp"
+
+namespace clp_s::search {
+class EvaluateVariableDictionaryFilter {
+public:
+    // Constructors
+    EvaluateVariableDictionaryFilter(
+            std::shared_ptr<BloomFilter> const& filter,
+            bool has_arrays,
+            bool ignore_case
+    )
+            : m_filter(filter),
+              m_has_arrays(has_arrays),
+              m_ignore_case(ignore_case) {}
+
+    /**
+     * Takes an expression and attempts to prove that it can't match any record in an archive
+     * based on a bloom filter over the archive's variable dictionary. Only exact matches against
+     * variable strings can be proven false, since every variable string is stored in the variable
+     * dictionary. Columns which may also match arrays can only be proven false if the archive
+     * doesn't contain any arrays.
+     *
+     * Should only be run after type narrowing.
+     *
+     * @param expr the expression to evaluate against the filter
+     * @return The evaluated value of the expression given the filter (False, Unknown)
+     */
+    EvaluatedValue run(std::shared_ptr<Expression> const& expr);
+
+private:
+    std::shared_ptr<BloomFilter> m_filter;
+    bool m_has_arrays;
+    bool m_ignore_case;
+};
+}  // namespace clp_s::search
+
+#endif  // CLP_S_SEARCH_EVALUATEVARIABLEDICTIONARYFILTER_HPP
@@ -1,5 +1,10 @@
 #include "Output.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -17,6 +22,71 @@
 #define eval(op, a, b) (((op) == FilterOperation::EQ) ? ((a) == (b)) : ((a) != (b)))
 
 namespace clp_s::search {
+namespace {
+/**
+ * Compares every value in a column against an operand, marking the messages whose values satisfy
+ * the comparison in `result`. The loop is branch-free over the column's contiguous values, with the
+ * comparator inlined, so that compilers can auto-vectorize it.
+ * @tparam T
+ * @tparam Comparator
+ * @param values
+ * @param operand
+ * @param comparator
+ * @param result
+ */
+template <typename T, typename Comparator>
+void compare_column(
+        UnalignedMemSpan<T> values,
+        T operand,
+        Comparator comparator,
+        std::vector<uint8_t>& result
+) {
+    size_t const num_values = values.size();
+    for (size_t i = 0; i < num_values; ++i) {
+        result[i] |= static_cast<uint8_t>(comparator(values[i], operand));
+    }
+}
+
+/**
+ * Compares every value in a column against an operand using the given filter operation
+ * @tparam T
+ * @param op
+ * @param values
+ * @param operand
+ * @param result
+ */
+template <typename T>
+void compare_column(
+        FilterOperation op,
+        UnalignedMemSpan<T> values,
+        T operand,
+        std::vector<uint8_t>& result
+) {
+    switch (op) {
+        case FilterOperation::EQ:
+            compare_column(values, operand, std::equal_to<T>{}, result);
+            break;
+        case FilterOperation::NEQ:
+            compare_column(values, operand, std::not_equal_to<T>{}, result);
+            break;
+        case FilterOperation::LT:
+            compare_column(values, operand, std::less<T>{}, result);
+            break;
+        case FilterOperation::GT:
+            compare_column(values, operand, std::greater<T>{}, result);
+            break;
+        case FilterOperation::LTE:
+            compare_column(values, operand, std::less_equal<T>{}, result);
+            break;
+        case FilterOperation::GTE:
+            compare_column(values, operand, std::greater_equal<T>{}, result);
+            break;
+        default:
+            break;
+    }
+}
+}  // namespace
+
 bool Output::filter() {
     auto top_level_expr = m_expr;
 
@@ -24,6 +94,16 @@ bool Output::filter() {
     bool has_array = false;
     bool has_array_search = false;
 
+    // Skip the archive if none of its messages can be later than the output handler's threshold.
+    // Messages without a timestamp are given a timestamp of 0.
+    if (auto const timestamp_threshold = m_output_handler->get_timestamp_threshold();
+        timestamp_threshold.has_value()
+        && std::max<epochtime_t>(m_timestamp_dict->get_end_timestamp(), 0)
+                   <= timestamp_threshold.value())
+    {
+        return true;
+    }
+
     m_archive_reader->read_metadata();
     for (auto schema_id : m_archive_reader->get_schema_ids()) {
         if (m_match.schema_matched(schema_id)) {
@@ -47,7 +127,6 @@ bool Output::filter() {
     // range index
     EvaluateTimestampIndex timestamp_index(m_archive_reader->get_timestamp_dictionary());
     if (timestamp_index.run(top_level_expr) == EvaluatedValue::False) {
-        m_archive_reader->close();
         return true;
     }
 
@@ -65,7 +144,6 @@ bool Output::filter() {
     populate_string_queries(top_level_expr);
 
     std::string message;
-    auto const archive_id = m_archive_reader->get_archive_id();
     for (int32_t schema_id : matched_schemas) {
         m_expr_clp_query.clear();
         m_expr_var_match_map.clear();
@@ -83,22 +161,107 @@ bool Output::filter() {
         }
 
         add_wildcard_columns_to_searched_columns();
+        populate_searched_columns(schema_id);
+
+        auto const& table_metadata = m_archive_reader->get_table_metadata(schema_id);
+        std::vector<size_t> row_groups;
+        for (size_t row_group = 0; row_group < table_metadata.row_groups.size(); ++row_group) {
+            // Skip decompressing row groups which can't match based on their column statistics
+            if (row_group_may_match(table_metadata.row_groups[row_group])) {
+                row_groups.push_back(row_group);
+            }
+        }
 
-        auto& reader = m_archive_reader->read_table(
-                schema_id,
-                m_output_handler->should_output_metadata(),
-                m_should_marshal_records
-        );
-        reader.initialize_filter(this);
-
-        if (m_output_handler->should_output_metadata()) {
-            epochtime_t timestamp;
-            while (reader.get_next_message_with_timestamp(message, timestamp, this)) {
-                m_output_handler->write(message, timestamp, archive_id);
+        // When the output handler only keeps the latest results, search the row groups with the
+        // latest timestamps first so that the handler's threshold rises as early as possible, and
+        // skip the row groups which can't beat it
+        bool const has_timestamp_threshold
+                = m_output_handler->get_timestamp_threshold().has_value();
+        std::vector<std::optional<epochtime_t>> row_group_end_timestamps;
+        if (has_timestamp_threshold) {
+            row_group_end_timestamps.resize(table_metadata.row_groups.size());
+            for (auto row_group : row_groups) {
+                row_group_end_timestamps[row_group]
+                        = m_archive_reader->get_row_group_end_timestamp(
+                                schema_id,
+                                table_metadata.row_groups[row_group]
+                        );
+            }
+            std::stable_sort(row_groups.begin(), row_groups.end(), [&](size_t lhs, size_t rhs) {
+                return row_group_end_timestamps[lhs].value_or(cEpochTimeMax)
+                       > row_group_end_timestamps[rhs].value_or(cEpochTimeMax);
+            });
+        }
+        auto can_skip_row_group = [&](size_t row_group) {
+            if (false == has_timestamp_threshold) {
+                return false;
+            }
+            auto const& end_timestamp = row_group_end_timestamps[row_group];
+            return end_timestamp.has_value()
+                   && end_timestamp.value() <= m_output_handler->get_timestamp_threshold().value();
+        };
+
+        auto const should_extract_timestamp = m_output_handler->should_output_metadata();
+        if (m_num_threads > 1 && row_groups.size() > 1) {
+            // Decompress up to m_num_threads row groups ahead on worker threads while the row
+            // groups which have already been loaded are filtered on this thread
+            std::deque<std::future<std::unique_ptr<SchemaReader>>> pending_readers;
+            size_t next_row_group = 0;
+            auto has_next_row_group = [&]() {
+                while (next_row_group < row_groups.size()
+                       && can_skip_row_group(row_groups[next_row_group]))
+                {
+                    ++next_row_group;
+                }
+                return next_row_group < row_groups.size();
+            };
+            auto load_next_row_group = [&]() {
+                auto row_group = row_groups[next_row_group++];
+                std::unique_ptr<SchemaReader> reader;
+                if (m_schema_reader_pool.empty()) {
+                    reader = std::make_unique<SchemaReader>();
+                } else {
+                    reader = std::move(m_schema_reader_pool.back());
+                    m_schema_reader_pool.pop_back();
+                }
+                auto load = [=, this, reader = std::move(reader)]() mutable {
+                    m_archive_reader->read_row_group(
+                            *reader,
+                            schema_id,
+                            row_group,
+                            should_extract_timestamp,
+                            m_should_marshal_records,
+                            &m_searched_columns
+                    );
+                    return std::move(reader);
+                };
+                pending_readers.emplace_back(std::async(std::launch::async, std::move(load)));
+            };
+            while (pending_readers.size() < m_num_threads && has_next_row_group()) {
+                load_next_row_group();
+            }
+            while (false == pending_readers.empty()) {
+                auto reader = pending_readers.front().get();
+                pending_readers.pop_front();
+                if (has_next_row_group()) {
+                    load_next_row_group();
+                }
+                output_row_group(*reader, message);
+                m_schema_reader_pool.push_back(std::move(reader));
             }
         } else {
-            while (reader.get_next_message(message, this)) {
-                m_output_handler->write(message);
+            for (auto row_group : row_groups) {
+                if (can_skip_row_group(row_group)) {
+                    continue;
+                }
+                auto& reader = m_archive_reader->read_row_group(
+                        schema_id,
+                        row_group,
+                        should_extract_timestamp,
+                        m_should_marshal_records,
+                        &m_searched_columns
+                );
+                output_row_group(reader, message);
             }
         }
         auto ecode = m_output_handler->flush();
@@ -121,6 +284,66 @@ bool Output::filter() {
     return true;
 }
 
+void Output::populate_searched_columns(int32_t schema_id) {
+    m_searched_columns.clear();
+    for (int32_t column_id : m_schemas->at(schema_id)) {
+        if (Schema::schema_entry_is_unordered_object(column_id)) {
+            continue;
+        }
+        if ((0
+             != (m_wildcard_type_mask
+                 & node_to_literal_type(m_schema_tree->get_node(column_id).get_type())))
+            || m_match.schema_searches_against_column(schema_id, column_id)
+            || m_output_handler->reads_column(column_id))
+        {
+            m_searched_columns.insert(column_id);
+        }
+    }
+}
+
+bool Output::row_group_may_match(SchemaReader::RowGroupMetadata const& row_group_metadata) {
+    if (EvaluatedValue::True == m_expression_value) {
+        return true;
+    }
+
+    m_column_statistics.clear();
+    for (auto const& statistics : row_group_metadata.statistics) {
+        auto column_id = statistics.get_column_id();
+        auto [it, inserted] = m_column_statistics.try_emplace(column_id, statistics);
+        if (false == inserted) {
+            it->second.merge(statistics);
+        }
+    }
+    return EvaluatedValue::False != evaluate_statistics(m_expr.get());
+}
+
+void Output::output_row_group(SchemaReader& reader, std::string& message) {
+    reader.initialize_filter(this);
+    if (m_output_handler->should_read_columns()) {
+        m_output_handler->init_table(reader.get_column_readers());
+        uint64_t cur_message;
+        while (reader.get_next_message_index(cur_message, this)) {
+            m_output_handler->write_row(cur_message);
+        }
+    } else if (m_output_handler->should_output_metadata()) {
+        auto const archive_id = m_archive_reader->get_archive_id();
+        epochtime_t timestamp;
+        while (reader.get_next_message_with_timestamp(
+                message,
+                timestamp,
+                this,
+                m_output_handler->get_timestamp_threshold()
+        ))
+        {
+            m_output_handler->write(message, timestamp, archive_id);
+        }
+    } else {
+        while (reader.get_next_message(message, this)) {
+            m_output_handler->write(message);
+        }
+    }
+}
+
 void Output::init(
         SchemaReader* reader,
         int32_t schema_id,
@@ -133,14 +356,11 @@ void Output::init(
     m_var_string_readers.clear();
     m_datestring_readers.clear();
     m_basic_readers.clear();
+    m_extracted_unstructured_arrays.clear();
 
     for (auto column_reader : column_readers) {
         auto column_id = column_reader->get_id();
-        if ((0
-             != (m_wildcard_type_mask
-                 & node_to_literal_type(m_schema_tree->get_node(column_id).get_type())))
-            || m_match.schema_searches_against_column(schema_id, column_id))
-        {
+        if (m_searched_columns.contains(column_id)) {
             ClpStringColumnReader* clp_reader = dynamic_cast<ClpStringColumnReader*>(column_reader);
             VariableStringColumnReader* var_reader
                     = dynamic_cast<VariableStringColumnReader*>(column_reader);
@@ -161,26 +381,33 @@ void Output::init(
 }
 
 std::string& Output::get_cached_decompressed_unstructured_array(int32_t column_id) {
-    auto it = m_extracted_unstructured_arrays.find(column_id);
-    if (m_extracted_unstructured_arrays.end() != it) {
-        return it->second;
-    }
-
     // Unstructured arrays with the same column id can not appear multiple times in one schema
-    // in the current implementation.
-    auto rit = m_extracted_unstructured_arrays.emplace(
-            column_id,
-            std::get<std::string>(m_basic_readers[column_id][0]->extract_value(m_cur_message))
-    );
-    return rit.first->second;
+    // in the current implementation. Each column's buffer is reused for every message.
+    auto& [message, array] = m_extracted_unstructured_arrays[column_id];
+    if (message != m_cur_message || array.empty()) {
+        message = m_cur_message;
+        array.clear();
+        m_basic_readers[column_id][0]->extract_string_value_into_buffer(m_cur_message, array);
+    }
+    return array;
 }
 
 bool Output::filter(uint64_t cur_message) {
     m_cur_message = cur_message;
-    m_extracted_unstructured_arrays.clear();
     return evaluate(m_expr.get(), m_schema);
 }
 
+bool Output::filter_batch(uint64_t num_messages, std::vector<uint8_t>& selection) {
+    std::vector<uint8_t> candidates(num_messages, 1);
+    if (m_expression_value == EvaluatedValue::True) {
+        selection.swap(candidates);
+        return true;
+    }
+
+    evaluate_batch(m_expr.get(), candidates, selection);
+    return true;
+}
+
 bool Output::evaluate(Expression* expr, int32_t schema) {
     if (m_expression_value == EvaluatedValue::True) {
         return true;
@@ -255,6 +482,161 @@ bool Output::evaluate(Expression* expr, int32_t schema) {
     return ret;
 }
 
+void Output::evaluate_batch(
+        Expression* expr,
+        std::vector<uint8_t> const& candidates,
+        std::vector<uint8_t>& result
+) {
+    size_t const num_messages = candidates.size();
+    auto has_candidates = [](std::vector<uint8_t> const& selection) {
+        return std::any_of(selection.begin(), selection.end(), [](uint8_t selected) {
+            return 0 != selected;
+        });
+    };
+
+    if (auto* filter_expr = dynamic_cast<FilterExpr*>(expr); nullptr != filter_expr) {
+        result.assign(num_messages, 0);
+        if (evaluate_filter_batch(filter_expr, candidates, result)) {
+            for (size_t i = 0; i < num_messages; ++i) {
+                result[i] &= candidates[i];
+            }
+        } else {
+            // Fall back to evaluating the filter on each candidate message individually
+            bool const is_wildcard = filter_expr->get_column()->is_pure_wildcard();
+            for (size_t i = 0; i < num_messages; ++i) {
+                if (0 == candidates[i]) {
+                    continue;
+                }
+                m_cur_message = i;
+                result[i] = is_wildcard ? evaluate_wildcard_filter(filter_expr, m_schema)
+                                        : evaluate_filter(filter_expr, m_schema);
+            }
+        }
+    } else if (dynamic_cast<AndExpr*>(expr)) {
+        // Each operand is only evaluated on the messages matched by all previous operands
+        result = candidates;
+        std::vector<uint8_t> operand_result;
+        for (auto it = expr->op_begin(); it != expr->op_end() && has_candidates(result); ++it) {
+            evaluate_batch(static_cast<Expression*>(it->get()), result, operand_result);
+            result.swap(operand_result);
+        }
+    } else {
+        // Each operand is only evaluated on the messages not matched by any previous operand
+        result.assign(num_messages, 0);
+        std::vector<uint8_t> remaining = candidates;
+        std::vector<uint8_t> operand_result;
+        for (auto it = expr->op_begin(); it != expr->op_end() && has_candidates(remaining); ++it) {
+            evaluate_batch(static_cast<Expression*>(it->get()), remaining, operand_result);
+            for (size_t i = 0; i < num_messages; ++i) {
+                result[i] |= operand_result[i];
+                remaining[i] &= operand_result[i] ^ 1;
+            }
+        }
+    }
+
+    if (expr->is_inverted()) {
+        for (size_t i = 0; i < num_messages; ++i) {
+            result[i] = candidates[i] & (result[i] ^ 1);
+        }
+    }
+}
+
+EvaluatedValue Output::evaluate_statistics(Expression* expr) {
+    EvaluatedValue ret;
+    if (auto* filter_expr = dynamic_cast<FilterExpr*>(expr); nullptr != filter_expr) {
+        ret = evaluate_filter_statistics(filter_expr);
+    } else {
+        // Operands of an AND (OR) determine its value as soon as one is false (true)
+        bool const is_and = nullptr != dynamic_cast<AndExpr*>(expr);
+        EvaluatedValue const deciding_value = is_and ? EvaluatedValue::False : EvaluatedValue::True;
+        ret = is_and ? EvaluatedValue::True : EvaluatedValue::False;
+        for (auto it = expr->op_begin(); it != expr->op_end(); ++it) {
+            auto operand_value = evaluate_statistics(static_cast<Expression*>(it->get()));
+            if (deciding_value == operand_value) {
+                ret = deciding_value;
+                break;
+            }
+            if (EvaluatedValue::Unknown == operand_value) {
+                ret = EvaluatedValue::Unknown;
+            }
+        }
+    }
+
+    if (expr->is_inverted() && EvaluatedValue::Unknown != ret) {
+        return EvaluatedValue::True == ret ? EvaluatedValue::False : EvaluatedValue::True;
+    }
+    return ret;
+}
+
+EvaluatedValue Output::evaluate_filter_statistics(FilterExpr* expr) {
+    auto* column = expr->get_column().get();
+    auto op = expr->get_operation();
+    if (column->is_pure_wildcard() || FilterOperation::EXISTS == op
+        || FilterOperation::NEXISTS == op)
+    {
+        return EvaluatedValue::Unknown;
+    }
+
+    auto statistics_it = m_column_statistics.find(column->get_column_id());
+    if (m_column_statistics.end() == statistics_it) {
+        return EvaluatedValue::Unknown;
+    }
+    auto const& statistics = statistics_it->second;
+    auto literal = expr->get_operand();
+    switch (column->get_literal_type()) {
+        case LiteralType::IntegerT:
+        case LiteralType::EpochDateT: {
+            if (ColumnStatistics::Type::IntegerRange != statistics.get_type()) {
+                return EvaluatedValue::Unknown;
+            }
+            int64_t op_value;
+            if (false == literal->as_int(op_value, op)) {
+                return EvaluatedValue::False;
+            }
+            return statistics.evaluate_filter(op, op_value);
+        }
+        case LiteralType::FloatT: {
+            if (ColumnStatistics::Type::FloatRange != statistics.get_type()) {
+                return EvaluatedValue::Unknown;
+            }
+            double op_value;
+            if (false == literal->as_float(op_value, op)) {
+                return EvaluatedValue::False;
+            }
+            return statistics.evaluate_filter(op, op_value);
+        }
+        case LiteralType::VarStringT: {
+            auto matching_vars_it = m_expr_var_match_map.find(expr);
+            if (m_expr_var_match_map.end() == matching_vars_it) {
+                return EvaluatedValue::Unknown;
+            }
+            return statistics.evaluate_filter(op, *matching_vars_it->second);
+        }
+        case LiteralType::ClpStringT: {
+            auto query_it = m_expr_clp_query.find(expr);
+            if (ColumnStatistics::Type::DictionaryIds != statistics.get_type()
+                || (FilterOperation::EQ != op && FilterOperation::NEQ != op)
+                || m_expr_clp_query.end() == query_it || nullptr == query_it->second
+                || query_it->second->search_string_matches_all()
+                || false == query_it->second->contains_sub_queries())
+            {
+                return EvaluatedValue::Unknown;
+            }
+            // Messages can only match if their logtype matches one of the query's subqueries
+            for (auto id : statistics.get_dictionary_ids()) {
+                for (auto const& subquery : query_it->second->get_sub_queries()) {
+                    if (subquery.matches_logtype(id)) {
+                        return EvaluatedValue::Unknown;
+                    }
+                }
+            }
+            return FilterOperation::EQ == op ? EvaluatedValue::False : EvaluatedValue::True;
+        }
+        default:
+            return EvaluatedValue::Unknown;
+    }
+}
+
 bool Output::evaluate_wildcard_filter(FilterExpr* expr, int32_t schema) {
     auto literal = expr->get_operand();
     auto* column = expr->get_column().get();
@@ -365,6 +747,121 @@ bool Output::evaluate_filter(FilterExpr* expr, int32_t schema) {
     }
 }
 
+bool Output::evaluate_filter_batch(
+        FilterExpr* expr,
+        std::vector<uint8_t> const& candidates,
+        std::vector<uint8_t>& result
+) {
+    auto* column = expr->get_column().get();
+    if (column->is_pure_wildcard()) {
+        return false;
+    }
+
+    int32_t column_id = column->get_column_id();
+    auto op = expr->get_operation();
+    auto literal = expr->get_operand();
+    auto literal_type = column->get_literal_type();
+    switch (literal_type) {
+        case LiteralType::IntegerT:
+        case LiteralType::FloatT:
+        case LiteralType::BooleanT:
+        case LiteralType::ClpStringT:
+        case LiteralType::VarStringT:
+        case LiteralType::EpochDateT:
+            break;
+        default:
+            return false;
+    }
+
+    if (FilterOperation::EXISTS == op || FilterOperation::NEXISTS == op) {
+        std::fill(result.begin(), result.end(), 1);
+        return true;
+    }
+
+    switch (literal_type) {
+        case LiteralType::IntegerT: {
+            int64_t op_value;
+            if (false == literal->as_int(op_value, op)) {
+                return true;
+            }
+            for (BaseColumnReader* reader : m_basic_readers[column_id]) {
+                auto values = static_cast<Int64ColumnReader*>(reader)->get_values();
+                compare_column(op, values, op_value, result);
+            }
+            return true;
+        }
+        case LiteralType::FloatT: {
+            double op_value;
+            if (false == literal->as_float(op_value, op)) {
+                return true;
+            }
+            for (BaseColumnReader* reader : m_basic_readers[column_id]) {
+                auto values = static_cast<FloatColumnReader*>(reader)->get_values();
+                compare_column(op, values, op_value, result);
+            }
+            return true;
+        }
+        case LiteralType::BooleanT: {
+            bool op_value;
+            if (false == literal->as_bool(op_value, op)
+                || (FilterOperation::EQ != op && FilterOperation::NEQ != op))
+            {
+                return true;
+            }
+            for (BaseColumnReader* reader : m_basic_readers[column_id]) {
+                auto values = static_cast<BooleanColumnReader*>(reader)->get_values();
+                compare_column(op, values, static_cast<uint8_t>(op_value), result);
+            }
+            return true;
+        }
+        case LiteralType::ClpStringT: {
+            auto query_it = m_expr_clp_query.find(expr);
+            evaluate_clp_string_filter_batch(
+                    op,
+                    m_expr_clp_query.end() == query_it ? nullptr : query_it->second,
+                    m_clp_string_readers[column_id],
+                    candidates,
+                    result
+            );
+            return true;
+        }
+        case LiteralType::VarStringT: {
+            if (FilterOperation::EQ != op && FilterOperation::NEQ != op) {
+                return true;
+            }
+            auto* matching_vars = m_expr_var_match_map.at(expr);
+            for (VariableStringColumnReader* reader : m_var_string_readers[column_id]) {
+                auto ids = reader->get_variable_ids();
+                if (1 == matching_vars->size()) {
+                    auto id = static_cast<uint64_t>(*matching_vars->begin());
+                    compare_column(op, ids, id, result);
+                    continue;
+                }
+                bool const is_eq = FilterOperation::EQ == op;
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    bool matched = matching_vars->count(static_cast<int64_t>(ids[i])) > 0;
+                    result[i] |= static_cast<uint8_t>(is_eq == matched);
+                }
+            }
+            return true;
+        }
+        case LiteralType::EpochDateT: {
+            auto it = m_datestring_readers.find(column_id);
+            if (m_datestring_readers.end() == it) {
+                return false;
+            }
+            int64_t op_value;
+            if (false == literal->as_int(op_value, op)) {
+                return true;
+            }
+            compare_column(op, it->second->get_encoded_times(), op_value, result);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
 bool Output::evaluate_int_filter(
         FilterOperation op,
         int32_t column_id,
@@ -504,6 +1001,62 @@ bool Output::evaluate_clp_string_filter(
     return false;
 }
 
+void Output::evaluate_clp_string_filter_batch(
+        FilterOperation op,
+        Query* q,
+        std::vector<ClpStringColumnReader*> const& readers,
+        std::vector<uint8_t> const& candidates,
+        std::vector<uint8_t>& result
+) {
+    if (op != FilterOperation::EQ && op != FilterOperation::NEQ) {
+        return;
+    }
+
+    bool const is_eq = FilterOperation::EQ == op;
+    if (nullptr == q || q->search_string_matches_all()) {
+        // Every message either matches or doesn't, regardless of its value
+        if (is_eq == (nullptr != q)) {
+            std::fill(result.begin(), result.end(), 1);
+        }
+        return;
+    }
+
+    // Only candidates are evaluated since matching a value may require decompressing it
+    std::string value;
+    for (ClpStringColumnReader* reader : readers) {
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (0 == candidates[i] || 0 != result[i]) {
+                continue;
+            }
+
+            bool matched = false;
+            bool wildcard_match_required = true;
+            if (q->contains_sub_queries()) {
+                wildcard_match_required = false;
+                int64_t id = reader->get_encoded_id(i);
+                auto vars = reader->get_encoded_vars(i);
+                for (auto const& subquery : q->get_sub_queries()) {
+                    if (subquery.matches_logtype(id) && subquery.matches_vars(vars)) {
+                        matched = true;
+                        wildcard_match_required = subquery.wildcard_match_required();
+                        break;
+                    }
+                }
+            }
+            if (wildcard_match_required) {
+                value.clear();
+                reader->extract_string_value_into_buffer(i, value);
+                matched = StringUtils::wildcard_match_unsafe(
+                        value,
+                        q->get_search_string(),
+                        !q->get_ignore_case()
+                );
+            }
+            result[i] = static_cast<uint8_t>(is_eq == matched);
+        }
+    }
+}
+
 bool Output::evaluate_var_string_filter(
         FilterOperation op,
         std::vector<VariableStringColumnReader*> const& readers,
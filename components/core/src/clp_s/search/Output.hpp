@@ -2,6 +2,7 @@
 #define CLP_S_SEARCH_OUTPUT_HPP
 
 #include <map>
+#include <optional>
 #include <set>
 #include <stack>
 #include <string>
@@ -30,7 +31,8 @@ public:
            std::shared_ptr<ArchiveReader> archive_reader,
            std::shared_ptr<TimestampDictionaryReader> timestamp_dict,
            std::unique_ptr<OutputHandler> output_handler,
-           bool ignore_case)
+           bool ignore_case,
+           size_t num_threads = 1)
             : m_archive_reader(std::move(archive_reader)),
               m_schema_tree(m_archive_reader->get_schema_tree()),
               m_schemas(m_archive_reader->get_schema_map()),
@@ -39,6 +41,7 @@ public:
               m_timestamp_dict(std::move(timestamp_dict)),
               m_output_handler(std::move(output_handler)),
               m_ignore_case(ignore_case),
+              m_num_threads(num_threads),
               m_should_marshal_records(m_output_handler->should_marshal_records()) {}
 
     /**
@@ -59,7 +62,11 @@ private:
     SchemaMatch& m_match;
     std::unique_ptr<OutputHandler> m_output_handler;
     bool m_ignore_case;
+    size_t m_num_threads;
     bool m_should_marshal_records{true};
+    // Schema readers which are reused when loading row groups in parallel, so that their buffers
+    // and decompressors don't need to be reallocated for every row group
+    std::vector<std::unique_ptr<SchemaReader>> m_schema_reader_pool;
 
     // variables for the current schema being filtered
     int32_t m_schema;
@@ -81,7 +88,10 @@ private:
     std::unordered_map<int32_t, std::vector<VariableStringColumnReader*>> m_var_string_readers;
     std::unordered_map<int32_t, DateStringColumnReader*> m_datestring_readers;
     std::unordered_map<int32_t, std::vector<BaseColumnReader*>> m_basic_readers;
-    std::unordered_map<int32_t, std::string> m_extracted_unstructured_arrays;
+    // The decompressed unstructured array of each column, and the message it was decompressed from
+    std::unordered_map<int32_t, std::pair<uint64_t, std::string>> m_extracted_unstructured_arrays;
+    std::unordered_map<int32_t, ColumnStatistics> m_column_statistics;
+    std::unordered_set<int32_t> m_searched_columns;
     uint64_t m_cur_message;
     EvaluatedValue m_expression_value;
 
@@ -119,6 +129,19 @@ private:
      */
     bool evaluate(Expression* expr, int32_t schema);
 
+    /**
+     * Evaluates an expression on every candidate message in the current table at once
+     * @param expr
+     * @param candidates whether each message in the table should be evaluated
+     * @param result Returns whether each message matches the expression. Messages which aren't
+     * candidates never match.
+     */
+    void evaluate_batch(
+            Expression* expr,
+            std::vector<uint8_t> const& candidates,
+            std::vector<uint8_t>& result
+    );
+
     /**
      * Evaluates a filter expression
      * @param expr
@@ -127,6 +150,77 @@ private:
      */
     bool evaluate_filter(FilterExpr* expr, int32_t schema);
 
+    /**
+     * Evaluates a filter expression on the messages in the current table by scanning its columns
+     * directly, without evaluating the expression tree for each message. Only filters on integer,
+     * float, boolean, clp string, variable string, and date string columns can be evaluated this
+     * way. Cheap comparisons are made on every message, while clp string filters are only
+     * evaluated on candidate messages.
+     * @param expr
+     * @param candidates whether each message in the table should be evaluated
+     * @param result Returns whether each message matches the expression. Messages which aren't
+     * candidates may be marked as matching.
+     * @return true if the filter was evaluated, false if it must be evaluated one message at a time
+     */
+    bool evaluate_filter_batch(
+            FilterExpr* expr,
+            std::vector<uint8_t> const& candidates,
+            std::vector<uint8_t>& result
+    );
+
+    /**
+     * Evaluates a filter on a clp string column for every candidate message in the current table
+     * @param op
+     * @param q The query the column's values must match, or nullptr if no value can match
+     * @param readers
+     * @param candidates whether each message in the table should be evaluated
+     * @param result Returns whether each candidate message matches the filter
+     */
+    static void evaluate_clp_string_filter_batch(
+            FilterOperation op,
+            Query* q,
+            std::vector<ClpStringColumnReader*> const& readers,
+            std::vector<uint8_t> const& candidates,
+            std::vector<uint8_t>& result
+    );
+
+    /**
+     * Populates the set of columns in the current schema which the query needs to read
+     * @param schema_id
+     */
+    void populate_searched_columns(int32_t schema_id);
+
+    /**
+     * Checks whether any message in a row group of the current schema may match the query, based
+     * on the row group's column statistics
+     * @param row_group_metadata
+     * @return true if the row group may contain matches, false otherwise
+     */
+    bool row_group_may_match(SchemaReader::RowGroupMetadata const& row_group_metadata);
+
+    /**
+     * Filters the messages of a row group and writes the matches to the output handler
+     * @param reader
+     * @param message a buffer to marshal matched messages into
+     */
+    void output_row_group(SchemaReader& reader, std::string& message);
+
+    /**
+     * Evaluates an expression against the column statistics of the current row group
+     * @param expr
+     * @return EvaluatedValue::True if every message in the row group matches the expression,
+     * EvaluatedValue::False if no message does, EvaluatedValue::Unknown otherwise
+     */
+    EvaluatedValue evaluate_statistics(Expression* expr);
+
+    /**
+     * Evaluates a filter expression against the column statistics of the current row group,
+     * ignoring whether the filter is inverted
+     * @param expr
+     * @return Same as evaluate_statistics
+     */
+    EvaluatedValue evaluate_filter_statistics(FilterExpr* expr);
+
     /**
      * Evaluates a wildcard filter expression
      * @param expr
@@ -376,6 +470,8 @@ private:
 
     // Methods inherited from FilterClass
     bool filter(uint64_t cur_message) override;
+
+    bool filter_batch(uint64_t num_messages, std::vector<uint8_t>& selection) override;
 };
 }  // namespace clp_s::search
 
@@ -1,5 +1,10 @@
 #include "OutputHandler.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -8,13 +13,141 @@
 
 #include "../../clp/networking/socket_utils.hpp"
 #include "../../reducer/CountOperator.hpp"
+#include "../../reducer/GroupTags.hpp"
 #include "../../reducer/network_utils.hpp"
 #include "../../reducer/Record.hpp"
+#include "../Utils.hpp"
 
 using std::string;
 using std::string_view;
 
 namespace clp_s::search {
+namespace {
+// Serializes writes from output handlers used by concurrent searches
+std::mutex stdout_mutex;
+std::mutex reducer_socket_mutex;
+std::mutex columnar_output_mutex;
+
+/**
+ * Writes all of the given data to a file descriptor
+ * @param fd
+ * @param data
+ * @return ErrorCodeSuccess on success
+ * @return ErrorCodeErrno on failure
+ */
+ErrorCode write_to_fd(int fd, string_view data);
+
+ErrorCode write_to_fd(int fd, string_view data) {
+    size_t num_bytes_written{0};
+    while (num_bytes_written < data.size()) {
+        auto const result
+                = ::write(fd, data.data() + num_bytes_written, data.size() - num_bytes_written);
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return ErrorCode::ErrorCodeErrno;
+        }
+        num_bytes_written += static_cast<size_t>(result);
+    }
+    return ErrorCode::ErrorCodeSuccess;
+}
+
+/**
+ * @param type
+ * @return the name of the JSON type that values of the given node type are output as, which
+ * qualifies group-by values so that, e.g., 5 and "5" are grouped separately
+ */
+string_view get_group_by_type_name(NodeType type);
+
+string_view get_group_by_type_name(NodeType type) {
+    switch (type) {
+        case NodeType::Integer:
+            return "int";
+        case NodeType::Float:
+            return "float";
+        case NodeType::Boolean:
+            return "bool";
+        case NodeType::ClpString:
+        case NodeType::VarString:
+        case NodeType::DateString:
+            return "string";
+        default:
+            return "unknown";
+    }
+}
+}  // namespace
+
+void StandardOutputHandler::write(
+        string_view message,
+        epochtime_t timestamp,
+        string_view archive_id
+) {
+    if (false == try_take_result()) {
+        return;
+    }
+    m_buffer.append(archive_id);
+    m_buffer.append(": ");
+    m_buffer.append(std::to_string(timestamp));
+    m_buffer.append(" ");
+    m_buffer.append(message);
+    if (m_buffer.size() >= cMaxBufferSize) {
+        if (auto const error_code = write_buffer(); ErrorCodeSuccess != error_code) {
+            throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        }
+    }
+}
+
+void StandardOutputHandler::write(string_view message) {
+    if (false == try_take_result()) {
+        return;
+    }
+    m_buffer.append(message);
+    if (m_buffer.size() >= cMaxBufferSize) {
+        if (auto const error_code = write_buffer(); ErrorCodeSuccess != error_code) {
+            throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        }
+    }
+}
+
+ErrorCode StandardOutputHandler::flush() {
+    return write_buffer();
+}
+
+ErrorCode StandardOutputHandler::write_buffer() {
+    if (m_buffer.empty()) {
+        return ErrorCode::ErrorCodeSuccess;
+    }
+    std::lock_guard<std::mutex> const lock(stdout_mutex);
+    if (-1 == m_output_fd) {
+        std::cout.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+        m_buffer.clear();
+        return ErrorCode::ErrorCodeSuccess;
+    }
+
+    auto const error_code = write_to_fd(m_output_fd, m_buffer);
+    m_buffer.clear();
+    return error_code;
+}
+
+bool StandardOutputHandler::try_take_result() {
+    if (nullptr == m_num_results_remaining) {
+        return true;
+    }
+    auto num_results_remaining = m_num_results_remaining->load(std::memory_order_relaxed);
+    do {
+        if (0 == num_results_remaining) {
+            return false;
+        }
+    } while (false
+             == m_num_results_remaining->compare_exchange_weak(
+                     num_results_remaining,
+                     num_results_remaining - 1,
+                     std::memory_order_relaxed
+             ));
+    return true;
+}
+
 NetworkOutputHandler::NetworkOutputHandler(
         string const& host,
         int port,
@@ -49,11 +182,13 @@ ResultsCacheOutputHandler::ResultsCacheOutputHandler(
         string const& collection,
         uint64_t batch_size,
         uint64_t max_num_results,
+        std::shared_ptr<std::atomic<epochtime_t>> latest_results_threshold,
         bool should_output_timestamp
 )
         : OutputHandler(should_output_timestamp, true),
           m_batch_size(batch_size),
-          m_max_num_results(max_num_results) {
+          m_max_num_results(max_num_results),
+          m_latest_results_threshold(std::move(latest_results_threshold)) {
     try {
         auto mongo_uri = mongocxx::uri(uri);
         m_client = mongocxx::client(mongo_uri);
@@ -64,7 +199,7 @@ ResultsCacheOutputHandler::ResultsCacheOutputHandler(
     }
 }
 
-ErrorCode ResultsCacheOutputHandler::flush() {
+ErrorCode ResultsCacheOutputHandler::finish() {
     size_t count = 0;
     while (false == m_latest_results.empty()) {
         auto result = std::move(*m_latest_results.top());
@@ -105,6 +240,11 @@ void ResultsCacheOutputHandler::write(
         epochtime_t timestamp,
         string_view archive_id
 ) {
+    auto threshold = m_latest_results_threshold->load(std::memory_order_relaxed);
+    if (timestamp <= threshold) {
+        return;
+    }
+
     if (m_latest_results.size() < m_max_num_results) {
         m_latest_results.emplace(
                 std::make_unique<QueryResult>(string_view{}, message, timestamp, archive_id)
@@ -115,6 +255,20 @@ void ResultsCacheOutputHandler::write(
                 std::make_unique<QueryResult>(string_view{}, message, timestamp, archive_id)
         );
     }
+
+    if (m_latest_results.size() < m_max_num_results) {
+        return;
+    }
+    // None of the latest results can be at or before the earliest result kept by any handler
+    auto const earliest_kept_timestamp = m_latest_results.top()->timestamp;
+    while (threshold < earliest_kept_timestamp
+           && false
+                      == m_latest_results_threshold->compare_exchange_weak(
+                              threshold,
+                              earliest_kept_timestamp,
+                              std::memory_order_relaxed
+                      ))
+    {}
 }
 
 CountOutputHandler::CountOutputHandler(int reducer_socket_fd)
@@ -129,6 +283,7 @@ void CountOutputHandler::write(string_view message) {
 }
 
 ErrorCode CountOutputHandler::finish() {
+    std::lock_guard<std::mutex> const lock(reducer_socket_mutex);
     if (false
         == reducer::send_pipeline_results(m_reducer_socket_fd, std::move(m_pipeline.finish())))
     {
@@ -138,6 +293,7 @@ ErrorCode CountOutputHandler::finish() {
 }
 
 ErrorCode CountByTimeOutputHandler::finish() {
+    std::lock_guard<std::mutex> const lock(reducer_socket_mutex);
     if (false
         == reducer::send_pipeline_results(
                 m_reducer_socket_fd,
@@ -152,4 +308,353 @@ ErrorCode CountByTimeOutputHandler::finish() {
     return ErrorCode::ErrorCodeSuccess;
 }
 
+AggregationOutputHandler::AggregationOutputHandler(
+        int reducer_socket_fd,
+        reducer::AggregationType aggregation_type,
+        string const& field,
+        string const& group_by_field,
+        SchemaTree const& schema_tree
+)
+        : OutputHandler(false, false, true),
+          m_reducer_socket_fd(reducer_socket_fd),
+          m_aggregation_type(aggregation_type) {
+    resolve_column(field, schema_tree, m_field_columns);
+    if (false == group_by_field.empty()) {
+        resolve_column(group_by_field, schema_tree, m_group_by_columns);
+    }
+
+    // Only numeric columns can be aggregated
+    std::erase_if(m_field_columns, [&](int32_t column_id) {
+        auto const type = schema_tree.get_node(column_id).get_type();
+        return NodeType::Integer != type && NodeType::Float != type;
+    });
+}
+
+void AggregationOutputHandler::resolve_column(
+        string const& column,
+        SchemaTree const& schema_tree,
+        std::unordered_set<int32_t>& matching_nodes
+) {
+    std::vector<string> tokens;
+    StringUtils::tokenize_column_descriptor(column, tokens);
+    if (tokens.empty()
+        || std::any_of(tokens.begin(), tokens.end(), [](auto const& token) {
+               return token.empty();
+           }))
+    {
+        SPDLOG_ERROR("Aggregated column '{}' is invalid", column);
+        throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
+    }
+    if (schema_tree.get_nodes().empty()) {
+        return;
+    }
+
+    // Keys can map to several nodes with different types, so follow every matching child
+    std::vector<int32_t> cur_nodes{schema_tree.get_root_node_id()};
+    for (auto const& token : tokens) {
+        std::vector<int32_t> next_nodes;
+        for (auto node_id : cur_nodes) {
+            for (auto child_id : schema_tree.get_node(node_id).get_children_ids()) {
+                if (schema_tree.get_node(child_id).get_key_name() == token) {
+                    next_nodes.push_back(child_id);
+                }
+            }
+        }
+        cur_nodes = std::move(next_nodes);
+    }
+
+    for (auto node_id : cur_nodes) {
+        switch (schema_tree.get_node(node_id).get_type()) {
+            case NodeType::Integer:
+            case NodeType::Float:
+            case NodeType::ClpString:
+            case NodeType::VarString:
+            case NodeType::Boolean:
+            case NodeType::DateString:
+                matching_nodes.insert(node_id);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void AggregationOutputHandler::init_table(std::vector<BaseColumnReader*> const& column_readers) {
+    m_int64_reader = nullptr;
+    m_float_reader = nullptr;
+    m_group_by_reader = nullptr;
+    m_var_string_group_by_reader = nullptr;
+    m_typed_group_states = nullptr;
+
+    // A record can't contain a key more than once, so each table has at most one matching column
+    for (auto* column_reader : column_readers) {
+        auto const column_id = column_reader->get_id();
+        if (m_field_columns.contains(column_id)) {
+            m_int64_reader = dynamic_cast<Int64ColumnReader*>(column_reader);
+            m_float_reader = dynamic_cast<FloatColumnReader*>(column_reader);
+        }
+        if (m_group_by_columns.contains(column_id)) {
+            m_group_by_reader = column_reader;
+            m_var_string_group_by_reader = dynamic_cast<VariableStringColumnReader*>(column_reader);
+            m_typed_group_states
+                    = &m_group_states[string{get_group_by_type_name(column_reader->get_type())}];
+        }
+    }
+}
+
+void AggregationOutputHandler::write_row(uint64_t cur_message) {
+    if (nullptr != m_int64_reader) {
+        get_group_state(cur_message).add(m_int64_reader->get_values()[cur_message]);
+    } else if (nullptr != m_float_reader) {
+        get_group_state(cur_message).add(m_float_reader->get_values()[cur_message]);
+    }
+}
+
+reducer::AggregationState& AggregationOutputHandler::get_group_state(uint64_t cur_message) {
+    if (nullptr != m_var_string_group_by_reader) {
+        // Dictionary IDs are stable within an archive, so each is only resolved to a group once
+        auto& state = m_variable_id_to_group_state[static_cast<uint64_t>(
+                m_var_string_group_by_reader->get_variable_id(cur_message)
+        )];
+        if (nullptr == state) {
+            m_group_by_value.clear();
+            m_var_string_group_by_reader->extract_string_value_into_buffer(
+                    cur_message,
+                    m_group_by_value
+            );
+            state = &(*m_typed_group_states)[m_group_by_value];
+        }
+        return *state;
+    }
+
+    if (nullptr == m_group_by_reader) {
+        return m_ungrouped_state;
+    }
+    m_group_by_value.clear();
+    m_group_by_reader->extract_string_value_into_buffer(cur_message, m_group_by_value);
+    return (*m_typed_group_states)[m_group_by_value];
+}
+
+ErrorCode AggregationOutputHandler::finish() {
+    std::map<reducer::GroupTags, reducer::AggregationState> results;
+    if (m_ungrouped_state.get_count() > 0) {
+        results.emplace(reducer::GroupTags{}, m_ungrouped_state);
+    }
+    for (auto const& [type_name, group_states] : m_group_states) {
+        for (auto const& [group_by_value, state] : group_states) {
+            results.emplace(reducer::GroupTags{type_name, group_by_value}, state);
+        }
+    }
+
+    std::lock_guard<std::mutex> const lock(reducer_socket_mutex);
+    if (false
+        == reducer::send_pipeline_results(
+                m_reducer_socket_fd,
+                std::make_unique<reducer::AggregationStateMapRecordGroupIterator>(
+                        results,
+                        m_aggregation_type
+                )
+        ))
+    {
+        return ErrorCode::ErrorCodeFailureNetwork;
+    }
+    return ErrorCode::ErrorCodeSuccess;
+}
+
+void ColumnarOutputHandler::init_table(std::vector<BaseColumnReader*> const& column_readers) {
+    std::vector<int32_t> column_ids;
+    std::vector<BaseColumnReader*> output_readers;
+    for (auto* column_reader : column_readers) {
+        auto const column_id = column_reader->get_id();
+        if (false == reads_column(column_id) || nullptr == get_column_path(column_id)) {
+            continue;
+        }
+        column_ids.push_back(column_id);
+        output_readers.push_back(column_reader);
+    }
+
+    // Row groups of the same schema are added to the same batch
+    if (column_ids != m_column_ids) {
+        if (auto const error_code = write_batch(); ErrorCodeSuccess != error_code) {
+            throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        }
+        m_column_ids = std::move(column_ids);
+        m_columns.clear();
+        m_columns.resize(m_column_ids.size());
+        for (size_t i = 0; i < m_columns.size(); ++i) {
+            m_columns[i].type = output_readers[i]->get_type();
+            m_columns[i].path = get_column_path(m_column_ids[i]);
+        }
+    }
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        m_columns[i].reader = output_readers[i];
+    }
+}
+
+std::vector<string> const* ColumnarOutputHandler::get_column_path(int32_t column_id) {
+    auto it = m_column_paths.find(column_id);
+    if (m_column_paths.end() != it) {
+        return it->second.has_value() ? &it->second.value() : nullptr;
+    }
+
+    auto& path = m_column_paths[column_id];
+    switch (m_schema_tree->get_node(column_id).get_type()) {
+        case NodeType::Integer:
+        case NodeType::Float:
+        case NodeType::Boolean:
+        case NodeType::ClpString:
+        case NodeType::VarString:
+        case NodeType::UnstructuredArray:
+        case NodeType::DateString:
+            break;
+        default:
+            return nullptr;
+    }
+
+    // Columns nested within structured arrays don't hold exactly one value per row
+    std::vector<string> keys;
+    auto const root_id = m_schema_tree->get_root_node_id();
+    int32_t node_id = column_id;
+    while (root_id != node_id) {
+        auto const& node = m_schema_tree->get_node(node_id);
+        if (-1 == node.get_parent_id()
+            || (column_id != node_id && NodeType::Object != node.get_type()))
+        {
+            return nullptr;
+        }
+        keys.push_back(node.get_key_name());
+        node_id = node.get_parent_id();
+    }
+    std::reverse(keys.begin(), keys.end());
+    path = std::move(keys);
+    return &path.value();
+}
+
+void ColumnarOutputHandler::write_row(uint64_t cur_message) {
+    for (auto& column : m_columns) {
+        switch (column.type) {
+            case NodeType::Integer:
+                column.int64_values.push_back(
+                        static_cast<Int64ColumnReader*>(column.reader)->get_values()[cur_message]
+                );
+                break;
+            case NodeType::Float:
+                column.float_values.push_back(
+                        static_cast<FloatColumnReader*>(column.reader)->get_values()[cur_message]
+                );
+                break;
+            case NodeType::Boolean:
+                column.int64_values.push_back(
+                        static_cast<BooleanColumnReader*>(column.reader)->get_values()[cur_message]
+                );
+                break;
+            case NodeType::DateString:
+                column.int64_values.push_back(static_cast<DateStringColumnReader*>(column.reader)
+                                                      ->get_encoded_time(cur_message));
+                break;
+            case NodeType::VarString: {
+                auto* reader = static_cast<VariableStringColumnReader*>(column.reader);
+                auto [it, inserted] = column.variable_id_to_dictionary_index.try_emplace(
+                        static_cast<uint64_t>(reader->get_variable_id(cur_message)),
+                        static_cast<uint32_t>(column.string_values.size())
+                );
+                if (inserted) {
+                    reader->extract_string_value_into_buffer(
+                            cur_message,
+                            column.string_values.emplace_back()
+                    );
+                }
+                column.dictionary_indices.push_back(it->second);
+                break;
+            }
+            default:
+                column.reader->extract_string_value_into_buffer(
+                        cur_message,
+                        column.string_values.emplace_back()
+                );
+                break;
+        }
+    }
+
+    if (++m_num_rows >= cMaxBatchSize) {
+        if (auto const error_code = write_batch(); ErrorCodeSuccess != error_code) {
+            throw OperationFailed(error_code, __FILENAME__, __LINE__);
+        }
+    }
+}
+
+ErrorCode ColumnarOutputHandler::write_batch() {
+    if (0 == m_num_rows) {
+        return ErrorCode::ErrorCodeSuccess;
+    }
+
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack_map(3);
+    packer.pack("archive_id");
+    packer.pack(m_archive_id);
+    packer.pack("num_rows");
+    packer.pack(m_num_rows);
+    packer.pack("columns");
+    packer.pack_array(m_columns.size());
+    for (auto& column : m_columns) {
+        bool const is_dictionary_encoded = NodeType::VarString == column.type;
+        packer.pack_map(is_dictionary_encoded ? 4 : 3);
+        packer.pack("path");
+        packer.pack(*column.path);
+        packer.pack("type");
+        switch (column.type) {
+            case NodeType::Integer:
+                packer.pack("int");
+                packer.pack("values");
+                packer.pack(column.int64_values);
+                break;
+            case NodeType::Float:
+                packer.pack("float");
+                packer.pack("values");
+                packer.pack(column.float_values);
+                break;
+            case NodeType::Boolean:
+                packer.pack("bool");
+                packer.pack("values");
+                packer.pack_array(column.int64_values.size());
+                for (auto const value : column.int64_values) {
+                    packer.pack(0 != value);
+                }
+                break;
+            case NodeType::DateString:
+                packer.pack("timestamp");
+                packer.pack("values");
+                packer.pack(column.int64_values);
+                break;
+            case NodeType::VarString:
+                packer.pack("dict");
+                packer.pack("values");
+                packer.pack(column.dictionary_indices);
+                packer.pack("dictionary");
+                packer.pack(column.string_values);
+                break;
+            case NodeType::UnstructuredArray:
+                packer.pack("json");
+                packer.pack("values");
+                packer.pack(column.string_values);
+                break;
+            default:
+                packer.pack("string");
+                packer.pack("values");
+                packer.pack(column.string_values);
+                break;
+        }
+
+        column.int64_values.clear();
+        column.float_values.clear();
+        column.string_values.clear();
+        column.dictionary_indices.clear();
+        column.variable_id_to_dictionary_index.clear();
+    }
+    m_num_rows = 0;
+
+    std::lock_guard<std::mutex> const lock(columnar_output_mutex);
+    return write_to_fd(m_output_fd, {buffer.data(), buffer.size()});
+}
 }  // namespace clp_s::search
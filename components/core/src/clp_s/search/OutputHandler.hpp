@@ -5,10 +5,17 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <mongocxx/client.hpp>
 #include <mongocxx/collection.hpp>
@@ -18,10 +25,14 @@
 #include <msgpack.hpp>
 #include <spdlog/spdlog.h>
 
+#include "../../reducer/Aggregation.hpp"
 #include "../../reducer/Pipeline.hpp"
 #include "../../reducer/RecordGroupIterator.hpp"
+#include "../ColumnReader.hpp"
 #include "../Defs.hpp"
+#include "../SchemaTree.hpp"
 #include "../TraceableException.hpp"
+#include "Projection.hpp"
 
 namespace clp_s::search {
 /**
@@ -30,9 +41,14 @@ namespace clp_s::search {
 class OutputHandler {
 public:
     // Constructors
-    explicit OutputHandler(bool should_output_metadata, bool should_marshal_records)
+    explicit OutputHandler(
+            bool should_output_metadata,
+            bool should_marshal_records,
+            bool should_read_columns = false
+    )
             : m_should_output_metadata(should_output_metadata),
-              m_should_marshal_records(should_marshal_records) {};
+              m_should_marshal_records(should_marshal_records),
+              m_should_read_columns(should_read_columns) {};
 
     // Destructor
     virtual ~OutputHandler() = default;
@@ -65,31 +81,113 @@ public:
      */
     virtual ErrorCode finish() { return ErrorCode::ErrorCodeSuccess; }
 
+    /**
+     * Handlers which only keep the latest results can return a threshold so that the search can
+     * skip archives, row groups, and records whose timestamps can't exceed it.
+     * @return the timestamp which a result must be later than to be kept by this handler, or
+     * std::nullopt if every result is kept
+     */
+    [[nodiscard]] virtual std::optional<epochtime_t> get_timestamp_threshold() const {
+        return std::nullopt;
+    }
+
+    /**
+     * Handlers which read columns directly must load the given column even if it isn't searched.
+     * @param column_id
+     * @return whether the handler reads the given column
+     */
+    [[nodiscard]] virtual bool reads_column(int32_t column_id) const { return false; }
+
+    /**
+     * Prepares to write the matching rows of a new table. Only called for handlers which read
+     * columns directly.
+     * @param column_readers The readers for every column in the table.
+     */
+    virtual void init_table(std::vector<BaseColumnReader*> const& column_readers) {}
+
+    /**
+     * Writes a matching row of the table passed to `init_table` by reading its column values
+     * directly. Only called for handlers which read columns directly.
+     * @param cur_message The index of the row in the table.
+     */
+    virtual void write_row(uint64_t cur_message) {}
+
     [[nodiscard]] bool should_output_metadata() const { return m_should_output_metadata; }
 
     [[nodiscard]] bool should_marshal_records() const { return m_should_marshal_records; }
 
+    [[nodiscard]] bool should_read_columns() const { return m_should_read_columns; }
+
 private:
     bool m_should_output_metadata;
     bool m_should_marshal_records;
+    bool m_should_read_columns;
 };
 
 /**
- * Output handler that writes to standard output.
+ * Output handler that writes to standard output, or to another file descriptor such as a client's
+ * connection. Results are buffered and written in blocks so that handlers used by concurrent
+ * searches don't interleave partial results.
  */
 class StandardOutputHandler : public OutputHandler {
 public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
     // Constructors
-    explicit StandardOutputHandler(bool should_output_metadata = false)
-            : OutputHandler(should_output_metadata, true) {}
+    /**
+     * @param should_output_metadata
+     * @param output_fd The file descriptor to write to, or -1 to write to standard output. The
+     * handler doesn't take ownership of it.
+     * @param num_results_remaining The number of results which can still be written, shared by the
+     * handlers of every archive in the search, or nullptr to write every result
+     */
+    explicit StandardOutputHandler(
+            bool should_output_metadata = false,
+            int output_fd = -1,
+            std::shared_ptr<std::atomic<uint64_t>> num_results_remaining = nullptr
+    )
+            : OutputHandler(should_output_metadata, true),
+              m_output_fd(output_fd),
+              m_num_results_remaining(std::move(num_results_remaining)) {}
+
+    // Destructor
+    ~StandardOutputHandler() override { write_buffer(); }
 
     // Methods inherited from OutputHandler
     void
-    write(std::string_view message, epochtime_t timestamp, std::string_view archive_id) override {
-        std::cout << archive_id << ": " << timestamp << " " << message;
-    }
+    write(std::string_view message, epochtime_t timestamp, std::string_view archive_id) override;
+
+    void write(std::string_view message) override;
+
+    ErrorCode flush() override;
+
+    ErrorCode finish() override { return flush(); }
 
-    void write(std::string_view message) override { std::cout << message; }
+private:
+    static constexpr size_t cMaxBufferSize = 64 * 1024;
+
+    /**
+     * Writes the buffered results to standard output or the output file descriptor
+     * @return ErrorCodeSuccess on success
+     * @return ErrorCodeErrno if the results couldn't be written to the file descriptor
+     */
+    ErrorCode write_buffer();
+
+    /**
+     * Takes a result from the shared number of results which can still be written
+     * @return Whether the result can be written
+     */
+    bool try_take_result();
+
+    std::string m_buffer;
+    int m_output_fd;
+    std::shared_ptr<std::atomic<uint64_t>> m_num_results_remaining;
 };
 
 /**
@@ -173,27 +271,42 @@ public:
     };
 
     // Constructor
+    /**
+     * @param uri
+     * @param collection
+     * @param batch_size
+     * @param max_num_results
+     * @param latest_results_threshold The timestamp of the `max_num_results`-th latest result found
+     * by any of the handlers sharing it. Handlers searching different archives for the same query
+     * should share it so that each can discard results which another has already beaten.
+     * @param should_output_metadata
+     */
     ResultsCacheOutputHandler(
             std::string const& uri,
             std::string const& collection,
             uint64_t batch_size,
             uint64_t max_num_results,
+            std::shared_ptr<std::atomic<epochtime_t>> latest_results_threshold,
             bool should_output_metadata = true
     );
 
     // Methods inherited from OutputHandler
     /**
-     * Flushes the output handler after each table that gets searched.
+     * Writes the latest results to the results cache once every table has been searched.
      * @return ErrorCodeSuccess on success
      * @return ErrorCodeFailureDbBulkWrite on failure to write results to the results cache
      */
-    ErrorCode flush() override;
+    ErrorCode finish() override;
 
     void
     write(std::string_view message, epochtime_t timestamp, std::string_view archive_id) override;
 
     void write(std::string_view message) override { write(message, 0, {}); }
 
+    [[nodiscard]] std::optional<epochtime_t> get_timestamp_threshold() const override {
+        return m_latest_results_threshold->load(std::memory_order_relaxed);
+    }
+
 private:
     mongocxx::client m_client;
     mongocxx::collection m_collection;
@@ -205,6 +318,7 @@ private:
             std::vector<std::unique_ptr<QueryResult>>,
             QueryResultGreaterTimestampComparator>
             m_latest_results;
+    std::shared_ptr<std::atomic<epochtime_t>> m_latest_results_threshold;
 };
 
 /**
@@ -266,6 +380,212 @@ private:
     std::map<int64_t, int64_t> m_bucket_counts;
     int64_t m_count_by_time_bucket_size;
 };
+
+/**
+ * Output handler that computes a sum, min, max, or average over a numeric column, optionally
+ * grouped by the value of another column, and sends the partial results to a reducer. Values are
+ * read directly from each table's column readers rather than from marshalled records, and
+ * variable string group-by keys are resolved once per dictionary entry.
+ */
+class AggregationOutputHandler : public OutputHandler {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    /**
+     * @param reducer_socket_fd
+     * @param aggregation_type
+     * @param field The column to aggregate.
+     * @param group_by_field The column to group by, or an empty string to aggregate every record
+     * into one group.
+     * @param schema_tree The schema tree of the archive being searched.
+     * @throw AggregationOutputHandler::OperationFailed if either column is invalid
+     */
+    AggregationOutputHandler(
+            int reducer_socket_fd,
+            reducer::AggregationType aggregation_type,
+            std::string const& field,
+            std::string const& group_by_field,
+            SchemaTree const& schema_tree
+    );
+
+    // Methods inherited from OutputHandler
+    void
+    write(std::string_view message, epochtime_t timestamp, std::string_view archive_id) override {}
+
+    void write(std::string_view message) override {}
+
+    [[nodiscard]] bool reads_column(int32_t column_id) const override {
+        return m_field_columns.contains(column_id) || m_group_by_columns.contains(column_id);
+    }
+
+    void init_table(std::vector<BaseColumnReader*> const& column_readers) override;
+
+    void write_row(uint64_t cur_message) override;
+
+    /**
+     * Flushes the partial aggregation results.
+     * @return ErrorCodeSuccess on success
+     * @return ErrorCodeFailureNetwork on network error
+     */
+    ErrorCode finish() override;
+
+private:
+    /**
+     * Finds every leaf node of the schema tree at the given column path
+     * @param column
+     * @param schema_tree
+     * @param matching_nodes Returns the IDs of the matching nodes
+     * @throw AggregationOutputHandler::OperationFailed if the column is invalid
+     */
+    static void resolve_column(
+            std::string const& column,
+            SchemaTree const& schema_tree,
+            std::unordered_set<int32_t>& matching_nodes
+    );
+
+    /**
+     * @param cur_message
+     * @return the aggregation state of the group the given row belongs to
+     */
+    reducer::AggregationState& get_group_state(uint64_t cur_message);
+
+    int m_reducer_socket_fd;
+    reducer::AggregationType m_aggregation_type;
+    std::unordered_set<int32_t> m_field_columns;
+    std::unordered_set<int32_t> m_group_by_columns;
+
+    // Readers of the current table
+    Int64ColumnReader* m_int64_reader{nullptr};
+    FloatColumnReader* m_float_reader{nullptr};
+    BaseColumnReader* m_group_by_reader{nullptr};
+    VariableStringColumnReader* m_var_string_group_by_reader{nullptr};
+
+    // Records without the group-by column are aggregated into the group with no tags. Other groups
+    // are tagged with the type and value of their group-by column.
+    reducer::AggregationState m_ungrouped_state;
+    std::unordered_map<std::string, std::unordered_map<std::string, reducer::AggregationState>>
+            m_group_states;
+    // The groups of the current table's group-by column type
+    std::unordered_map<std::string, reducer::AggregationState>* m_typed_group_states{nullptr};
+    std::unordered_map<uint64_t, reducer::AggregationState*> m_variable_id_to_group_state;
+    std::string m_group_by_value;
+};
+
+/**
+ * Output handler that writes matching records as msgpack column batches instead of JSON records.
+ * Values are read directly from each table's column readers, and every batch holds the rows of a
+ * single schema.
+ *
+ * Each batch is a map with the keys:
+ * - archive_id: The archive containing the rows.
+ * - num_rows: The number of rows in the batch.
+ * - columns: An array of maps, one per column, with the keys:
+ *   - path: The column's keys, from the outermost object inwards.
+ *   - type: One of "int", "float", "bool", "string", "dict", "json", or "timestamp".
+ *   - values: An array holding the column's value in each row. Values of "dict" columns are
+ *     indices into the column's dictionary, "json" columns hold serialized arrays, and "timestamp"
+ *     columns hold epoch timestamps.
+ *   - dictionary: For "dict" columns, the distinct strings referenced by the column's values.
+ */
+class ColumnarOutputHandler : public OutputHandler {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    /**
+     * @param output_fd The file descriptor to write batches to. The handler doesn't take ownership
+     * of it.
+     * @param archive_id
+     * @param schema_tree The schema tree of the archive being searched.
+     * @param projection The columns to output, or nullptr to output every column.
+     */
+    ColumnarOutputHandler(
+            int output_fd,
+            std::string archive_id,
+            std::shared_ptr<SchemaTree> schema_tree,
+            std::shared_ptr<Projection> projection
+    )
+            : OutputHandler(false, false, true),
+              m_output_fd(output_fd),
+              m_archive_id(std::move(archive_id)),
+              m_schema_tree(std::move(schema_tree)),
+              m_projection(std::move(projection)) {}
+
+    // Methods inherited from OutputHandler
+    void
+    write(std::string_view message, epochtime_t timestamp, std::string_view archive_id) override {}
+
+    void write(std::string_view message) override {}
+
+    [[nodiscard]] bool reads_column(int32_t column_id) const override {
+        return nullptr == m_projection || m_projection->matches_node(column_id);
+    }
+
+    void init_table(std::vector<BaseColumnReader*> const& column_readers) override;
+
+    void write_row(uint64_t cur_message) override;
+
+    /**
+     * Writes the batch of rows from the current schema.
+     * @return ErrorCodeSuccess on success
+     * @return ErrorCodeErrno if the batch couldn't be written
+     */
+    ErrorCode flush() override { return write_batch(); }
+
+    ErrorCode finish() override { return write_batch(); }
+
+private:
+    struct Column {
+        BaseColumnReader* reader{nullptr};
+        NodeType type{NodeType::Unknown};
+        std::vector<std::string> const* path{nullptr};
+        std::vector<int64_t> int64_values;
+        std::vector<double> float_values;
+        // Values of string and JSON columns, or the dictionary of dictionary-encoded columns
+        std::vector<std::string> string_values;
+        std::vector<uint32_t> dictionary_indices;
+        std::unordered_map<uint64_t, uint32_t> variable_id_to_dictionary_index;
+    };
+
+    static constexpr size_t cMaxBatchSize = 64 * 1024;
+
+    /**
+     * @param column_id
+     * @return the keys of the given column, or nullptr if the column can't be output
+     */
+    std::vector<std::string> const* get_column_path(int32_t column_id);
+
+    /**
+     * Writes the buffered rows as a batch and clears them
+     * @return ErrorCodeSuccess on success
+     * @return ErrorCodeErrno if the batch couldn't be written
+     */
+    ErrorCode write_batch();
+
+    int m_output_fd;
+    std::string m_archive_id;
+    std::shared_ptr<SchemaTree> m_schema_tree;
+    std::shared_ptr<Projection> m_projection;
+    std::unordered_map<int32_t, std::optional<std::vector<std::string>>> m_column_paths;
+
+    // Columns of the current batch
+    std::vector<int32_t> m_column_ids;
+    std::vector<Column> m_columns;
+    size_t m_num_rows{0};
+};
 }  // namespace clp_s::search
 
 #endif  // CLP_S_SEARCH_OUTPUTHANDLER_HPP
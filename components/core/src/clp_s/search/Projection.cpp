@@ -0,0 +1,66 @@
+#include "Projection.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "../Utils.hpp"
+
+namespace clp_s::search {
+Projection::Projection(std::vector<std::string> const& columns) {
+    for (auto const& column : columns) {
+        std::vector<std::string> tokens;
+        StringUtils::tokenize_column_descriptor(column, tokens);
+        if (std::any_of(tokens.begin(), tokens.end(), [](auto const& token) {
+                return token.empty();
+            }))
+        {
+            SPDLOG_ERROR("Projected column '{}' is invalid", column);
+            throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
+        }
+        if (m_selected_columns.end()
+            != std::find(m_selected_columns.begin(), m_selected_columns.end(), tokens))
+        {
+            SPDLOG_ERROR("Column '{}' is projected more than once", column);
+            throw OperationFailed(ErrorCodeBadParam, __FILENAME__, __LINE__);
+        }
+        m_selected_columns.emplace_back(std::move(tokens));
+    }
+}
+
+void Projection::resolve_columns(std::shared_ptr<SchemaTree> const& tree) {
+    m_matching_nodes.clear();
+    if (tree->get_nodes().empty()) {
+        return;
+    }
+
+    std::vector<int32_t> matching_nodes;
+    for (auto const& tokens : m_selected_columns) {
+        // Keys can map to several nodes with different types, so follow every matching child
+        std::vector<int32_t> cur_nodes{tree->get_root_node_id()};
+        for (auto const& token : tokens) {
+            std::vector<int32_t> next_nodes;
+            for (auto node_id : cur_nodes) {
+                for (auto child_id : tree->get_node(node_id).get_children_ids()) {
+                    if (tree->get_node(child_id).get_key_name() == token) {
+                        next_nodes.push_back(child_id);
+                    }
+                }
+            }
+            cur_nodes = std::move(next_nodes);
+        }
+        matching_nodes.insert(matching_nodes.end(), cur_nodes.begin(), cur_nodes.end());
+    }
+
+    // Every descendant of a projected node is also projected
+    while (false == matching_nodes.empty()) {
+        auto node_id = matching_nodes.back();
+        matching_nodes.pop_back();
+        if (false == m_matching_nodes.insert(node_id).second) {
+            continue;
+        }
+        auto const& children_ids = tree->get_node(node_id).get_children_ids();
+        matching_nodes.insert(matching_nodes.end(), children_ids.begin(), children_ids.end());
+    }
+}
+}  // namespace clp_s::search
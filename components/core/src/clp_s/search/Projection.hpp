@@ -0,0 +1,57 @@
+#ifndef CLP_S_SEARCH_PROJECTION_HPP
+#define CLP_S_SEARCH_PROJECTION_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../SchemaTree.hpp"
+#include "../TraceableException.hpp"
+
+namespace clp_s::search {
+/**
+ * The set of columns a search should output. A column is projected if its key path, or the key
+ * path of any of its ancestors, matches one of the selected columns. Columns which aren't
+ * projected are left out of marshalled records, and aren't decompressed unless the query needs
+ * them.
+ */
+class Projection {
+public:
+    // Types
+    class OperationFailed : public TraceableException {
+    public:
+        // Constructors
+        OperationFailed(ErrorCode error_code, char const* const filename, int line_number)
+                : TraceableException(error_code, filename, line_number) {}
+    };
+
+    // Constructors
+    /**
+     * @param columns '.' delimited key paths of the columns to project
+     * @throw OperationFailed if a column is empty or is selected more than once
+     */
+    explicit Projection(std::vector<std::string> const& columns);
+
+    // Methods
+    /**
+     * Resolves the selected columns against an archive's schema tree. Must be called before
+     * `matches_node` for each archive.
+     * @param tree
+     */
+    void resolve_columns(std::shared_ptr<SchemaTree> const& tree);
+
+    /**
+     * @param node_id
+     * @return true if the node with the given id in the most recently resolved schema tree is
+     * projected, false otherwise
+     */
+    bool matches_node(int32_t node_id) const { return m_matching_nodes.contains(node_id); }
+
+private:
+    std::vector<std::vector<std::string>> m_selected_columns;
+    std::unordered_set<int32_t> m_matching_nodes;
+};
+}  // namespace clp_s::search
+
+#endif  // CLP_S_SEARCH_PROJECTION_HPP
@@ -0,0 +1,179 @@
+#ifndef REDUCER_AGGREGATION_HPP
+#define REDUCER_AGGREGATION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string_view>
+
+namespace reducer {
+/**
+ * The aggregations that can be computed over a numeric value.
+ */
+enum class AggregationType : uint8_t {
+    Sum,
+    Min,
+    Max,
+    Avg
+};
+
+/**
+ * @param name
+ * @return The aggregation type with the given name (e.g., "sum"), or std::nullopt if there is no
+ * such aggregation
+ */
+inline std::optional<AggregationType> get_aggregation_type(std::string_view name) {
+    if ("sum" == name) {
+        return AggregationType::Sum;
+    }
+    if ("min" == name) {
+        return AggregationType::Min;
+    }
+    if ("max" == name) {
+        return AggregationType::Max;
+    }
+    if ("avg" == name) {
+        return AggregationType::Avg;
+    }
+    return std::nullopt;
+}
+
+/**
+ * The partial state of an aggregation over a group of values. Partial states computed separately
+ * (e.g., by different search workers) can be merged to produce the state of the combined group, so
+ * every aggregation type is tracked at once.
+ *
+ * Integer values are summed exactly, separately from float values, so the sum of a group is only
+ * promoted to a float once a float value is added or the integer sum overflows.
+ */
+class AggregationState {
+public:
+    static constexpr char cCountKey[] = "count";
+    static constexpr char cIntSumKey[] = "int_sum";
+    static constexpr char cFloatSumKey[] = "float_sum";
+    static constexpr char cIsIntegralKey[] = "is_integral";
+    static constexpr char cMinKey[] = "min";
+    static constexpr char cMaxKey[] = "max";
+    static constexpr char cResultKey[] = "result";
+
+    /**
+     * Adds an integer value to the group
+     * @param value
+     */
+    void add(int64_t value) {
+        ++m_count;
+        add_to_int_sum(value);
+        add_to_extrema(static_cast<double>(value));
+    }
+
+    /**
+     * Adds a float value to the group
+     * @param value
+     */
+    void add(double value) {
+        ++m_count;
+        m_float_sum += value;
+        m_is_integral = false;
+        add_to_extrema(value);
+    }
+
+    /**
+     * Merges the partial state of another group into this group
+     * @param count
+     * @param int_sum
+     * @param float_sum
+     * @param is_integral
+     * @param min
+     * @param max
+     */
+    void merge(
+            int64_t count,
+            int64_t int_sum,
+            double float_sum,
+            bool is_integral,
+            double min,
+            double max
+    ) {
+        if (0 == count) {
+            return;
+        }
+        m_count += count;
+        add_to_int_sum(int_sum);
+        m_float_sum += float_sum;
+        m_is_integral = m_is_integral && is_integral;
+        m_min = std::min(m_min, min);
+        m_max = std::max(m_max, max);
+    }
+
+    [[nodiscard]] int64_t get_count() const { return m_count; }
+
+    [[nodiscard]] int64_t get_int_sum() const { return m_int_sum; }
+
+    [[nodiscard]] double get_float_sum() const { return m_float_sum; }
+
+    /**
+     * @return Whether every value in the group is an integer and their sum fits in an int64_t, in
+     * which case the sum is `get_int_sum()`
+     */
+    [[nodiscard]] bool is_integral() const { return m_is_integral; }
+
+    [[nodiscard]] double get_sum() const { return static_cast<double>(m_int_sum) + m_float_sum; }
+
+    [[nodiscard]] double get_min() const { return m_min; }
+
+    [[nodiscard]] double get_max() const { return m_max; }
+
+    /**
+     * @param type
+     * @return The result of the given aggregation over the group
+     */
+    [[nodiscard]] double get_result(AggregationType type) const {
+        switch (type) {
+            case AggregationType::Sum:
+                return get_sum();
+            case AggregationType::Min:
+                return m_min;
+            case AggregationType::Max:
+                return m_max;
+            case AggregationType::Avg:
+                return 0 == m_count ? 0.0 : get_sum() / static_cast<double>(m_count);
+        }
+        return 0.0;
+    }
+
+private:
+    /**
+     * Adds a value to the integer sum, moving the sum into the float sum if it would overflow
+     * @param value
+     */
+    void add_to_int_sum(int64_t value) {
+        if ((value > 0 && m_int_sum > std::numeric_limits<int64_t>::max() - value)
+            || (value < 0 && m_int_sum < std::numeric_limits<int64_t>::min() - value))
+        {
+            m_float_sum += static_cast<double>(m_int_sum) + static_cast<double>(value);
+            m_int_sum = 0;
+            m_is_integral = false;
+            return;
+        }
+        m_int_sum += value;
+    }
+
+    /**
+     * @param value
+     */
+    void add_to_extrema(double value) {
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    int64_t m_count{0};
+    int64_t m_int_sum{0};
+    double m_float_sum{0.0};
+    bool m_is_integral{true};
+    double m_min{std::numeric_limits<double>::infinity()};
+    double m_max{-std::numeric_limits<double>::infinity()};
+};
+}  // namespace reducer
+
+#endif  // REDUCER_AGGREGATION_HPP
@@ -0,0 +1,39 @@
+#include "AggregationOperator.hpp"
+
+namespace reducer {
+void AggregationOperator::push_intra_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& state = m_group_states[tags];
+
+    for (; false == record_it.done(); record_it.next()) {
+        auto const& record = record_it.get();
+        state.merge(
+                record.get_int64_value(static_cast<char const*>(AggregationState::cCountKey)),
+                record.get_int64_value(static_cast<char const*>(AggregationState::cIntSumKey)),
+                record.get_double_value(static_cast<char const*>(AggregationState::cFloatSumKey)),
+                0 != record.get_int64_value(
+                        static_cast<char const*>(AggregationState::cIsIntegralKey)
+                ),
+                record.get_double_value(static_cast<char const*>(AggregationState::cMinKey)),
+                record.get_double_value(static_cast<char const*>(AggregationState::cMaxKey))
+        );
+    }
+}
+
+void AggregationOperator::push_inter_stage_record_group(
+        GroupTags const& tags,
+        ConstRecordIterator& record_it
+) {
+    auto& state = m_group_states[tags];
+
+    for (; false == record_it.done(); record_it.next()) {
+        state.add(record_it.get().get_double_value(static_cast<char const*>(cRecordElementKey)));
+    }
+}
+
+std::unique_ptr<RecordGroupIterator> AggregationOperator::get_stored_result_iterator() {
+    return std::make_unique<AggregationStateMapRecordGroupIterator>(m_group_states, m_type);
+}
+}  // namespace reducer
@@ -0,0 +1,39 @@
+#ifndef REDUCER_AGGREGATIONOPERATOR_HPP
+#define REDUCER_AGGREGATIONOPERATOR_HPP
+
+#include <map>
+#include <string>
+
+#include "Aggregation.hpp"
+#include "GroupTags.hpp"
+#include "Operator.hpp"
+
+namespace reducer {
+/**
+ * Operator that computes a sum, min, max, or average per record group.
+ *
+ * Intra-stage record groups hold partial aggregation states (e.g., as computed by each search
+ * worker) which are merged, while inter-stage records each contribute a single value.
+ */
+class AggregationOperator : public Operator {
+public:
+    static constexpr char cRecordElementKey[] = "value";
+
+    // Constructors
+    explicit AggregationOperator(AggregationType type) : m_type{type} {}
+
+    void
+    push_intra_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    void
+    push_inter_stage_record_group(GroupTags const& tags, ConstRecordIterator& record_it) override;
+
+    std::unique_ptr<RecordGroupIterator> get_stored_result_iterator() override;
+
+private:
+    AggregationType m_type;
+    std::map<GroupTags, AggregationState> m_group_states;
+};
+}  // namespace reducer
+
+#endif  // REDUCER_AGGREGATIONOPERATOR_HPP
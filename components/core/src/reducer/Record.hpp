@@ -1,12 +1,14 @@
 #ifndef REDUCER_RECORD_HPP
 #define REDUCER_RECORD_HPP
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 #include <variant>
 
+#include "Aggregation.hpp"
 #include "RecordTypedKeyIterator.hpp"
 
 namespace reducer {
@@ -93,6 +95,82 @@ private:
     int64_t m_value{};
 };
 
+/**
+ * Record implementation which exposes the partial state of an aggregation along with its result.
+ *
+ * The state associated with the record can be updated allowing this class to act as an adapter for
+ * a larger set of data.
+ */
+class AggregationStateRecordAdapter : public Record {
+public:
+    explicit AggregationStateRecordAdapter(AggregationType type) : m_type{type} {}
+
+    void set_record_value(AggregationState const& state) { m_state = &state; }
+
+    [[nodiscard]] int64_t get_int64_value(std::string_view key) const override {
+        if (AggregationState::cCountKey == key) {
+            return m_state->get_count();
+        }
+        if (AggregationState::cIntSumKey == key) {
+            return m_state->get_int_sum();
+        }
+        if (AggregationState::cIsIntegralKey == key) {
+            return m_state->is_integral() ? 1 : 0;
+        }
+        if (AggregationState::cResultKey == key) {
+            return m_state->get_int_sum();
+        }
+        return 0;
+    }
+
+    [[nodiscard]] double get_double_value(std::string_view key) const override {
+        if (AggregationState::cFloatSumKey == key) {
+            return m_state->get_float_sum();
+        }
+        if (AggregationState::cMinKey == key) {
+            return m_state->get_min();
+        }
+        if (AggregationState::cMaxKey == key) {
+            return m_state->get_max();
+        }
+        if (AggregationState::cResultKey == key) {
+            return m_state->get_result(m_type);
+        }
+        return 0.0;
+    }
+
+    [[nodiscard]] std::unique_ptr<RecordTypedKeyIterator> typed_key_iter() const override {
+        // Sums of integers are reported as integers so that they stay exact
+        if (AggregationType::Sum == m_type && m_state->is_integral()) {
+            return std::make_unique<SpanTypedKeyIterator>(cIntegralSumTypedKeys);
+        }
+        return std::make_unique<SpanTypedKeyIterator>(cTypedKeys);
+    }
+
+private:
+    static constexpr std::array<TypedRecordKey, 7> cTypedKeys{
+            TypedRecordKey{AggregationState::cCountKey, ValueType::Int64},
+            TypedRecordKey{AggregationState::cIntSumKey, ValueType::Int64},
+            TypedRecordKey{AggregationState::cFloatSumKey, ValueType::Double},
+            TypedRecordKey{AggregationState::cIsIntegralKey, ValueType::Int64},
+            TypedRecordKey{AggregationState::cMinKey, ValueType::Double},
+            TypedRecordKey{AggregationState::cMaxKey, ValueType::Double},
+            TypedRecordKey{AggregationState::cResultKey, ValueType::Double}
+    };
+    static constexpr std::array<TypedRecordKey, 7> cIntegralSumTypedKeys{
+            TypedRecordKey{AggregationState::cCountKey, ValueType::Int64},
+            TypedRecordKey{AggregationState::cIntSumKey, ValueType::Int64},
+            TypedRecordKey{AggregationState::cFloatSumKey, ValueType::Double},
+            TypedRecordKey{AggregationState::cIsIntegralKey, ValueType::Int64},
+            TypedRecordKey{AggregationState::cMinKey, ValueType::Double},
+            TypedRecordKey{AggregationState::cMaxKey, ValueType::Double},
+            TypedRecordKey{AggregationState::cResultKey, ValueType::Int64}
+    };
+
+    AggregationType m_type;
+    AggregationState const* m_state{nullptr};
+};
+
 /**
  * Record implementation for an empty record.
  */
@@ -5,6 +5,7 @@
 #include <set>
 #include <utility>
 
+#include "Aggregation.hpp"
 #include "RecordGroup.hpp"
 
 namespace reducer {
@@ -158,6 +159,39 @@ private:
     std::set<GroupTags>::const_iterator m_filter_end_it;
 };
 
+/**
+ * A RecordGroupIterator that exposes a map which maps GroupTags to the partial states of an
+ * aggregation.
+ */
+class AggregationStateMapRecordGroupIterator : public RecordGroupIterator {
+public:
+    AggregationStateMapRecordGroupIterator(
+            std::map<GroupTags, AggregationState> const& map,
+            AggregationType type
+    )
+            : m_map_it{map.cbegin()},
+              m_map_end_it{map.cend()},
+              m_record{type},
+              m_group{nullptr, m_record} {}
+
+    RecordGroup& get() override {
+        m_record.set_record_value(m_map_it->second);
+        m_group.set_tags(&m_map_it->first);
+        m_group.reset_record_iterator();
+        return m_group;
+    }
+
+    void next() override { ++m_map_it; }
+
+    bool done() override { return m_map_it == m_map_end_it; }
+
+private:
+    AggregationStateRecordAdapter m_record;
+    SingleRecordGroup m_group;
+    std::map<GroupTags, AggregationState>::const_iterator m_map_it;
+    std::map<GroupTags, AggregationState>::const_iterator m_map_end_it;
+};
+
 /**
  * A RecordGroupIterator over an empty RecordGroup.
  */
@@ -1,6 +1,9 @@
 #ifndef REDUCER_RECORDTYPEDKEYITERATOR_HPP
 #define REDUCER_RECORDTYPEDKEYITERATOR_HPP
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <string_view>
 
 namespace reducer {
@@ -23,7 +26,7 @@ class TypedRecordKey {
 public:
     TypedRecordKey() = default;
 
-    TypedRecordKey(std::string_view key, ValueType type) : m_key{key}, m_type{type} {}
+    constexpr TypedRecordKey(std::string_view key, ValueType type) : m_key{key}, m_type{type} {}
 
     [[nodiscard]] std::string_view get_key() const { return m_key; }
 
@@ -90,6 +93,24 @@ private:
     ValueType m_type;
     bool m_done{false};
 };
+
+/**
+ * A RecordTypedKeyIterator over a fixed list of elements.
+ */
+class SpanTypedKeyIterator : public RecordTypedKeyIterator {
+public:
+    explicit SpanTypedKeyIterator(std::span<TypedRecordKey const> keys) : m_keys{keys} {}
+
+    TypedRecordKey get() override { return m_keys[m_index]; }
+
+    void next() override { ++m_index; }
+
+    bool done() override { return m_index >= m_keys.size(); }
+
+private:
+    std::span<TypedRecordKey const> m_keys;
+    size_t m_index{0};
+};
 }  // namespace reducer
 
 #endif  // REDUCER_RECORDTYPEDKEYITERATOR_HPP
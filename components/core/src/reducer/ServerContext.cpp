@@ -1,5 +1,8 @@
 #include "ServerContext.hpp"
 
+#include <optional>
+#include <string>
+
 #include <bsoncxx/builder/stream/document.hpp>
 #include <json/single_include/nlohmann/json.hpp>
 #include <mongocxx/bulk_write.hpp>
@@ -12,6 +15,7 @@
 #include <msgpack.hpp>
 
 #include "../clp/spdlog_with_specializations.hpp"
+#include "AggregationOperator.hpp"
 #include "CommandLineArguments.hpp"
 #include "CountOperator.hpp"
 #include "DeserializedRecordGroup.hpp"
@@ -140,17 +144,34 @@ void ServerContext::decrement_num_active_receiver_tasks() {
     }
 }
 
-void ServerContext::set_up_pipeline(nlohmann::json const& query_config) {
+bool ServerContext::set_up_pipeline(nlohmann::json const& query_config) {
     m_job_id = query_config[cJobAttributes::JobId];
 
     SPDLOG_INFO("Setting up pipeline for job {}", m_job_id);
 
-    // For now, all pipelines only perform count and optionally, group-by time and count for the
-    // timeline aggregation.
+    // For now, pipelines either perform a single aggregation (e.g., sum) per group, or perform
+    // count and optionally, group-by time and count for the timeline aggregation.
     // TODO: We'll need to implement more general pipeline initialization once more operators are
     // needed.
     m_pipeline = std::make_unique<Pipeline>(PipelineInputMode::IntraStage);
-    m_pipeline->add_pipeline_stage(std::make_shared<CountOperator>());
+    if (query_config.count(cJobAttributes::Aggregation) > 0
+        && false == query_config[cJobAttributes::Aggregation].is_null())
+    {
+        auto const& aggregation = query_config[cJobAttributes::Aggregation];
+        std::optional<AggregationType> aggregation_type;
+        if (aggregation.is_string()) {
+            aggregation_type = get_aggregation_type(aggregation.template get<std::string>());
+        }
+        if (false == aggregation_type.has_value()) {
+            SPDLOG_ERROR("Unknown aggregation {} for job {}", aggregation.dump(), m_job_id);
+            return false;
+        }
+        m_pipeline->add_pipeline_stage(
+                std::make_shared<AggregationOperator>(aggregation_type.value())
+        );
+    } else {
+        m_pipeline->add_pipeline_stage(std::make_shared<CountOperator>());
+    }
 
     if (query_config.count(cJobAttributes::TimeBucketSize) > 0
         && false == query_config[cJobAttributes::TimeBucketSize].is_null())
@@ -160,6 +181,7 @@ void ServerContext::set_up_pipeline(nlohmann::json const& query_config) {
 
     auto collection_name = std::to_string(m_job_id);
     m_mongodb_results_collection = m_mongodb_results_database[collection_name];
+    return true;
 }
 
 void ServerContext::push_record_group(GroupTags const& tags, ConstRecordIterator& record_it) {
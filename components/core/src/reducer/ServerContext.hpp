@@ -26,6 +26,7 @@ enum class ServerStatus : uint8_t {
 namespace cJobAttributes {
 constexpr char JobId[] = "job_id";
 constexpr char TimeBucketSize[] = "count_by_time_bucket_size";
+constexpr char Aggregation[] = "aggregation";
 }  // namespace cJobAttributes
 
 /**
@@ -98,8 +99,9 @@ public:
     /**
      * Sets up an in-memory aggregation pipeline according to the given query config.
      * @param query_config
+     * @return Whether the pipeline was set up successfully.
      */
-    void set_up_pipeline(nlohmann::json const& query_config);
+    bool set_up_pipeline(nlohmann::json const& query_config);
 
     /**
      * Pushes a record group into the reducer pipeline.
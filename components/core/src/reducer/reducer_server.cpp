@@ -200,7 +200,11 @@ void SchedulerUpdateListenerTask::operator()(
 
     auto status = m_server_ctx->get_status();
     if (ServerStatus::Idle == status) {
-        m_server_ctx->set_up_pipeline(message);
+        if (false == m_server_ctx->set_up_pipeline(message)) {
+            m_server_ctx->set_status(ServerStatus::RecoverableFailure);
+            m_server_ctx->stop_event_loop();
+            return;
+        }
         m_server_ctx->set_status(ServerStatus::Running);
 
         if (m_server_ctx->is_timeline_aggregation()) {
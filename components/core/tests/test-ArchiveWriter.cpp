@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+#include <Catch2/single_include/catch2/catch.hpp>
+#include <json/single_include/nlohmann/json.hpp>
+
+#include "../src/clp_s/ArchiveReader.hpp"
+#include "../src/clp_s/ArchiveWriter.hpp"
+#include "../src/clp_s/DictionaryReader.hpp"
+#include "../src/clp_s/ParsedMessage.hpp"
+#include "../src/clp_s/Schema.hpp"
+
+using clp_s::ArchiveReader;
+using clp_s::ArchiveWriter;
+using clp_s::ArchiveWriterOption;
+using clp_s::NodeType;
+using clp_s::VariableDictionaryEntry;
+using clp_s::VariableDictionaryReader;
+
+namespace {
+constexpr char cTestArchivesDir[] = "unit-test-archive-writer";
+constexpr char cTimestampKey[] = "ts";
+
+/**
+ * @param i
+ * @return the timestamp of the i-th message, such that every spill holds messages from across the
+ * whole time range
+ */
+int64_t get_timestamp(int64_t i);
+
+/**
+ * Compresses messages with the given options into a new archive
+ * @param option
+ * @param num_messages
+ * @return the archive's id
+ */
+std::string write_archive(ArchiveWriterOption& option, int64_t num_messages);
+
+/**
+ * Searches the dictionary for the given search string
+ * @param var_dict
+ * @param search_string
+ * @param is_wildcard Whether to search for entries matching the string as a wildcard string, or
+ * for the entry exactly matching it
+ * @param ignore_case
+ * @return the sorted IDs of the matching entries
+ */
+std::vector<uint64_t> search_dictionary(
+        VariableDictionaryReader const& var_dict,
+        std::string const& search_string,
+        bool is_wildcard,
+        bool ignore_case
+);
+
+int64_t get_timestamp(int64_t i) {
+    return (i * 7919) % 1000;
+}
+
+std::string write_archive(ArchiveWriterOption& option, int64_t num_messages) {
+    option.id = boost::uuids::random_generator()();
+    ArchiveWriter writer{nullptr};
+    writer.open(option);
+
+    clp_s::ParsedMessage message;
+    for (int64_t i = 0; i < num_messages; ++i) {
+        writer.start_record();
+        auto const root = writer.add_node(-1, NodeType::Object, "");
+        auto const ts = writer.add_node(root, NodeType::Integer, cTimestampKey);
+        auto const text = writer.add_node(root, NodeType::ClpString, "text");
+        auto const id = writer.add_node(root, NodeType::VarString, "id");
+        clp_s::Schema schema;
+        schema.insert_ordered(ts);
+        schema.insert_ordered(text);
+        schema.insert_ordered(id);
+
+        auto const timestamp = get_timestamp(i);
+        auto const text_value = "request " + std::to_string(i) + " took "
+                                + std::to_string(timestamp) + " ms";
+        auto const id_value = "id-" + std::to_string(i);
+        message.add_value(ts, timestamp);
+        message.add_value(text, std::string_view{text_value});
+        message.add_value(id, std::string_view{id_value});
+        writer.ingest_timestamp_entry(cTimestampKey, ts, timestamp);
+
+        auto const schema_id = writer.add_schema(schema);
+        message.set_id(schema_id);
+        writer.append_message(schema_id, schema, message);
+        message.clear();
+    }
+    writer.close();
+    return boost::uuids::to_string(option.id);
+}
+
+std::vector<uint64_t> search_dictionary(
+        VariableDictionaryReader const& var_dict,
+        std::string const& search_string,
+        bool is_wildcard,
+        bool ignore_case
+) {
+    std::vector<uint64_t> ids;
+    if (false == is_wildcard) {
+        if (auto const* entry = var_dict.get_entry_matching_value(search_string, ignore_case);
+            nullptr != entry)
+        {
+            ids.push_back(entry->get_id());
+        }
+        return ids;
+    }
+
+    std::unordered_set<VariableDictionaryEntry const*> entries;
+    var_dict.get_entries_matching_wildcard_string(search_string, ignore_case, entries);
+    for (auto const* entry : entries) {
+        ids.push_back(entry->get_id());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+}  // namespace
+
+TEST_CASE("Test sorting spilled tables by timestamp", "[clp_s][ArchiveWriter]") {
+    constexpr int64_t cNumMessages = 10'000;
+    constexpr size_t cRowGroupSize = 128;
+
+    std::filesystem::remove_all(cTestArchivesDir);
+    std::filesystem::create_directory(cTestArchivesDir);
+
+    // Each message is a few dozen bytes, so the tables are spilled several times
+    ArchiveWriterOption option{};
+    option.archives_dir = cTestArchivesDir;
+    option.compression_level = 3;
+    option.row_group_size = cRowGroupSize;
+    option.max_buffered_table_size = 32 * 1024;
+    option.sort_by_timestamp = true;
+    option.num_threads = GENERATE(1, 4);
+    auto const archive_id = write_archive(option, cNumMessages);
+
+    ArchiveReader reader;
+    reader.open(cTestArchivesDir, archive_id);
+    reader.read_dictionaries_and_metadata();
+    REQUIRE(1 == reader.get_schema_ids().size());
+    auto const schema_id = reader.get_schema_ids().front();
+    auto const& table_metadata = reader.get_table_metadata(schema_id);
+    REQUIRE(cNumMessages == table_metadata.num_messages);
+
+    // The spilled runs are merged into full row groups which cover disjoint ranges of timestamps
+    REQUIRE((cNumMessages + cRowGroupSize - 1) / cRowGroupSize
+            == table_metadata.row_groups.size());
+    std::optional<clp_s::epochtime_t> prev_end_timestamp;
+    for (auto const& row_group_metadata : table_metadata.row_groups) {
+        auto const begin_timestamp
+                = reader.get_row_group_begin_timestamp(schema_id, row_group_metadata);
+        auto const end_timestamp
+                = reader.get_row_group_end_timestamp(schema_id, row_group_metadata);
+        REQUIRE(begin_timestamp.has_value());
+        REQUIRE(end_timestamp.has_value());
+        if (prev_end_timestamp.has_value()) {
+            REQUIRE(prev_end_timestamp.value() <= begin_timestamp.value());
+            REQUIRE(prev_end_timestamp.value() <= end_timestamp.value());
+        }
+        prev_end_timestamp = end_timestamp;
+    }
+
+    // Every message is intact, and messages with equal timestamps keep the order they were
+    // appended in
+    int64_t num_messages{0};
+    int64_t prev_timestamp{-1};
+    int64_t prev_index{-1};
+    std::string record;
+    for (size_t i = 0; i < table_metadata.row_groups.size(); ++i) {
+        auto& schema_reader = reader.read_row_group(schema_id, i, true, true);
+        while (schema_reader.get_next_message(record)) {
+            auto const json = nlohmann::json::parse(record);
+            auto const timestamp = json.at(cTimestampKey).get<int64_t>();
+            auto const id = json.at("id").get<std::string>();
+            auto const index = std::stoll(id.substr(std::string_view{"id-"}.size()));
+            REQUIRE(get_timestamp(index) == timestamp);
+            REQUIRE(json.at("text").get<std::string>()
+                    == "request " + std::to_string(index) + " took " + std::to_string(timestamp)
+                               + " ms");
+            REQUIRE(prev_timestamp <= timestamp);
+            if (prev_timestamp == timestamp) {
+                REQUIRE(prev_index < index);
+            }
+            prev_timestamp = timestamp;
+            prev_index = index;
+            ++num_messages;
+        }
+    }
+    REQUIRE(cNumMessages == num_messages);
+    reader.close();
+
+    std::filesystem::remove_all(cTestArchivesDir);
+}
+
+TEST_CASE("Test searching dictionaries before and after indexing", "[clp_s][ArchiveWriter]") {
+    constexpr int64_t cNumMessages = 1000;
+    constexpr int cNumSearches = 4;
+
+    struct Search {
+        std::string search_string;
+        bool is_wildcard;
+        bool ignore_case;
+        size_t num_matches;
+    };
+
+    // The variable dictionary holds "id-0" to "id-999"
+    auto const search = GENERATE(
+            Search{"id-5", false, false, 1},
+            Search{"id-1000", false, false, 0},
+            Search{"ID-5", false, false, 0},
+            Search{"ID-5", false, true, 1},
+            Search{"Id-999", false, true, 1},
+            Search{"id-1*", false, false, 0},
+            Search{"id-1*", true, false, 111},
+            Search{"*-99?", true, false, 10},
+            Search{"id-*5", true, false, 100},
+            Search{"ID-1*", true, false, 0},
+            Search{"ID-1*", true, true, 111},
+            Search{"*D-42*", true, true, 11},
+            Search{"id-\\*", true, false, 0},
+            Search{"*", true, false, cNumMessages}
+    );
+
+    std::filesystem::remove_all(cTestArchivesDir);
+    std::filesystem::create_directory(cTestArchivesDir);
+
+    ArchiveWriterOption option{};
+    option.archives_dir = cTestArchivesDir;
+    option.compression_level = 3;
+    option.row_group_size = 128;
+    option.num_threads = 1;
+    auto const archive_id = write_archive(option, cNumMessages);
+
+    ArchiveReader reader;
+    reader.open(cTestArchivesDir, archive_id);
+    reader.read_dictionaries_and_metadata();
+    auto const var_dict = reader.get_variable_dictionary();
+
+    // The first search scans every entry, and later ones use the index once it's built
+    REQUIRE(0 == var_dict->get_index_memory_usage());
+    auto const scanned_ids = search_dictionary(
+            *var_dict,
+            search.search_string,
+            search.is_wildcard,
+            search.ignore_case
+    );
+    REQUIRE(search.num_matches == scanned_ids.size());
+    for (int i = 1; i < cNumSearches; ++i) {
+        REQUIRE(scanned_ids
+                == search_dictionary(
+                        *var_dict,
+                        search.search_string,
+                        search.is_wildcard,
+                        search.ignore_case
+                ));
+    }
+    // Wildcard strings without three consecutive literal characters can't use the trigram index
+    if (false == search.is_wildcard || "*" != search.search_string) {
+        REQUIRE(0 < var_dict->get_index_memory_usage());
+    }
+    reader.close();
+
+    std::filesystem::remove_all(cTestArchivesDir);
+}
@@ -0,0 +1,248 @@
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Catch2/single_include/catch2/catch.hpp>
+
+#include "../src/clp_s/archive_constants.hpp"
+#include "../src/clp_s/BloomFilter.hpp"
+#include "../src/clp_s/FileReader.hpp"
+#include "../src/clp_s/FileWriter.hpp"
+#include "../src/clp_s/ReaderUtils.hpp"
+#include "../src/clp_s/search/AndExpr.hpp"
+#include "../src/clp_s/search/ColumnDescriptor.hpp"
+#include "../src/clp_s/search/ConvertToExists.hpp"
+#include "../src/clp_s/search/EvaluateVariableDictionaryFilter.hpp"
+#include "../src/clp_s/search/FilterExpr.hpp"
+#include "../src/clp_s/search/NarrowTypes.hpp"
+#include "../src/clp_s/search/OrExpr.hpp"
+#include "../src/clp_s/search/OrOfAndForm.hpp"
+#include "../src/clp_s/search/StringLiteral.hpp"
+
+using clp_s::BloomFilter;
+using clp_s::EvaluatedValue;
+using clp_s::search::AndExpr;
+using clp_s::search::ColumnDescriptor;
+using clp_s::search::ConvertToExists;
+using clp_s::search::EvaluateVariableDictionaryFilter;
+using clp_s::search::Expression;
+using clp_s::search::FilterExpr;
+using clp_s::search::FilterOperation;
+using clp_s::search::NarrowTypes;
+using clp_s::search::OrExpr;
+using clp_s::search::OrOfAndForm;
+using clp_s::search::StringLiteral;
+
+namespace {
+constexpr char cTestDir[] = "unit-test-bloom-filter";
+
+/**
+ * Creates a filter over the given key
+ * @param key
+ * @param op
+ * @param value
+ * @param inverted
+ * @return the filter expression
+ */
+std::shared_ptr<Expression>
+create_filter(std::string const& key, FilterOperation op, std::string const& value, bool inverted);
+
+/**
+ * Runs the passes run on a query before archives are skipped using their filters
+ * @param expr
+ * @return the transformed expression
+ */
+std::shared_ptr<Expression> prepare(std::shared_ptr<Expression> expr);
+
+/**
+ * @param filter
+ * @param expr
+ * @param has_arrays
+ * @param ignore_case
+ * @return the value of the expression given the filter
+ */
+EvaluatedValue evaluate(
+        std::shared_ptr<BloomFilter> const& filter,
+        std::shared_ptr<Expression> expr,
+        bool has_arrays = false,
+        bool ignore_case = false
+);
+
+std::shared_ptr<Expression>
+create_filter(std::string const& key, FilterOperation op, std::string const& value, bool inverted) {
+    auto column = ColumnDescriptor::create(key);
+    auto literal = StringLiteral::create(value);
+    return FilterExpr::create(column, op, literal, inverted);
+}
+
+std::shared_ptr<Expression> prepare(std::shared_ptr<Expression> expr) {
+    expr = OrOfAndForm().run(expr);
+    expr = NarrowTypes().run(expr);
+    return ConvertToExists().run(expr);
+}
+
+EvaluatedValue evaluate(
+        std::shared_ptr<BloomFilter> const& filter,
+        std::shared_ptr<Expression> expr,
+        bool has_arrays,
+        bool ignore_case
+) {
+    EvaluateVariableDictionaryFilter evaluator(filter, has_arrays, ignore_case);
+    return evaluator.run(prepare(std::move(expr)));
+}
+}  // namespace
+
+TEST_CASE("Test bloom filter membership", "[clp_s][BloomFilter]") {
+    constexpr size_t cNumValues = 10'000;
+    BloomFilter filter{cNumValues};
+    for (size_t i = 0; i < cNumValues; ++i) {
+        filter.add("value-" + std::to_string(i));
+    }
+
+    // Every added value must be found
+    for (size_t i = 0; i < cNumValues; ++i) {
+        REQUIRE(filter.possibly_contains("value-" + std::to_string(i)));
+    }
+
+    // The filter is sized for a false positive rate of about 1%
+    size_t num_false_positives{0};
+    for (size_t i = 0; i < cNumValues; ++i) {
+        if (filter.possibly_contains("absent-" + std::to_string(i))) {
+            ++num_false_positives;
+        }
+    }
+    REQUIRE(num_false_positives < cNumValues * 3 / 100);
+
+    // An empty filter rules values out, while a default constructed one rules nothing out
+    BloomFilter const empty_filter{0};
+    REQUIRE(false == empty_filter.possibly_contains("value-0"));
+    REQUIRE(BloomFilter{}.possibly_contains("value-0"));
+}
+
+TEST_CASE("Test writing and reading a bloom filter", "[clp_s][BloomFilter]") {
+    std::filesystem::create_directory(cTestDir);
+    auto const archive_path = std::string{cTestDir};
+    auto const filter_path = archive_path + clp_s::constants::cArchiveVarDictFilterFile;
+    std::filesystem::remove(filter_path);
+
+    // Archives written before filters were added don't have one, so nothing can be ruled out
+    REQUIRE(nullptr == clp_s::ReaderUtils::read_variable_dictionary_filter(archive_path));
+
+    std::vector<std::string> values{"", "a", "value with spaces", std::string(1000, 'x')};
+    for (size_t i = 0; i < 1000; ++i) {
+        values.push_back(std::to_string(i));
+    }
+    BloomFilter filter{values.size()};
+    for (auto const& value : values) {
+        filter.add(value);
+    }
+    clp_s::FileWriter writer;
+    writer.open(filter_path, clp_s::FileWriter::OpenMode::CreateForWriting);
+    auto const num_bytes_written = filter.write(writer);
+    writer.close();
+    REQUIRE(std::filesystem::file_size(filter_path) == num_bytes_written);
+
+    auto read_filter = clp_s::ReaderUtils::read_variable_dictionary_filter(archive_path);
+    REQUIRE(nullptr != read_filter);
+    for (auto const& value : values) {
+        REQUIRE(read_filter->possibly_contains(value));
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+        auto const absent_value = "absent-" + std::to_string(i);
+        REQUIRE(filter.possibly_contains(absent_value)
+                == read_filter->possibly_contains(absent_value));
+    }
+
+    // A truncated filter can't be read
+    std::filesystem::resize_file(filter_path, num_bytes_written - 1);
+    clp_s::FileReader reader;
+    reader.open(filter_path);
+    BloomFilter truncated_filter;
+    REQUIRE_THROWS_AS(truncated_filter.read(reader), BloomFilter::OperationFailed);
+    reader.close();
+
+    std::filesystem::remove_all(cTestDir);
+}
+
+TEST_CASE("Test skipping archives using a bloom filter", "[clp_s][BloomFilter]") {
+    auto filter = std::make_shared<BloomFilter>(2);
+    filter->add("present");
+    filter->add("a*b");
+    for (auto const* absent_value : {"absent", "other", "a?b"}) {
+        REQUIRE(false == filter->possibly_contains(absent_value));
+    }
+
+    auto const eq = FilterOperation::EQ;
+    auto present = [&]() { return create_filter("key", eq, "present", false); };
+    auto absent = [&]() { return create_filter("key", eq, "absent", false); };
+    auto other = [&]() { return create_filter("other_key", eq, "other", false); };
+
+    SECTION("Exact matches of variable strings") {
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, present()));
+        REQUIRE(EvaluatedValue::False == evaluate(filter, absent()));
+
+        // Escaped wildcards are matched literally
+        auto escaped_present = create_filter("key", eq, "a\\*b", false);
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, escaped_present));
+        auto escaped_absent = create_filter("key", eq, "a\\?b", false);
+        REQUIRE(EvaluatedValue::False == evaluate(filter, escaped_absent));
+    }
+
+    SECTION("Filters which can't be decided by the bloom filter") {
+        // Wildcards and values with spaces may match clp strings, which aren't in the filter
+        for (auto const* value : {"abs*", "abs?nt", "absent value"}) {
+            auto expr = create_filter("key", eq, value, false);
+            REQUIRE(EvaluatedValue::Unknown == evaluate(filter, expr));
+        }
+
+        // Only equality can be decided
+        for (auto op :
+             {FilterOperation::NEQ,
+              FilterOperation::LT,
+              FilterOperation::GT,
+              FilterOperation::LTE,
+              FilterOperation::GTE,
+              FilterOperation::EXISTS,
+              FilterOperation::NEXISTS})
+        {
+            CAPTURE(op);
+            auto expr = create_filter("key", op, "absent", false);
+            REQUIRE(EvaluatedValue::Unknown == evaluate(filter, expr));
+        }
+
+        // Inverted filters match everything except the value
+        auto inverted = create_filter("key", eq, "absent", true);
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, inverted));
+
+        // Case-insensitive matches may match values which differ from the filter's values
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, absent(), false, true));
+
+        // Values may match arrays, which aren't in the filter
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, absent(), true, false));
+    }
+
+    SECTION("Boolean expressions") {
+        std::shared_ptr<Expression> lhs = absent();
+        std::shared_ptr<Expression> rhs = present();
+        REQUIRE(EvaluatedValue::False == evaluate(filter, AndExpr::create(lhs, rhs)));
+        lhs = present();
+        rhs = present();
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, AndExpr::create(lhs, rhs)));
+
+        lhs = absent();
+        rhs = other();
+        REQUIRE(EvaluatedValue::False == evaluate(filter, OrExpr::create(lhs, rhs)));
+        lhs = absent();
+        rhs = present();
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, OrExpr::create(lhs, rhs)));
+
+        // Inverting an expression whose operands are all absent matches every record
+        lhs = absent();
+        rhs = other();
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, AndExpr::create(lhs, rhs, true)));
+        lhs = absent();
+        rhs = other();
+        REQUIRE(EvaluatedValue::Unknown == evaluate(filter, OrExpr::create(lhs, rhs, true)));
+    }
+}
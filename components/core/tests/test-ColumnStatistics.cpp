@@ -0,0 +1,308 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+#include <Catch2/single_include/catch2/catch.hpp>
+
+#include "../src/clp_s/ColumnStatistics.hpp"
+#include "../src/clp_s/search/FilterOperation.hpp"
+#include "../src/clp_s/Utils.hpp"
+#include "../src/clp_s/ZstdCompressor.hpp"
+#include "../src/clp_s/ZstdDecompressor.hpp"
+
+using clp_s::ColumnStatistics;
+using clp_s::EvaluatedValue;
+using clp_s::search::FilterOperation;
+
+namespace {
+constexpr FilterOperation cComparisonOperations[]{
+        FilterOperation::EQ,
+        FilterOperation::NEQ,
+        FilterOperation::LT,
+        FilterOperation::GT,
+        FilterOperation::LTE,
+        FilterOperation::GTE
+};
+
+/**
+ * @tparam T
+ * @param op
+ * @param value
+ * @param operand
+ * @return Whether `value op operand` holds
+ */
+template <typename T>
+bool satisfies(FilterOperation op, T value, T operand);
+
+/**
+ * Writes the given statistics and reads them back
+ * @param statistics
+ * @return the statistics that were read
+ */
+ColumnStatistics round_trip(ColumnStatistics const& statistics);
+
+template <typename T>
+bool satisfies(FilterOperation op, T value, T operand) {
+    switch (op) {
+        case FilterOperation::EQ:
+            return value == operand;
+        case FilterOperation::NEQ:
+            return value != operand;
+        case FilterOperation::LT:
+            return value < operand;
+        case FilterOperation::GT:
+            return value > operand;
+        case FilterOperation::LTE:
+            return value <= operand;
+        case FilterOperation::GTE:
+            return value >= operand;
+        default:
+            return false;
+    }
+}
+
+ColumnStatistics round_trip(ColumnStatistics const& statistics) {
+    std::vector<char> compressed;
+    clp_s::ZstdCompressor compressor;
+    compressor.open(compressed);
+    statistics.write(compressor);
+    compressor.close();
+
+    clp_s::ZstdDecompressor decompressor;
+    decompressor.open(compressed.data(), compressed.size());
+    auto read_statistics = ColumnStatistics::read(decompressor);
+    decompressor.close();
+    return read_statistics;
+}
+}  // namespace
+
+TEST_CASE("Test evaluating filters against integer ranges", "[clp_s][ColumnStatistics]") {
+    // Every range and operand in a small domain is checked against the values in the range, so the
+    // result must be True exactly when every value matches and False exactly when none do
+    for (int64_t min = -3; min <= 3; ++min) {
+        for (int64_t max = min; max <= 3; ++max) {
+            ColumnStatistics const statistics{0, min, max};
+            for (int64_t operand = -4; operand <= 4; ++operand) {
+                for (auto op : cComparisonOperations) {
+                    size_t num_matched{0};
+                    for (auto value = min; value <= max; ++value) {
+                        num_matched += satisfies(op, value, operand) ? 1 : 0;
+                    }
+                    auto const num_values = static_cast<size_t>(max - min + 1);
+                    auto expected = EvaluatedValue::Unknown;
+                    if (num_values == num_matched) {
+                        expected = EvaluatedValue::True;
+                    } else if (0 == num_matched) {
+                        expected = EvaluatedValue::False;
+                    }
+                    CAPTURE(min, max, operand, op);
+                    REQUIRE(expected == statistics.evaluate_filter(op, operand));
+                }
+            }
+        }
+    }
+
+    constexpr auto cMin = std::numeric_limits<int64_t>::min();
+    constexpr auto cMax = std::numeric_limits<int64_t>::max();
+    ColumnStatistics const full_range{0, cMin, cMax};
+    REQUIRE(EvaluatedValue::Unknown == full_range.evaluate_filter(FilterOperation::EQ, cMin));
+    REQUIRE(EvaluatedValue::False == full_range.evaluate_filter(FilterOperation::LT, cMin));
+    REQUIRE(EvaluatedValue::True == full_range.evaluate_filter(FilterOperation::LTE, cMax));
+    REQUIRE(EvaluatedValue::False == full_range.evaluate_filter(FilterOperation::GT, cMax));
+    REQUIRE(EvaluatedValue::True == full_range.evaluate_filter(FilterOperation::GTE, cMin));
+
+    // Existence can't be decided from a range
+    for (auto op : {FilterOperation::EXISTS, FilterOperation::NEXISTS}) {
+        REQUIRE(EvaluatedValue::Unknown == full_range.evaluate_filter(op, int64_t{0}));
+    }
+
+    // Statistics of other types can't decide an integer filter
+    ColumnStatistics const float_range{0, 0.0, 10.0};
+    ColumnStatistics const no_statistics{0};
+    for (auto op : cComparisonOperations) {
+        REQUIRE(EvaluatedValue::Unknown == float_range.evaluate_filter(op, int64_t{100}));
+        REQUIRE(EvaluatedValue::Unknown == no_statistics.evaluate_filter(op, int64_t{100}));
+    }
+}
+
+TEST_CASE("Test evaluating filters against float ranges", "[clp_s][ColumnStatistics]") {
+    constexpr auto cInfinity = std::numeric_limits<double>::infinity();
+    constexpr auto cNaN = std::numeric_limits<double>::quiet_NaN();
+
+    // A range's endpoints are values in the range, so they bound the possible results
+    std::vector<std::pair<double, double>> const ranges{
+            {-1.5, -1.5},
+            {-1.5, 2.5},
+            {0.0, 0.0},
+            {-cInfinity, cInfinity},
+            {1e-300, 1e300}
+    };
+    std::vector<double> const operands{-cInfinity, -2.0, -1.5, -0.0, 0.0, 1.0, 2.5, 3.0, cInfinity};
+    for (auto const& [min, max] : ranges) {
+        ColumnStatistics const statistics{0, min, max};
+        for (auto operand : operands) {
+            for (auto op : cComparisonOperations) {
+                auto const min_matches = satisfies(op, min, operand);
+                auto const max_matches = satisfies(op, max, operand);
+                auto const result = statistics.evaluate_filter(op, operand);
+                CAPTURE(min, max, operand, op);
+                if (min_matches || max_matches) {
+                    REQUIRE(EvaluatedValue::False != result);
+                }
+                if (false == min_matches || false == max_matches) {
+                    REQUIRE(EvaluatedValue::True != result);
+                }
+                if (min == max) {
+                    REQUIRE((min_matches ? EvaluatedValue::True : EvaluatedValue::False)
+                            == result);
+                }
+            }
+        }
+    }
+
+    ColumnStatistics const statistics{0, -1.5, 2.5};
+    REQUIRE(EvaluatedValue::False == statistics.evaluate_filter(FilterOperation::EQ, 3.0));
+    REQUIRE(EvaluatedValue::Unknown == statistics.evaluate_filter(FilterOperation::EQ, 0.5));
+    REQUIRE(EvaluatedValue::True == statistics.evaluate_filter(FilterOperation::NEQ, -2.0));
+    REQUIRE(EvaluatedValue::True == statistics.evaluate_filter(FilterOperation::LT, 2.75));
+    REQUIRE(EvaluatedValue::False == statistics.evaluate_filter(FilterOperation::LT, -1.5));
+    REQUIRE(EvaluatedValue::True == statistics.evaluate_filter(FilterOperation::GTE, -1.5));
+    REQUIRE(EvaluatedValue::False == statistics.evaluate_filter(FilterOperation::GT, 2.5));
+    REQUIRE(EvaluatedValue::Unknown == statistics.evaluate_filter(FilterOperation::LTE, 0.0));
+
+    // No range can decide a comparison with NaN
+    for (auto op : cComparisonOperations) {
+        REQUIRE(EvaluatedValue::Unknown == statistics.evaluate_filter(op, cNaN));
+    }
+
+    // Statistics of other types can't decide a float filter
+    ColumnStatistics const integer_range{0, int64_t{0}, int64_t{10}};
+    ColumnStatistics const no_statistics{0};
+    for (auto op : cComparisonOperations) {
+        REQUIRE(EvaluatedValue::Unknown == integer_range.evaluate_filter(op, 100.0));
+        REQUIRE(EvaluatedValue::Unknown == no_statistics.evaluate_filter(op, 100.0));
+    }
+}
+
+TEST_CASE("Test evaluating filters against dictionary ids", "[clp_s][ColumnStatistics]") {
+    ColumnStatistics const statistics{0, std::vector<uint64_t>{1, 3, 5}};
+
+    std::unordered_set<int64_t> const no_ids{2, 4};
+    REQUIRE(EvaluatedValue::False == statistics.evaluate_filter(FilterOperation::EQ, no_ids));
+    REQUIRE(EvaluatedValue::True == statistics.evaluate_filter(FilterOperation::NEQ, no_ids));
+
+    std::unordered_set<int64_t> const some_ids{3, 4};
+    REQUIRE(EvaluatedValue::Unknown == statistics.evaluate_filter(FilterOperation::EQ, some_ids));
+    REQUIRE(EvaluatedValue::Unknown == statistics.evaluate_filter(FilterOperation::NEQ, some_ids));
+
+    std::unordered_set<int64_t> const all_ids{1, 3, 5, 7};
+    REQUIRE(EvaluatedValue::True == statistics.evaluate_filter(FilterOperation::EQ, all_ids));
+    REQUIRE(EvaluatedValue::False == statistics.evaluate_filter(FilterOperation::NEQ, all_ids));
+
+    // Only equality can be decided from the set of ids
+    for (auto op :
+         {FilterOperation::EXISTS,
+          FilterOperation::NEXISTS,
+          FilterOperation::LT,
+          FilterOperation::GT,
+          FilterOperation::LTE,
+          FilterOperation::GTE})
+    {
+        REQUIRE(EvaluatedValue::Unknown == statistics.evaluate_filter(op, no_ids));
+    }
+
+    // Columns with too many ids to record don't have any
+    ColumnStatistics const no_statistics{0};
+    for (auto op : {FilterOperation::EQ, FilterOperation::NEQ}) {
+        REQUIRE(EvaluatedValue::Unknown == no_statistics.evaluate_filter(op, no_ids));
+    }
+}
+
+TEST_CASE("Test merging column statistics", "[clp_s][ColumnStatistics]") {
+    ColumnStatistics integer_range{0, int64_t{-5}, int64_t{5}};
+    integer_range.merge({0, int64_t{0}, int64_t{10}});
+    REQUIRE(ColumnStatistics::Type::IntegerRange == integer_range.get_type());
+    REQUIRE(-5 == integer_range.get_int_min());
+    REQUIRE(10 == integer_range.get_int_max());
+
+    ColumnStatistics float_range{0, 1.0, 2.0};
+    float_range.merge({0, -1.0, 1.5});
+    REQUIRE(ColumnStatistics::Type::FloatRange == float_range.get_type());
+    REQUIRE(-1.0 == float_range.get_float_min());
+    REQUIRE(2.0 == float_range.get_float_max());
+
+    ColumnStatistics dictionary_ids{0, std::vector<uint64_t>{1, 3, 5}};
+    dictionary_ids.merge({0, std::vector<uint64_t>{2, 3, 6}});
+    REQUIRE(ColumnStatistics::Type::DictionaryIds == dictionary_ids.get_type());
+    REQUIRE(std::vector<uint64_t>{1, 2, 3, 5, 6} == dictionary_ids.get_dictionary_ids());
+
+    // Statistics of different types can't describe the merged values
+    integer_range.merge(float_range);
+    REQUIRE(ColumnStatistics::Type::None == integer_range.get_type());
+    REQUIRE(EvaluatedValue::Unknown
+            == integer_range.evaluate_filter(FilterOperation::EQ, int64_t{100}));
+    dictionary_ids.merge(ColumnStatistics{0});
+    REQUIRE(ColumnStatistics::Type::None == dictionary_ids.get_type());
+    REQUIRE(dictionary_ids.get_dictionary_ids().empty());
+}
+
+TEST_CASE("Test writing and reading column statistics", "[clp_s][ColumnStatistics]") {
+    constexpr auto cMin = std::numeric_limits<int64_t>::min();
+    constexpr auto cMax = std::numeric_limits<int64_t>::max();
+
+    auto none = round_trip(ColumnStatistics{7});
+    REQUIRE(7 == none.get_column_id());
+    REQUIRE(ColumnStatistics::Type::None == none.get_type());
+
+    auto integer_range = round_trip({8, cMin, cMax});
+    REQUIRE(8 == integer_range.get_column_id());
+    REQUIRE(ColumnStatistics::Type::IntegerRange == integer_range.get_type());
+    REQUIRE(cMin == integer_range.get_int_min());
+    REQUIRE(cMax == integer_range.get_int_max());
+
+    auto float_range = round_trip({9, -std::numeric_limits<double>::infinity(), 1e-300});
+    REQUIRE(9 == float_range.get_column_id());
+    REQUIRE(ColumnStatistics::Type::FloatRange == float_range.get_type());
+    REQUIRE(-std::numeric_limits<double>::infinity() == float_range.get_float_min());
+    REQUIRE(1e-300 == float_range.get_float_max());
+
+    std::vector<uint64_t> const ids = GENERATE(
+            std::vector<uint64_t>{},
+            std::vector<uint64_t>{0},
+            std::vector<uint64_t>{1, 2, std::numeric_limits<uint64_t>::max()}
+    );
+    auto dictionary_ids = round_trip({10, ids});
+    REQUIRE(10 == dictionary_ids.get_column_id());
+    REQUIRE(ColumnStatistics::Type::DictionaryIds == dictionary_ids.get_type());
+    REQUIRE(ids == dictionary_ids.get_dictionary_ids());
+}
+
+TEST_CASE("Test reading corrupt column statistics", "[clp_s][ColumnStatistics]") {
+    std::vector<char> compressed;
+    clp_s::ZstdCompressor compressor;
+    compressor.open(compressed);
+
+    SECTION("Unknown type") {
+        compressor.write_numeric_value(int32_t{0});
+        compressor.write_numeric_value(uint8_t{0xFF});
+    }
+    SECTION("Truncated range") {
+        compressor.write_numeric_value(int32_t{0});
+        compressor.write_numeric_value(ColumnStatistics::Type::IntegerRange);
+        compressor.write_numeric_value(int64_t{0});
+    }
+    SECTION("Truncated dictionary ids") {
+        compressor.write_numeric_value(int32_t{0});
+        compressor.write_numeric_value(ColumnStatistics::Type::DictionaryIds);
+        compressor.write_numeric_value(uint64_t{2});
+        compressor.write_numeric_value(uint64_t{1});
+    }
+    compressor.close();
+
+    clp_s::ZstdDecompressor decompressor;
+    decompressor.open(compressed.data(), compressed.size());
+    REQUIRE_THROWS_AS(ColumnStatistics::read(decompressor), ColumnStatistics::OperationFailed);
+    decompressor.close();
+}
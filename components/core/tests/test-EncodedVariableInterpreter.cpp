@@ -1,6 +1,9 @@
 #include <unistd.h>
 
+#include <unordered_set>
+
 #include <Catch2/single_include/catch2/catch.hpp>
+#include <string_utils/WildcardPattern.hpp>
 
 #include "../src/clp/EncodedVariableInterpreter.hpp"
 #include "../src/clp/ir/types.hpp"
@@ -11,8 +14,10 @@ using clp::encoded_variable_t;
 using clp::EncodedVariableInterpreter;
 using clp::enum_to_underlying_type;
 using clp::ir::VariablePlaceholder;
+using clp::string_utils::WildcardPattern;
 using std::string;
 using std::to_string;
+using std::unordered_set;
 using std::vector;
 
 TEST_CASE("EncodedVariableInterpreter", "[EncodedVariableInterpreter]") {
@@ -513,6 +518,55 @@ TEST_CASE("EncodedVariableInterpreter", "[EncodedVariableInterpreter]") {
 
         REQUIRE(logtype_dict_entry.get_value() == search_logtype);
 
+        // Test case-insensitive dictionary lookups
+        REQUIRE(nullptr == var_dict_reader.get_entry_matching_value("PYTHON2.7.3", false));
+        auto const* var_dict_entry = var_dict_reader.get_entry_matching_value("PYTHON2.7.3", true);
+        REQUIRE(nullptr != var_dict_entry);
+        REQUIRE(var_dict_entry->get_value() == var_strs[4]);
+        REQUIRE(var_dict_entry == var_dict_reader.get_entry_matching_value(var_strs[4], false));
+
+        // Test searching for several wildcard variables in one pass over the dictionary
+        vector<WildcardPattern> const patterns{
+                WildcardPattern{"*python*", true},
+                WildcardPattern{"*PYTHON*", true},
+                WildcardPattern{"*PYTHON*", false},
+                WildcardPattern{"python?.7.*", false},
+                WildcardPattern{"abc*", false}
+        };
+        vector<unordered_set<clp::VariableDictionaryEntry const*>> matching_entries;
+        var_dict_reader.get_entries_matching_wildcard_patterns(patterns, matching_entries);
+        REQUIRE(patterns.size() == matching_entries.size());
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            unordered_set<clp::VariableDictionaryEntry const*> expected_entries;
+            var_dict_reader.get_entries_matching_wildcard_string(
+                    patterns[i].get_wildcard_string(),
+                    false == patterns[i].is_case_sensitive_match(),
+                    expected_entries
+            );
+            REQUIRE(expected_entries == matching_entries[i]);
+        }
+        REQUIRE(unordered_set<clp::VariableDictionaryEntry const*>{var_dict_entry}
+                == matching_entries[0]);
+        REQUIRE(matching_entries[1].empty());
+        REQUIRE(matching_entries[0] == matching_entries[2]);
+        REQUIRE(matching_entries[0] == matching_entries[3]);
+        REQUIRE(matching_entries[4].empty());
+
+        clp::SubQuery wildcard_sub_query;
+        REQUIRE(EncodedVariableInterpreter::add_wildcard_dictionary_matches(
+                matching_entries[2],
+                wildcard_sub_query
+        ));
+        REQUIRE(false
+                == EncodedVariableInterpreter::add_wildcard_dictionary_matches(
+                        matching_entries[4],
+                        wildcard_sub_query
+                ));
+        REQUIRE(1 == wildcard_sub_query.get_vars().size());
+        REQUIRE(wildcard_sub_query.get_vars().front().matches(
+                EncodedVariableInterpreter::encode_var_dict_id(var_dict_entry->get_id())
+        ));
+
         // Test decoding
         string decompressed_msg;
         REQUIRE(EncodedVariableInterpreter::decode_variables_into_message(
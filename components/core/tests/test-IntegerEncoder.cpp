@@ -0,0 +1,297 @@
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <Catch2/single_include/catch2/catch.hpp>
+
+#include "../src/clp_s/BufferViewReader.hpp"
+#include "../src/clp_s/IntegerEncoder.hpp"
+#include "../src/clp_s/TraceableException.hpp"
+#include "../src/clp_s/ZstdCompressor.hpp"
+#include "../src/clp_s/ZstdDecompressor.hpp"
+
+using clp_s::IntegerEncoder;
+using Encoding = clp_s::IntegerEncoder::Encoding;
+
+namespace {
+/**
+ * Encodes the given values and returns the encoded bytes
+ * @param values
+ * @return the encoded bytes
+ */
+std::vector<char> encode(std::vector<int64_t> const& values);
+
+/**
+ * Decodes `num_values` values from the given encoded bytes
+ * @tparam T
+ * @param encoded
+ * @param num_values
+ * @return the decoded values
+ */
+template <typename T>
+std::vector<T> decode(std::vector<char>& encoded, size_t num_values);
+
+/**
+ * Appends the raw bytes of a value to the given buffer
+ * @tparam T
+ * @param buffer
+ * @param value
+ */
+template <typename T>
+void append_value(std::vector<char>& buffer, T value);
+
+std::vector<char> encode(std::vector<int64_t> const& values) {
+    std::vector<char> compressed;
+    clp_s::ZstdCompressor compressor;
+    compressor.open(compressed);
+    auto const encoded_size = IntegerEncoder::encode(values, compressor);
+    compressor.close();
+
+    std::vector<char> encoded(encoded_size);
+    clp_s::ZstdDecompressor decompressor;
+    decompressor.open(compressed.data(), compressed.size());
+    REQUIRE(clp_s::ErrorCodeSuccess
+            == decompressor.try_read_exact_length(encoded.data(), encoded.size()));
+    decompressor.close();
+    return encoded;
+}
+
+template <typename T>
+std::vector<T> decode(std::vector<char>& encoded, size_t num_values) {
+    clp_s::BufferViewReader reader{encoded.data(), encoded.size()};
+    std::vector<int64_t> decoded_values;
+    auto decoded = IntegerEncoder::decode<T>(reader, num_values, decoded_values);
+    REQUIRE(0 == reader.get_remaining_size());
+
+    std::vector<T> values;
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        values.push_back(decoded[i]);
+    }
+    return values;
+}
+
+template <typename T>
+void append_value(std::vector<char>& buffer, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+}  // namespace
+
+TEST_CASE("Test round trip of each integer encoding", "[clp_s][IntegerEncoder]") {
+    std::mt19937_64 generator{42};
+    std::vector<int64_t> values;
+    Encoding expected_encoding{Encoding::Raw};
+
+    SECTION("Raw") {
+        for (size_t i = 0; i < 1000; ++i) {
+            values.push_back(static_cast<int64_t>(generator()));
+        }
+        expected_encoding = Encoding::Raw;
+    }
+    SECTION("FrameOfReference") {
+        for (size_t i = 0; i < 1000; ++i) {
+            values.push_back(1'000'000'000'000 + static_cast<int64_t>(generator() % 1000));
+        }
+        expected_encoding = Encoding::FrameOfReference;
+    }
+    SECTION("Delta") {
+        for (int64_t i = 0; i < 1000; ++i) {
+            values.push_back(1'700'000'000'000 + i * 1000 + static_cast<int64_t>(generator() % 10));
+        }
+        expected_encoding = Encoding::Delta;
+    }
+    SECTION("RunLength") {
+        for (int64_t run_value : {-5'000'000'000'000'000'000, 5'000'000'000'000'000'000, 0L, 7L}) {
+            values.insert(values.end(), 250, run_value);
+        }
+        expected_encoding = Encoding::RunLength;
+    }
+    SECTION("Dictionary") {
+        constexpr int64_t cDistinctValues[]{
+                std::numeric_limits<int64_t>::min(),
+                std::numeric_limits<int64_t>::max(),
+                -1,
+                1
+        };
+        for (size_t i = 0; i < 1000; ++i) {
+            values.push_back(cDistinctValues[generator() % 4]);
+        }
+        expected_encoding = Encoding::Dictionary;
+    }
+
+    auto encoded = encode(values);
+    REQUIRE(static_cast<char>(expected_encoding) == encoded[0]);
+    REQUIRE(decode<int64_t>(encoded, values.size()) == values);
+}
+
+TEST_CASE("Test round trip of edge case integer columns", "[clp_s][IntegerEncoder]") {
+    constexpr auto cMin = std::numeric_limits<int64_t>::min();
+    constexpr auto cMax = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> values;
+
+    SECTION("Empty") {
+        auto encoded = encode(values);
+        REQUIRE(1 == encoded.size());
+        REQUIRE(decode<int64_t>(encoded, 0).empty());
+    }
+    SECTION("Single value") {
+        values = GENERATE(
+                std::vector<int64_t>{0},
+                std::vector<int64_t>{cMin},
+                std::vector<int64_t>{cMax}
+        );
+        auto encoded = encode(values);
+        REQUIRE(decode<int64_t>(encoded, values.size()) == values);
+    }
+    SECTION("Extreme values") {
+        values = GENERATE(
+                std::vector<int64_t>{cMin, cMax},
+                std::vector<int64_t>{cMax, cMin, cMax, cMin},
+                std::vector<int64_t>{cMin, cMin, cMin, cMax, cMax, cMax},
+                std::vector<int64_t>{cMin, 0, cMax, 0, cMin, 1, cMax, -1}
+        );
+        auto encoded = encode(values);
+        REQUIRE(decode<int64_t>(encoded, values.size()) == values);
+    }
+    SECTION("Values whose differences span all 64 bits") {
+        std::mt19937_64 generator{7};
+        for (size_t i = 0; i < 1000; ++i) {
+            values.push_back(0 == i % 2 ? cMin + static_cast<int64_t>(generator() % 16) : cMax);
+        }
+        auto encoded = encode(values);
+        REQUIRE(decode<int64_t>(encoded, values.size()) == values);
+    }
+}
+
+TEST_CASE("Test decoding 64-bit wide bit-packed integers", "[clp_s][IntegerEncoder]") {
+    constexpr auto cMin = std::numeric_limits<int64_t>::min();
+    constexpr auto cMax = std::numeric_limits<int64_t>::max();
+    constexpr uint8_t cBitWidth = 64;
+
+    // The encoder never chooses a bit width this wide since raw values are smaller, but the decoder
+    // must still handle it
+    SECTION("FrameOfReference") {
+        std::vector<int64_t> const values{cMin, cMax, 0, cMin};
+        std::vector<char> encoded;
+        append_value(encoded, Encoding::FrameOfReference);
+        append_value(encoded, cMin);
+        append_value(encoded, cBitWidth);
+        for (auto value : values) {
+            append_value(encoded, static_cast<uint64_t>(value) - static_cast<uint64_t>(cMin));
+        }
+        REQUIRE(decode<int64_t>(encoded, values.size()) == values);
+    }
+    SECTION("Delta") {
+        std::vector<int64_t> const values{cMin, cMax, cMin, 0, cMax};
+        int64_t const min_delta = cMin;
+        std::vector<char> encoded;
+        append_value(encoded, Encoding::Delta);
+        append_value(encoded, values[0]);
+        append_value(encoded, min_delta);
+        append_value(encoded, cBitWidth);
+        for (size_t i = 1; i < values.size(); ++i) {
+            append_value(
+                    encoded,
+                    static_cast<uint64_t>(values[i]) - static_cast<uint64_t>(values[i - 1])
+                            - static_cast<uint64_t>(min_delta)
+            );
+        }
+        REQUIRE(decode<int64_t>(encoded, values.size()) == values);
+    }
+}
+
+TEST_CASE("Test round trip of doubles encoded as integers", "[clp_s][IntegerEncoder]") {
+    std::vector<double> doubles = GENERATE(
+            std::vector<double>{0.0, -0.0, 1.5, -1.5, 1e300, -1e-300},
+            std::vector<double>{
+                    std::numeric_limits<double>::infinity(),
+                    -std::numeric_limits<double>::infinity(),
+                    std::numeric_limits<double>::max(),
+                    std::numeric_limits<double>::lowest(),
+                    std::numeric_limits<double>::denorm_min()
+            },
+            std::vector<double>(500, 3.25)
+    );
+    std::vector<int64_t> bit_patterns;
+    for (auto value : doubles) {
+        bit_patterns.push_back(std::bit_cast<int64_t>(value));
+    }
+
+    auto encoded = encode(bit_patterns);
+    auto decoded = decode<double>(encoded, doubles.size());
+    REQUIRE(decoded.size() == doubles.size());
+    for (size_t i = 0; i < doubles.size(); ++i) {
+        REQUIRE(std::bit_cast<int64_t>(decoded[i]) == bit_patterns[i]);
+    }
+}
+
+TEST_CASE("Test decoding corrupt integer columns", "[clp_s][IntegerEncoder]") {
+    std::vector<int64_t> decoded_values;
+
+    SECTION("Truncated column") {
+        std::vector<int64_t> values = GENERATE(
+                std::vector<int64_t>(100, 1),
+                std::vector<int64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
+                std::vector<int64_t>{-9'000'000'000'000'000'000, 9'000'000'000'000'000'000}
+        );
+        auto encoded = encode(values);
+        encoded.pop_back();
+        clp_s::BufferViewReader reader{encoded.data(), encoded.size()};
+        REQUIRE_THROWS_AS(
+                IntegerEncoder::decode<int64_t>(reader, values.size(), decoded_values),
+                clp_s::TraceableException
+        );
+    }
+    SECTION("Unknown encoding") {
+        std::vector<char> encoded;
+        append_value(encoded, static_cast<uint8_t>(0xFF));
+        append_value(encoded, int64_t{0});
+        clp_s::BufferViewReader reader{encoded.data(), encoded.size()};
+        REQUIRE_THROWS_AS(
+                IntegerEncoder::decode<int64_t>(reader, 1, decoded_values),
+                IntegerEncoder::OperationFailed
+        );
+    }
+    SECTION("Bit width wider than 64 bits") {
+        std::vector<char> encoded;
+        append_value(encoded, Encoding::FrameOfReference);
+        append_value(encoded, int64_t{0});
+        append_value(encoded, static_cast<uint8_t>(65));
+        encoded.resize(encoded.size() + 2 * sizeof(uint64_t));
+        clp_s::BufferViewReader reader{encoded.data(), encoded.size()};
+        REQUIRE_THROWS_AS(
+                IntegerEncoder::decode<int64_t>(reader, 1, decoded_values),
+                IntegerEncoder::OperationFailed
+        );
+    }
+    SECTION("Runs which don't cover the column") {
+        uint64_t const run_length = GENERATE(1, 3);
+        std::vector<char> encoded;
+        append_value(encoded, Encoding::RunLength);
+        append_value(encoded, uint64_t{1});
+        append_value(encoded, int64_t{5});
+        append_value(encoded, run_length);
+        clp_s::BufferViewReader reader{encoded.data(), encoded.size()};
+        REQUIRE_THROWS_AS(
+                IntegerEncoder::decode<int64_t>(reader, 2, decoded_values),
+                IntegerEncoder::OperationFailed
+        );
+    }
+    SECTION("Dictionary index out of range") {
+        std::vector<char> encoded;
+        append_value(encoded, Encoding::Dictionary);
+        append_value(encoded, uint64_t{1});
+        append_value(encoded, int64_t{5});
+        append_value(encoded, static_cast<uint8_t>(1));
+        append_value(encoded, uint64_t{0b10});
+        clp_s::BufferViewReader reader{encoded.data(), encoded.size()};
+        REQUIRE_THROWS_AS(
+                IntegerEncoder::decode<int64_t>(reader, 2, decoded_values),
+                IntegerEncoder::OperationFailed
+        );
+    }
+}
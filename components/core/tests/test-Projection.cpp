@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <Catch2/single_include/catch2/catch.hpp>
+#include <spdlog/spdlog.h>
+
+#include "../src/clp_s/search/Projection.hpp"
+#include "../src/clp_s/SchemaTree.hpp"
+#include "LogSuppressor.hpp"
+
+using clp_s::NodeType;
+using clp_s::SchemaTree;
+using clp_s::search::Projection;
+
+namespace {
+/**
+ * @param projection
+ * @param tree
+ * @return the ids of the nodes in the tree which are projected
+ */
+std::unordered_set<int32_t>
+get_matching_nodes(Projection const& projection, std::shared_ptr<SchemaTree> const& tree);
+
+std::unordered_set<int32_t>
+get_matching_nodes(Projection const& projection, std::shared_ptr<SchemaTree> const& tree) {
+    std::unordered_set<int32_t> matching_nodes;
+    for (auto const& node : tree->get_nodes()) {
+        if (projection.matches_node(node.get_id())) {
+            matching_nodes.insert(node.get_id());
+        }
+    }
+    return matching_nodes;
+}
+}  // namespace
+
+TEST_CASE("Test resolving projected columns", "[clp_s][Projection]") {
+    // Builds the tree for the records
+    // {"a": 0, "e": "x"}
+    // {"a": {"b": "y", "c": {"d": 0.5}}, "f": {"a": 1}}
+    auto tree = std::make_shared<SchemaTree>();
+    auto const root = tree->add_node(-1, NodeType::Object, "");
+    auto const a_integer = tree->add_node(root, NodeType::Integer, "a");
+    auto const e = tree->add_node(root, NodeType::ClpString, "e");
+    auto const a_object = tree->add_node(root, NodeType::Object, "a");
+    auto const a_b = tree->add_node(a_object, NodeType::VarString, "b");
+    auto const a_c = tree->add_node(a_object, NodeType::Object, "c");
+    auto const a_c_d = tree->add_node(a_c, NodeType::Float, "d");
+    auto const f = tree->add_node(root, NodeType::Object, "f");
+    auto const f_a = tree->add_node(f, NodeType::Integer, "a");
+
+    SECTION("Missing keys") {
+        std::vector<std::string> const columns = GENERATE(
+                std::vector<std::string>{"missing"},
+                std::vector<std::string>{"e.missing"},
+                std::vector<std::string>{"a.c.d.missing"},
+                std::vector<std::string>{"b", "d"}
+        );
+        Projection projection{columns};
+        projection.resolve_columns(tree);
+        REQUIRE(get_matching_nodes(projection, tree).empty());
+    }
+
+    SECTION("Leaf keys") {
+        Projection projection{{"a.b", "e", "a.c.d"}};
+        projection.resolve_columns(tree);
+        REQUIRE(std::unordered_set<int32_t>{a_b, e, a_c_d} == get_matching_nodes(projection, tree));
+    }
+
+    SECTION("Object keys include their descendants") {
+        Projection projection{{"a.c", "f"}};
+        projection.resolve_columns(tree);
+        REQUIRE(std::unordered_set<int32_t>{a_c, a_c_d, f, f_a}
+                == get_matching_nodes(projection, tree));
+    }
+
+    SECTION("Keys shared by nodes of different types") {
+        Projection projection{{"a"}};
+        projection.resolve_columns(tree);
+        REQUIRE(std::unordered_set<int32_t>{a_integer, a_object, a_b, a_c, a_c_d}
+                == get_matching_nodes(projection, tree));
+    }
+
+    SECTION("Nested keys don't match keys at other depths") {
+        Projection projection{{"f.a"}};
+        projection.resolve_columns(tree);
+        REQUIRE(std::unordered_set<int32_t>{f_a} == get_matching_nodes(projection, tree));
+    }
+
+    SECTION("Resolving against another tree") {
+        Projection projection{{"a"}};
+        projection.resolve_columns(tree);
+
+        auto other_tree = std::make_shared<SchemaTree>();
+        auto const other_root = other_tree->add_node(-1, NodeType::Object, "");
+        other_tree->add_node(other_root, NodeType::Integer, "e");
+        auto const other_a = other_tree->add_node(other_root, NodeType::Float, "a");
+        projection.resolve_columns(other_tree);
+        REQUIRE(std::unordered_set<int32_t>{other_a}
+                == get_matching_nodes(projection, other_tree));
+
+        projection.resolve_columns(std::make_shared<SchemaTree>());
+        REQUIRE(get_matching_nodes(projection, tree).empty());
+    }
+}
+
+TEST_CASE("Test selecting invalid projected columns", "[clp_s][Projection]") {
+    std::vector<std::string> const columns = GENERATE(
+            std::vector<std::string>{""},
+            std::vector<std::string>{"a..b"},
+            std::vector<std::string>{"a."},
+            std::vector<std::string>{"a", "b", "a"}
+    );
+    LogSuppressor const suppressor{};
+    REQUIRE_THROWS_AS(Projection{columns}, Projection::OperationFailed);
+}
@@ -13,6 +13,9 @@ using std::string;
 TEST_CASE("Test writing and reading a segment", "[Segment]") {
     clp::ErrorCode error_code;
 
+    // Test both a single-frame segment and one split into many frames
+    size_t const frame_size = GENERATE(0, 1L * 1024 * 1024);
+
     // Initialize data to test compression and decompression
     size_t uncompressed_data_size = 128L * 1024 * 1024;  // 128MB
     char* uncompressed_data = new char[uncompressed_data_size];
@@ -31,7 +34,7 @@ TEST_CASE("Test writing and reading a segment", "[Segment]") {
     // Test segment writing
     clp::streaming_archive::writer::Segment writer_segment;
 
-    writer_segment.open(segments_dir_path, 0, 0);
+    writer_segment.open(segments_dir_path, 0, 0, frame_size);
     auto segment_id = writer_segment.get_id();
 
     // Fill segment
@@ -50,6 +53,19 @@ TEST_CASE("Test writing and reading a segment", "[Segment]") {
     REQUIRE(ErrorCode_Success == error_code);
     REQUIRE(memcmp(uncompressed_data, decompressed_data, uncompressed_data_size) == 0);
 
+    // Read out content spanning multiple frames, both after and before the previous read
+    size_t const region_offset = 3L * 1024 * 1024 + 17;
+    size_t const region_size = 5L * 1024 * 1024;
+    for (auto const offset : {region_offset, region_offset / 2}) {
+        error_code = reader_segment.try_read(offset, decompressed_data, region_size);
+        REQUIRE(ErrorCode_Success == error_code);
+        REQUIRE(memcmp(uncompressed_data + offset, decompressed_data, region_size) == 0);
+    }
+
+    // Reading past the end of the segment should fail
+    error_code = reader_segment.try_read(uncompressed_data_size - 1, decompressed_data, 2);
+    REQUIRE(clp::ErrorCode_Truncated == error_code);
+
     reader_segment.close();
 
     // Delete segment and directory
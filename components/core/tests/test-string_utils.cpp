@@ -4,11 +4,13 @@
 #include <boost/range/combine.hpp>
 #include <Catch2/single_include/catch2/catch.hpp>
 #include <string_utils/string_utils.hpp>
+#include <string_utils/WildcardPattern.hpp>
 
 using clp::string_utils::clean_up_wildcard_search_string;
 using clp::string_utils::convert_string_to_int;
 using clp::string_utils::wildcard_match_unsafe;
 using clp::string_utils::wildcard_match_unsafe_case_sensitive;
+using clp::string_utils::WildcardPattern;
 using std::chrono::duration;
 using std::chrono::high_resolution_clock;
 using std::cout;
@@ -514,6 +516,83 @@ SCENARIO("Test wild card performance", "[wildcard performance]") {
     }
 }
 
+TEST_CASE("WildcardPattern", "[wildcard][WildcardPattern]") {
+    vector<string> const wild_strings{
+            "",
+            "*",
+            "?",
+            "abc",
+            "ABC",
+            "abc*",
+            "*abc",
+            "*abc*",
+            "a*c",
+            "a?c",
+            "ab*cd*ef",
+            "*b?d*",
+            "ab*ba",
+            "\\*abc",
+            "ab\\?c*",
+            "*\\\\*",
+            "?*?",
+            "*longest*ab*",
+            "Job * finished in ?s"
+    };
+    vector<string> const tame_strings{
+            "",
+            "a",
+            "abc",
+            "aBc",
+            "ABC",
+            "abcabc",
+            "xabcx",
+            "abba",
+            "aba",
+            "abxxcdyyef",
+            "abcdef",
+            "xbyd",
+            "*abc",
+            "ab?cd",
+            "abxcd",
+            "a\\b",
+            "longest ab",
+            "the LONGEST abacus",
+            "Job 42 finished in 5s",
+            "Job 42 finished in 15s"
+    };
+
+    for (auto const& wild : wild_strings) {
+        WildcardPattern const case_sensitive_pattern{wild, true};
+        WildcardPattern const case_insensitive_pattern{wild, false};
+        for (auto const& tame : tame_strings) {
+            CAPTURE(wild, tame);
+            REQUIRE(case_sensitive_pattern.matches(tame)
+                    == wildcard_match_unsafe(tame, wild, true));
+            REQUIRE(case_insensitive_pattern.matches(tame)
+                    == wildcard_match_unsafe(tame, wild, false));
+        }
+    }
+
+    // Spot checks
+    REQUIRE(WildcardPattern{"*abc*", true}.matches("xabcx"));
+    REQUIRE(false == WildcardPattern{"*abc*", true}.matches("xaBcx"));
+    REQUIRE(WildcardPattern{"*ABC*", false}.matches("xaBcx"));
+    REQUIRE(WildcardPattern{"ab*ba", true}.matches("abba"));
+    REQUIRE(false == WildcardPattern{"ab*ba", true}.matches("aba"));
+    REQUIRE(WildcardPattern{"\\*abc", true}.matches("*abc"));
+    REQUIRE(false == WildcardPattern{"\\*abc", true}.matches("xabc"));
+    WildcardPattern const job_pattern{"Job * finished in ?s", true};
+    REQUIRE(job_pattern.matches("Job 42 finished in 5s"));
+    REQUIRE(false == job_pattern.matches("Job 42 finished in 15s"));
+
+    // Strings which the caller already case-folded
+    WildcardPattern const case_insensitive_job_pattern{"JOB * finished in ?S", false};
+    REQUIRE(case_insensitive_job_pattern.matches("job 42 FINISHED in 5s"));
+    REQUIRE(case_insensitive_job_pattern.matches_case_folded("job 42 finished in 5s"));
+    REQUIRE(false == case_insensitive_job_pattern.matches_case_folded("JOB 42 finished in 5s"));
+    REQUIRE(job_pattern.matches_case_folded("Job 42 finished in 5s"));
+}
+
 TEST_CASE("convert_string_to_int", "[convert_string_to_int]") {
     int64_t raw_as_int;
     string raw;
@@ -78,6 +78,12 @@ def make_command(
         if aggregation_config.count_by_time_bucket_size is not None:
             command.append("--count-by-time")
             command.append(str(aggregation_config.count_by_time_bucket_size))
+        if StorageEngine.CLP_S == storage_engine and aggregation_config.aggregation is not None:
+            command.append(f"--{aggregation_config.aggregation}")
+            command.append(aggregation_config.aggregation_field)
+            if aggregation_config.group_by_field is not None:
+                command.append("--group-by")
+                command.append(aggregation_config.group_by_field)
 
         # fmt: off
         command.extend((
@@ -2,7 +2,7 @@ from __future__ import annotations
 
 import typing
 
-from pydantic import BaseModel, validator
+from pydantic import BaseModel, root_validator, validator
 
 
 class PathsToCompress(BaseModel):
@@ -31,12 +31,32 @@ class ClpIoConfig(BaseModel):
     output: OutputConfig
 
 
+VALID_AGGREGATIONS = ["sum", "min", "max", "avg"]
+
+
 class AggregationConfig(BaseModel):
     job_id: typing.Optional[int] = None
     reducer_host: typing.Optional[str] = None
     reducer_port: typing.Optional[int] = None
     do_count_aggregation: typing.Optional[bool] = None
     count_by_time_bucket_size: typing.Optional[int] = None  # Milliseconds
+    aggregation: typing.Optional[str] = None  # One of "sum", "min", "max", or "avg"
+    aggregation_field: typing.Optional[str] = None
+    group_by_field: typing.Optional[str] = None
+
+    @validator("aggregation")
+    def validate_aggregation(cls, field):
+        if field is not None and field not in VALID_AGGREGATIONS:
+            raise ValueError(f"aggregation must be one of {VALID_AGGREGATIONS}")
+
+        return field
+
+    @root_validator(skip_on_failure=True)
+    def validate_aggregation_field(cls, values):
+        if values.get("aggregation") is not None and values.get("aggregation_field") is None:
+            raise ValueError("aggregation_field must be set when aggregation is set")
+
+        return values
 
 
 class SearchConfig(BaseModel):
@@ -34,6 +34,7 @@ from clp_py_utils.clp_config import (
     CLPConfig,
     QUERY_JOBS_TABLE_NAME,
     QUERY_TASKS_TABLE_NAME,
+    StorageEngine,
 )
 from clp_py_utils.clp_logging import get_logger, get_logging_formatter, set_logging_level
 from clp_py_utils.core import read_yaml_config_file
@@ -365,6 +366,7 @@ def handle_pending_search_jobs(
     clp_metadata_db_conn_params: Dict[str, any],
     results_cache_uri: str,
     num_archives_to_search_per_sub_job: int,
+    storage_engine: str,
 ) -> List[asyncio.Task]:
     global active_jobs
 
@@ -382,7 +384,43 @@ def handle_pending_search_jobs(
             if job_id in active_jobs:
                 continue
 
-            search_config = SearchConfig.parse_obj(msgpack.unpackb(job["job_config"]))
+            try:
+                search_config = SearchConfig.parse_obj(msgpack.unpackb(job["job_config"]))
+            except ValidationError as err:
+                logger.error(f"Invalid config for job {job_id}: {err}")
+                set_job_or_task_status(
+                    db_conn,
+                    QUERY_JOBS_TABLE_NAME,
+                    job_id,
+                    QueryJobStatus.FAILED,
+                    QueryJobStatus.PENDING,
+                    start_time=datetime.datetime.now(),
+                    num_tasks=0,
+                    duration=0,
+                )
+                continue
+
+            if (
+                StorageEngine.CLP == storage_engine
+                and search_config.aggregation_config is not None
+                and search_config.aggregation_config.aggregation is not None
+            ):
+                logger.error(
+                    f"Job {job_id} requests a {search_config.aggregation_config.aggregation}"
+                    f" aggregation, which isn't supported by the {storage_engine} storage engine."
+                )
+                set_job_or_task_status(
+                    db_conn,
+                    QUERY_JOBS_TABLE_NAME,
+                    job_id,
+                    QueryJobStatus.FAILED,
+                    QueryJobStatus.PENDING,
+                    start_time=datetime.datetime.now(),
+                    num_tasks=0,
+                    duration=0,
+                )
+                continue
+
             archives_for_search = get_archives_for_search(db_conn, search_config)
             if len(archives_for_search) == 0:
                 if set_job_or_task_status(
@@ -612,6 +650,7 @@ async def handle_jobs(
     results_cache_uri: str,
     jobs_poll_delay: float,
     num_archives_to_search_per_sub_job: int,
+    storage_engine: str,
 ) -> None:
     handle_updating_task = asyncio.create_task(
         handle_job_updates(db_conn_pool, results_cache_uri, jobs_poll_delay)
@@ -624,6 +663,7 @@ async def handle_jobs(
             clp_metadata_db_conn_params,
             results_cache_uri,
             num_archives_to_search_per_sub_job,
+            storage_engine,
         )
         if 0 == len(reducer_acquisition_tasks):
             tasks.append(asyncio.create_task(asyncio.sleep(jobs_poll_delay)))
@@ -708,6 +748,7 @@ async def main(argv: List[str]) -> int:
                 results_cache_uri=clp_config.results_cache.get_uri(),
                 jobs_poll_delay=clp_config.query_scheduler.jobs_poll_delay,
                 num_archives_to_search_per_sub_job=batch_size,
+                storage_engine=clp_config.package.storage_engine,
             )
         )
         reducer_handler = asyncio.create_task(reducer_handler.serve_forever())
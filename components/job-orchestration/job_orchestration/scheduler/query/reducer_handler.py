@@ -155,6 +155,7 @@ async def handle_reducer_connection(
                         {
                             "job_id": job_id,
                             "count_by_time_bucket_size": time_bucket_size,
+                            "aggregation": aggregation_config.aggregation,
                         }
                     ),
                     writer,